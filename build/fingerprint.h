@@ -0,0 +1,3 @@
+/* generated by tools/gen_fingerprint.c from the compiler sources */
+
+#define CODEGEN_FINGERPRINT 0x09a56a51fe51bc3aULL
@@ -0,0 +1,1092 @@
+/* generated by tools/gen_keywords.c from src/keywords.def */
+
+typedef struct {
+    unsigned short first_edge;
+    unsigned char edge_count;
+    TokenType accept;
+} KeywordState;
+
+static const unsigned short keyword_root[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 937, 938, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+    0, 0, 930, 1, 852, 415, 210, 777, 0, 515, 0, 0, 0, 0, 0, 0, 
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const KeywordState keyword_states[939] = {
+    {0, 0, TOK_ERROR},
+    {0, 4, TOK_ERROR},
+    {4, 9, TOK_ERROR},
+    {13, 1, TOK_ERROR},
+    {14, 1, TOK_ERROR},
+    {15, 1, TOK_ERROR},
+    {16, 1, TOK_ERROR},
+    {17, 1, TOK_ERROR},
+    {18, 1, TOK_ERROR},
+    {19, 1, TOK_ERROR},
+    {20, 1, TOK_ERROR},
+    {21, 1, TOK_ERROR},
+    {22, 1, TOK_ERROR},
+    {23, 1, TOK_ERROR},
+    {24, 1, TOK_ERROR},
+    {25, 1, TOK_ERROR},
+    {26, 1, TOK_ERROR},
+    {27, 1, TOK_ERROR},
+    {28, 1, TOK_ERROR},
+    {29, 1, TOK_ERROR},
+    {30, 1, TOK_ERROR},
+    {31, 1, TOK_ERROR},
+    {32, 1, TOK_ERROR},
+    {33, 1, TOK_ERROR},
+    {34, 1, TOK_ERROR},
+    {35, 1, TOK_ERROR},
+    {36, 1, TOK_ERROR},
+    {37, 1, TOK_ERROR},
+    {38, 1, TOK_ERROR},
+    {39, 1, TOK_ERROR},
+    {40, 1, TOK_ERROR},
+    {41, 1, TOK_ERROR},
+    {42, 1, TOK_ERROR},
+    {43, 1, TOK_ERROR},
+    {44, 1, TOK_ERROR},
+    {45, 1, TOK_ERROR},
+    {46, 1, TOK_ERROR},
+    {47, 0, TOK_MADE_KANKEI},
+    {47, 2, TOK_NO},
+    {49, 1, TOK_ERROR},
+    {50, 1, TOK_ERROR},
+    {51, 1, TOK_ERROR},
+    {52, 1, TOK_ERROR},
+    {53, 1, TOK_ERROR},
+    {54, 1, TOK_ERROR},
+    {55, 1, TOK_ERROR},
+    {56, 1, TOK_ERROR},
+    {57, 1, TOK_ERROR},
+    {58, 1, TOK_ERROR},
+    {59, 1, TOK_ERROR},
+    {60, 1, TOK_ERROR},
+    {61, 1, TOK_ERROR},
+    {62, 1, TOK_ERROR},
+    {63, 1, TOK_ERROR},
+    {64, 1, TOK_ERROR},
+    {65, 1, TOK_ERROR},
+    {66, 1, TOK_ERROR},
+    {67, 1, TOK_ERROR},
+    {68, 1, TOK_ERROR},
+    {69, 1, TOK_ERROR},
+    {70, 1, TOK_ERROR},
+    {71, 1, TOK_ERROR},
+    {72, 1, TOK_ERROR},
+    {73, 1, TOK_ERROR},
+    {74, 1, TOK_ERROR},
+    {75, 1, TOK_ERROR},
+    {76, 1, TOK_ERROR},
+    {77, 1, TOK_ERROR},
+    {78, 1, TOK_ERROR},
+    {79, 1, TOK_ERROR},
+    {80, 1, TOK_ERROR},
+    {81, 1, TOK_ERROR},
+    {82, 0, TOK_NO_MEMBER},
+    {82, 11, TOK_ERROR},
+    {93, 1, TOK_ERROR},
+    {94, 2, TOK_ERROR},
+    {96, 2, TOK_ERROR},
+    {98, 1, TOK_ERROR},
+    {99, 1, TOK_ERROR},
+    {100, 1, TOK_ERROR},
+    {101, 1, TOK_CHAN},
+    {102, 1, TOK_ERROR},
+    {103, 4, TOK_ERROR},
+    {107, 1, TOK_ERROR},
+    {108, 1, TOK_ERROR},
+    {109, 1, TOK_ERROR},
+    {110, 1, TOK_ERROR},
+    {111, 1, TOK_ERROR},
+    {112, 1, TOK_ERROR},
+    {113, 1, TOK_ERROR},
+    {114, 1, TOK_ERROR},
+    {115, 1, TOK_ERROR},
+    {116, 1, TOK_ERROR},
+    {117, 1, TOK_ERROR},
+    {118, 1, TOK_ERROR},
+    {119, 1, TOK_ERROR},
+    {120, 1, TOK_ERROR},
+    {121, 1, TOK_ERROR},
+    {122, 1, TOK_ERROR},
+    {123, 1, TOK_ERROR},
+    {124, 1, TOK_ERROR},
+    {125, 1, TOK_ERROR},
+    {126, 1, TOK_ERROR},
+    {127, 1, TOK_ERROR},
+    {128, 1, TOK_ERROR},
+    {129, 1, TOK_ERROR},
+    {130, 1, TOK_ERROR},
+    {131, 1, TOK_ERROR},
+    {132, 0, TOK_YARIKATA},
+    {132, 11, TOK_ERROR},
+    {143, 1, TOK_ERROR},
+    {144, 1, TOK_ERROR},
+    {145, 1, TOK_ERROR},
+    {146, 1, TOK_ERROR},
+    {147, 2, TOK_ERROR},
+    {149, 1, TOK_ERROR},
+    {150, 1, TOK_ERROR},
+    {151, 1, TOK_ERROR},
+    {152, 1, TOK_ERROR},
+    {153, 1, TOK_ERROR},
+    {154, 1, TOK_ERROR},
+    {155, 1, TOK_ERROR},
+    {156, 2, TOK_ERROR},
+    {158, 1, TOK_ERROR},
+    {159, 1, TOK_ERROR},
+    {160, 1, TOK_ERROR},
+    {161, 1, TOK_ERROR},
+    {162, 1, TOK_ERROR},
+    {163, 1, TOK_ERROR},
+    {164, 1, TOK_ERROR},
+    {165, 1, TOK_ERROR},
+    {166, 1, TOK_ERROR},
+    {167, 1, TOK_ERROR},
+    {168, 1, TOK_ERROR},
+    {169, 1, TOK_ERROR},
+    {170, 1, TOK_ERROR},
+    {171, 1, TOK_ERROR},
+    {172, 1, TOK_ERROR},
+    {173, 0, TOK_SAN_KOTO},
+    {173, 1, TOK_ERROR},
+    {174, 1, TOK_ERROR},
+    {175, 1, TOK_ERROR},
+    {176, 1, TOK_ERROR},
+    {177, 1, TOK_ERROR},
+    {178, 1, TOK_ERROR},
+    {179, 1, TOK_ERROR},
+    {180, 1, TOK_ERROR},
+    {181, 1, TOK_ERROR},
+    {182, 1, TOK_ERROR},
+    {183, 1, TOK_ERROR},
+    {184, 1, TOK_ERROR},
+    {185, 1, TOK_ERROR},
+    {186, 1, TOK_ERROR},
+    {187, 0, TOK_SAN_KOTO_OSHIMAI},
+    {187, 1, TOK_CHAN_NI},
+    {188, 1, TOK_ERROR},
+    {189, 1, TOK_ERROR},
+    {190, 1, TOK_ERROR},
+    {191, 1, TOK_ERROR},
+    {192, 1, TOK_ERROR},
+    {193, 1, TOK_ERROR},
+    {194, 1, TOK_ERROR},
+    {195, 1, TOK_ERROR},
+    {196, 1, TOK_ERROR},
+    {197, 1, TOK_ERROR},
+    {198, 1, TOK_ERROR},
+    {199, 1, TOK_ERROR},
+    {200, 1, TOK_ERROR},
+    {201, 1, TOK_ERROR},
+    {202, 1, TOK_ERROR},
+    {203, 0, TOK_ONEGAI},
+    {203, 1, TOK_ERROR},
+    {204, 1, TOK_ERROR},
+    {205, 1, TOK_ERROR},
+    {206, 1, TOK_ERROR},
+    {207, 1, TOK_ERROR},
+    {208, 1, TOK_ERROR},
+    {209, 2, TOK_ERROR},
+    {211, 1, TOK_ERROR},
+    {212, 1, TOK_ERROR},
+    {213, 1, TOK_ERROR},
+    {214, 1, TOK_ERROR},
+    {215, 1, TOK_ERROR},
+    {216, 1, TOK_ERROR},
+    {217, 1, TOK_ERROR},
+    {218, 1, TOK_ERROR},
+    {219, 1, TOK_ERROR},
+    {220, 1, TOK_ERROR},
+    {221, 1, TOK_ERROR},
+    {222, 1, TOK_ERROR},
+    {223, 1, TOK_ERROR},
+    {224, 1, TOK_ERROR},
+    {225, 1, TOK_ERROR},
+    {226, 0, TOK_OSHIETE_YO},
+    {226, 1, TOK_ERROR},
+    {227, 1, TOK_ERROR},
+    {228, 1, TOK_ERROR},
+    {229, 1, TOK_ERROR},
+    {230, 1, TOK_ERROR},
+    {231, 1, TOK_ERROR},
+    {232, 1, TOK_ERROR},
+    {233, 1, TOK_ERROR},
+    {234, 1, TOK_ERROR},
+    {235, 1, TOK_ERROR},
+    {236, 1, TOK_ERROR},
+    {237, 1, TOK_ERROR},
+    {238, 1, TOK_ERROR},
+    {239, 1, TOK_ERROR},
+    {240, 1, TOK_ERROR},
+    {241, 0, TOK_CHOTTO_KIITE},
+    {241, 4, TOK_ERROR},
+    {245, 1, TOK_ERROR},
+    {246, 1, TOK_ERROR},
+    {247, 1, TOK_ERROR},
+    {248, 1, TOK_ERROR},
+    {249, 1, TOK_ERROR},
+    {250, 1, TOK_ERROR},
+    {251, 1, TOK_ERROR},
+    {252, 1, TOK_ERROR},
+    {253, 1, TOK_ERROR},
+    {254, 1, TOK_ERROR},
+    {255, 1, TOK_ERROR},
+    {256, 1, TOK_ERROR},
+    {257, 1, TOK_ERROR},
+    {258, 1, TOK_ERROR},
+    {259, 1, TOK_ERROR},
+    {260, 1, TOK_ERROR},
+    {261, 1, TOK_ERROR},
+    {262, 1, TOK_ERROR},
+    {263, 1, TOK_ERROR},
+    {264, 1, TOK_ERROR},
+    {265, 1, TOK_ERROR},
+    {266, 1, TOK_ERROR},
+    {267, 1, TOK_ERROR},
+    {268, 1, TOK_ERROR},
+    {269, 1, TOK_ERROR},
+    {270, 1, TOK_ERROR},
+    {271, 0, TOK_KININARU},
+    {271, 1, TOK_ERROR},
+    {272, 1, TOK_ERROR},
+    {273, 1, TOK_ERROR},
+    {274, 1, TOK_ERROR},
+    {275, 1, TOK_ERROR},
+    {276, 1, TOK_ERROR},
+    {277, 1, TOK_ERROR},
+    {278, 1, TOK_ERROR},
+    {279, 1, TOK_ERROR},
+    {280, 1, TOK_ERROR},
+    {281, 1, TOK_ERROR},
+    {282, 1, TOK_ERROR},
+    {283, 1, TOK_ERROR},
+    {284, 1, TOK_ERROR},
+    {285, 1, TOK_ERROR},
+    {286, 2, TOK_ERROR},
+    {288, 1, TOK_ERROR},
+    {289, 1, TOK_ERROR},
+    {290, 1, TOK_ERROR},
+    {291, 1, TOK_ERROR},
+    {292, 1, TOK_ERROR},
+    {293, 1, TOK_ERROR},
+    {294, 1, TOK_ERROR},
+    {295, 1, TOK_ERROR},
+    {296, 1, TOK_ERROR},
+    {297, 1, TOK_ERROR},
+    {298, 1, TOK_ERROR},
+    {299, 1, TOK_ERROR},
+    {300, 1, TOK_ERROR},
+    {301, 1, TOK_ERROR},
+    {302, 0, TOK_HAJIME_OSHIMAI},
+    {302, 1, TOK_ERROR},
+    {303, 1, TOK_ERROR},
+    {304, 1, TOK_ERROR},
+    {305, 1, TOK_ERROR},
+    {306, 1, TOK_ERROR},
+    {307, 1, TOK_ERROR},
+    {308, 1, TOK_ERROR},
+    {309, 1, TOK_ERROR},
+    {310, 1, TOK_ERROR},
+    {311, 1, TOK_ERROR},
+    {312, 1, TOK_ERROR},
+    {313, 1, TOK_ERROR},
+    {314, 1, TOK_ERROR},
+    {315, 1, TOK_ERROR},
+    {316, 1, TOK_ERROR},
+    {317, 1, TOK_ERROR},
+    {318, 1, TOK_ERROR},
+    {319, 1, TOK_ERROR},
+    {320, 1, TOK_ERROR},
+    {321, 1, TOK_ERROR},
+    {322, 1, TOK_ERROR},
+    {323, 1, TOK_ERROR},
+    {324, 1, TOK_ERROR},
+    {325, 1, TOK_ERROR},
+    {326, 1, TOK_ERROR},
+    {327, 1, TOK_ERROR},
+    {328, 0, TOK_NI_NACCHATTA},
+    {328, 1, TOK_ERROR},
+    {329, 2, TOK_ERROR},
+    {331, 1, TOK_ERROR},
+    {332, 1, TOK_ERROR},
+    {333, 1, TOK_ERROR},
+    {334, 1, TOK_ERROR},
+    {335, 1, TOK_ERROR},
+    {336, 1, TOK_ERROR},
+    {337, 1, TOK_ERROR},
+    {338, 1, TOK_ERROR},
+    {339, 1, TOK_ERROR},
+    {340, 2, TOK_ERROR},
+    {342, 1, TOK_ERROR},
+    {343, 1, TOK_ERROR},
+    {344, 1, TOK_ERROR},
+    {345, 1, TOK_ERROR},
+    {346, 1, TOK_ERROR},
+    {347, 1, TOK_ERROR},
+    {348, 1, TOK_ERROR},
+    {349, 1, TOK_ERROR},
+    {350, 1, TOK_ERROR},
+    {351, 1, TOK_ERROR},
+    {352, 1, TOK_ERROR},
+    {353, 1, TOK_ERROR},
+    {354, 0, TOK_DOKIDOKI_OSHIMAI},
+    {354, 1, TOK_ERROR},
+    {355, 1, TOK_ERROR},
+    {356, 1, TOK_ERROR},
+    {357, 1, TOK_ERROR},
+    {358, 1, TOK_ERROR},
+    {359, 1, TOK_ERROR},
+    {360, 1, TOK_ERROR},
+    {361, 1, TOK_ERROR},
+    {362, 1, TOK_ERROR},
+    {363, 1, TOK_ERROR},
+    {364, 1, TOK_ERROR},
+    {365, 1, TOK_ERROR},
+    {366, 1, TOK_ERROR},
+    {367, 1, TOK_ERROR},
+    {368, 1, TOK_ERROR},
+    {369, 1, TOK_ERROR},
+    {370, 1, TOK_ERROR},
+    {371, 0, TOK_DOKIDOKI},
+    {371, 1, TOK_ERROR},
+    {372, 1, TOK_ERROR},
+    {373, 1, TOK_ERROR},
+    {374, 1, TOK_ERROR},
+    {375, 1, TOK_ERROR},
+    {376, 1, TOK_ERROR},
+    {377, 1, TOK_ERROR},
+    {378, 1, TOK_ERROR},
+    {379, 1, TOK_ERROR},
+    {380, 1, TOK_ERROR},
+    {381, 1, TOK_ERROR},
+    {382, 1, TOK_ERROR},
+    {383, 1, TOK_ERROR},
+    {384, 1, TOK_ERROR},
+    {385, 1, TOK_ERROR},
+    {386, 1, TOK_ERROR},
+    {387, 1, TOK_ERROR},
+    {388, 1, TOK_ERROR},
+    {389, 1, TOK_ERROR},
+    {390, 1, TOK_ERROR},
+    {391, 1, TOK_ERROR},
+    {392, 0, TOK_YARIKATA_OSHIMAI},
+    {392, 1, TOK_ERROR},
+    {393, 1, TOK_ERROR},
+    {394, 1, TOK_ERROR},
+    {395, 1, TOK_ERROR},
+    {396, 1, TOK_ERROR},
+    {397, 1, TOK_ERROR},
+    {398, 1, TOK_ERROR},
+    {399, 1, TOK_ERROR},
+    {400, 1, TOK_ERROR},
+    {401, 1, TOK_ERROR},
+    {402, 1, TOK_ERROR},
+    {403, 1, TOK_ERROR},
+    {404, 1, TOK_ERROR},
+    {405, 1, TOK_ERROR},
+    {406, 1, TOK_ERROR},
+    {407, 1, TOK_ERROR},
+    {408, 1, TOK_ERROR},
+    {409, 1, TOK_ERROR},
+    {410, 1, TOK_ERROR},
+    {411, 1, TOK_ERROR},
+    {412, 1, TOK_ERROR},
+    {413, 1, TOK_ERROR},
+    {414, 1, TOK_ERROR},
+    {415, 1, TOK_ERROR},
+    {416, 1, TOK_ERROR},
+    {417, 1, TOK_ERROR},
+    {418, 1, TOK_ERROR},
+    {419, 1, TOK_ERROR},
+    {420, 0, TOK_SOUJANAKATTARA},
+    {420, 1, TOK_ERROR},
+    {421, 1, TOK_ERROR},
+    {422, 1, TOK_ERROR},
+    {423, 1, TOK_ERROR},
+    {424, 1, TOK_ERROR},
+    {425, 1, TOK_ERROR},
+    {426, 1, TOK_ERROR},
+    {427, 1, TOK_ERROR},
+    {428, 1, TOK_ERROR},
+    {429, 1, TOK_ERROR},
+    {430, 1, TOK_ERROR},
+    {431, 1, TOK_ERROR},
+    {432, 1, TOK_ERROR},
+    {433, 1, TOK_ERROR},
+    {434, 1, TOK_ERROR},
+    {435, 1, TOK_ERROR},
+    {436, 1, TOK_ERROR},
+    {437, 1, TOK_ERROR},
+    {438, 1, TOK_ERROR},
+    {439, 1, TOK_ERROR},
+    {440, 0, TOK_DOCCHI_NI_SHITEMO},
+    {440, 1, TOK_ERROR},
+    {441, 1, TOK_ERROR},
+    {442, 1, TOK_ERROR},
+    {443, 0, TOK_HAJIMEMASHITE},
+    {443, 2, TOK_ERROR},
+    {445, 1, TOK_ERROR},
+    {446, 1, TOK_ERROR},
+    {447, 1, TOK_ERROR},
+    {448, 1, TOK_ERROR},
+    {449, 1, TOK_ERROR},
+    {450, 1, TOK_ERROR},
+    {451, 1, TOK_ERROR},
+    {452, 1, TOK_ERROR},
+    {453, 1, TOK_ERROR},
+    {454, 1, TOK_ERROR},
+    {455, 1, TOK_ERROR},
+    {456, 1, TOK_ERROR},
+    {457, 1, TOK_ERROR},
+    {458, 1, TOK_ERROR},
+    {459, 1, TOK_ERROR},
+    {460, 1, TOK_ERROR},
+    {461, 1, TOK_ERROR},
+    {462, 1, TOK_ERROR},
+    {463, 1, TOK_ERROR},
+    {464, 1, TOK_ERROR},
+    {465, 0, TOK_TORIYOSE},
+    {465, 1, TOK_ERROR},
+    {466, 1, TOK_ERROR},
+    {467, 1, TOK_ERROR},
+    {468, 1, TOK_ERROR},
+    {469, 1, TOK_ERROR},
+    {470, 1, TOK_ERROR},
+    {471, 1, TOK_ERROR},
+    {472, 1, TOK_ERROR},
+    {473, 1, TOK_ERROR},
+    {474, 1, TOK_ERROR},
+    {475, 1, TOK_ERROR},
+    {476, 1, TOK_ERROR},
+    {477, 1, TOK_ERROR},
+    {478, 1, TOK_ERROR},
+    {479, 0, TOK_SAN_WO_TSUKURU},
+    {479, 1, TOK_ERROR},
+    {480, 1, TOK_ERROR},
+    {481, 1, TOK_ERROR},
+    {482, 1, TOK_ERROR},
+    {483, 1, TOK_ERROR},
+    {484, 1, TOK_ERROR},
+    {485, 1, TOK_ERROR},
+    {486, 1, TOK_ERROR},
+    {487, 1, TOK_ERROR},
+    {488, 1, TOK_ERROR},
+    {489, 1, TOK_ERROR},
+    {490, 1, TOK_ERROR},
+    {491, 1, TOK_ERROR},
+    {492, 1, TOK_ERROR},
+    {493, 1, TOK_ERROR},
+    {494, 1, TOK_ERROR},
+    {495, 1, TOK_ERROR},
+    {496, 1, TOK_ERROR},
+    {497, 1, TOK_ERROR},
+    {498, 1, TOK_ERROR},
+    {499, 0, TOK_SUUJI_NI},
+    {499, 1, TOK_ERROR},
+    {500, 1, TOK_ERROR},
+    {501, 1, TOK_ERROR},
+    {502, 1, TOK_ERROR},
+    {503, 1, TOK_ERROR},
+    {504, 1, TOK_ERROR},
+    {505, 1, TOK_ERROR},
+    {506, 1, TOK_ERROR},
+    {507, 1, TOK_ERROR},
+    {508, 1, TOK_ERROR},
+    {509, 1, TOK_ERROR},
+    {510, 1, TOK_ERROR},
+    {511, 1, TOK_ERROR},
+    {512, 1, TOK_ERROR},
+    {513, 1, TOK_ERROR},
+    {514, 1, TOK_ERROR},
+    {515, 1, TOK_ERROR},
+    {516, 1, TOK_ERROR},
+    {517, 1, TOK_ERROR},
+    {518, 1, TOK_ERROR},
+    {519, 0, TOK_MOJI_NI},
+    {519, 1, TOK_ERROR},
+    {520, 1, TOK_ERROR},
+    {521, 1, TOK_ERROR},
+    {522, 1, TOK_ERROR},
+    {523, 1, TOK_ERROR},
+    {524, 1, TOK_ERROR},
+    {525, 1, TOK_ERROR},
+    {526, 1, TOK_ERROR},
+    {527, 1, TOK_ERROR},
+    {528, 1, TOK_ERROR},
+    {529, 1, TOK_ERROR},
+    {530, 1, TOK_ERROR},
+    {531, 1, TOK_ERROR},
+    {532, 1, TOK_ERROR},
+    {533, 1, TOK_ERROR},
+    {534, 1, TOK_ERROR},
+    {535, 1, TOK_ERROR},
+    {536, 1, TOK_ERROR},
+    {537, 1, TOK_ERROR},
+    {538, 1, TOK_ERROR},
+    {539, 0, TOK_KATA_WO},
+    {539, 1, TOK_ERROR},
+    {540, 1, TOK_ERROR},
+    {541, 1, TOK_ERROR},
+    {542, 1, TOK_ERROR},
+    {543, 1, TOK_ERROR},
+    {544, 1, TOK_ERROR},
+    {545, 1, TOK_ERROR},
+    {546, 1, TOK_ERROR},
+    {547, 1, TOK_ERROR},
+    {548, 1, TOK_ERROR},
+    {549, 1, TOK_ERROR},
+    {550, 1, TOK_ERROR},
+    {551, 1, TOK_ERROR},
+    {552, 1, TOK_ERROR},
+    {553, 1, TOK_ERROR},
+    {554, 1, TOK_ERROR},
+    {555, 1, TOK_ERROR},
+    {556, 1, TOK_ERROR},
+    {557, 1, TOK_ERROR},
+    {558, 1, TOK_ERROR},
+    {559, 1, TOK_ERROR},
+    {560, 1, TOK_ERROR},
+    {561, 1, TOK_ERROR},
+    {562, 1, TOK_ERROR},
+    {563, 0, TOK_NAGASA_WO},
+    {563, 1, TOK_ERROR},
+    {564, 1, TOK_ERROR},
+    {565, 1, TOK_ERROR},
+    {566, 1, TOK_ERROR},
+    {567, 1, TOK_ERROR},
+    {568, 1, TOK_ERROR},
+    {569, 1, TOK_ERROR},
+    {570, 1, TOK_ERROR},
+    {571, 1, TOK_ERROR},
+    {572, 1, TOK_ERROR},
+    {573, 1, TOK_ERROR},
+    {574, 1, TOK_ERROR},
+    {575, 1, TOK_ERROR},
+    {576, 1, TOK_ERROR},
+    {577, 1, TOK_ERROR},
+    {578, 1, TOK_ERROR},
+    {579, 1, TOK_ERROR},
+    {580, 1, TOK_ERROR},
+    {581, 1, TOK_ERROR},
+    {582, 1, TOK_ERROR},
+    {583, 1, TOK_ERROR},
+    {584, 1, TOK_ERROR},
+    {585, 0, TOK_RANDOM_CHAN},
+    {585, 1, TOK_ERROR},
+    {586, 1, TOK_ERROR},
+    {587, 2, TOK_ERROR},
+    {589, 1, TOK_ERROR},
+    {590, 1, TOK_ERROR},
+    {591, 2, TOK_ERROR},
+    {593, 1, TOK_ERROR},
+    {594, 1, TOK_ERROR},
+    {595, 1, TOK_ERROR},
+    {596, 1, TOK_ERROR},
+    {597, 1, TOK_ERROR},
+    {598, 1, TOK_ERROR},
+    {599, 1, TOK_ERROR},
+    {600, 1, TOK_ERROR},
+    {601, 1, TOK_ERROR},
+    {602, 1, TOK_ERROR},
+    {603, 0, TOK_MOSHIKASHITE},
+    {603, 1, TOK_ERROR},
+    {604, 2, TOK_ERROR},
+    {606, 1, TOK_ERROR},
+    {607, 1, TOK_ERROR},
+    {608, 1, TOK_ERROR},
+    {609, 2, TOK_ERROR},
+    {611, 1, TOK_ERROR},
+    {612, 1, TOK_ERROR},
+    {613, 1, TOK_ERROR},
+    {614, 1, TOK_ERROR},
+    {615, 1, TOK_ERROR},
+    {616, 1, TOK_ERROR},
+    {617, 1, TOK_ERROR},
+    {618, 1, TOK_ERROR},
+    {619, 1, TOK_ERROR},
+    {620, 1, TOK_ERROR},
+    {621, 1, TOK_ERROR},
+    {622, 1, TOK_ERROR},
+    {623, 1, TOK_ERROR},
+    {624, 0, TOK_NANCHATTE},
+    {624, 1, TOK_ERROR},
+    {625, 1, TOK_ERROR},
+    {626, 1, TOK_ERROR},
+    {627, 1, TOK_ERROR},
+    {628, 1, TOK_ERROR},
+    {629, 1, TOK_ERROR},
+    {630, 1, TOK_ERROR},
+    {631, 1, TOK_ERROR},
+    {632, 1, TOK_ERROR},
+    {633, 1, TOK_ERROR},
+    {634, 1, TOK_ERROR},
+    {635, 1, TOK_ERROR},
+    {636, 1, TOK_ERROR},
+    {637, 1, TOK_ERROR},
+    {638, 1, TOK_ERROR},
+    {639, 0, TOK_CHIGAU_KANA},
+    {639, 1, TOK_ERROR},
+    {640, 1, TOK_ERROR},
+    {641, 1, TOK_ERROR},
+    {642, 1, TOK_ERROR},
+    {643, 1, TOK_ERROR},
+    {644, 1, TOK_ERROR},
+    {645, 1, TOK_ERROR},
+    {646, 1, TOK_ERROR},
+    {647, 1, TOK_ERROR},
+    {648, 1, TOK_ERROR},
+    {649, 1, TOK_ERROR},
+    {650, 1, TOK_ERROR},
+    {651, 1, TOK_ERROR},
+    {652, 1, TOK_ERROR},
+    {653, 1, TOK_ERROR},
+    {654, 0, TOK_ONAJI_KANA},
+    {654, 1, TOK_ERROR},
+    {655, 2, TOK_ERROR},
+    {657, 1, TOK_ERROR},
+    {658, 1, TOK_ERROR},
+    {659, 1, TOK_ERROR},
+    {660, 1, TOK_ERROR},
+    {661, 1, TOK_ERROR},
+    {662, 1, TOK_ERROR},
+    {663, 1, TOK_ERROR},
+    {664, 1, TOK_ERROR},
+    {665, 1, TOK_ERROR},
+    {666, 1, TOK_ERROR},
+    {667, 1, TOK_ERROR},
+    {668, 1, TOK_ERROR},
+    {669, 1, TOK_ERROR},
+    {670, 1, TOK_ERROR},
+    {671, 0, TOK_MOU_II},
+    {671, 1, TOK_ERROR},
+    {672, 1, TOK_ERROR},
+    {673, 1, TOK_ERROR},
+    {674, 1, TOK_ERROR},
+    {675, 1, TOK_ERROR},
+    {676, 1, TOK_ERROR},
+    {677, 1, TOK_ERROR},
+    {678, 1, TOK_ERROR},
+    {679, 1, TOK_ERROR},
+    {680, 1, TOK_ERROR},
+    {681, 1, TOK_ERROR},
+    {682, 1, TOK_ERROR},
+    {683, 1, TOK_ERROR},
+    {684, 1, TOK_ERROR},
+    {685, 1, TOK_ERROR},
+    {686, 1, TOK_ERROR},
+    {687, 0, TOK_YABAKATTA},
+    {687, 1, TOK_ERROR},
+    {688, 1, TOK_ERROR},
+    {689, 1, TOK_ERROR},
+    {690, 1, TOK_ERROR},
+    {691, 1, TOK_ERROR},
+    {692, 1, TOK_ERROR},
+    {693, 1, TOK_ERROR},
+    {694, 1, TOK_ERROR},
+    {695, 1, TOK_ERROR},
+    {696, 1, TOK_ERROR},
+    {697, 1, TOK_ERROR},
+    {698, 1, TOK_ERROR},
+    {699, 1, TOK_ERROR},
+    {700, 1, TOK_ERROR},
+    {701, 1, TOK_ERROR},
+    {702, 1, TOK_ERROR},
+    {703, 0, TOK_WO_TSUIKA},
+    {703, 1, TOK_ERROR},
+    {704, 1, TOK_ERROR},
+    {705, 1, TOK_ERROR},
+    {706, 1, TOK_ERROR},
+    {707, 1, TOK_ERROR},
+    {708, 1, TOK_ERROR},
+    {709, 1, TOK_ERROR},
+    {710, 1, TOK_ERROR},
+    {711, 1, TOK_ERROR},
+    {712, 1, TOK_ERROR},
+    {713, 1, TOK_ERROR},
+    {714, 1, TOK_ERROR},
+    {715, 1, TOK_ERROR},
+    {716, 1, TOK_ERROR},
+    {717, 1, TOK_ERROR},
+    {718, 1, TOK_ERROR},
+    {719, 1, TOK_ERROR},
+    {720, 0, TOK_TSUGI_IKOU},
+    {720, 2, TOK_ERROR},
+    {722, 1, TOK_ERROR},
+    {723, 1, TOK_ERROR},
+    {724, 1, TOK_ERROR},
+    {725, 1, TOK_ERROR},
+    {726, 1, TOK_ERROR},
+    {727, 1, TOK_ERROR},
+    {728, 1, TOK_ERROR},
+    {729, 1, TOK_ERROR},
+    {730, 1, TOK_ERROR},
+    {731, 1, TOK_ERROR},
+    {732, 1, TOK_ERROR},
+    {733, 0, TOK_AIDA_WA},
+    {733, 1, TOK_ERROR},
+    {734, 1, TOK_ERROR},
+    {735, 1, TOK_ERROR},
+    {736, 1, TOK_ERROR},
+    {737, 1, TOK_ERROR},
+    {738, 1, TOK_ERROR},
+    {739, 1, TOK_ERROR},
+    {740, 1, TOK_ERROR},
+    {741, 1, TOK_ERROR},
+    {742, 1, TOK_ERROR},
+    {743, 1, TOK_ERROR},
+    {744, 1, TOK_ERROR},
+    {745, 0, TOK_MOU_MURI},
+    {745, 1, TOK_ERROR},
+    {746, 1, TOK_ERROR},
+    {747, 1, TOK_ERROR},
+    {748, 1, TOK_ERROR},
+    {749, 1, TOK_ERROR},
+    {750, 1, TOK_ERROR},
+    {751, 1, TOK_ERROR},
+    {752, 1, TOK_ERROR},
+    {753, 1, TOK_ERROR},
+    {754, 1, TOK_ERROR},
+    {755, 1, TOK_ERROR},
+    {756, 1, TOK_ERROR},
+    {757, 1, TOK_ERROR},
+    {758, 0, TOK_TSUBUYAKI},
+    {758, 1, TOK_ERROR},
+    {759, 1, TOK_ERROR},
+    {760, 1, TOK_ERROR},
+    {761, 1, TOK_ERROR},
+    {762, 2, TOK_ERROR},
+    {764, 1, TOK_ERROR},
+    {765, 1, TOK_ERROR},
+    {766, 1, TOK_ERROR},
+    {767, 1, TOK_ERROR},
+    {768, 1, TOK_ERROR},
+    {769, 1, TOK_ERROR},
+    {770, 1, TOK_ERROR},
+    {771, 0, TOK_OHHA},
+    {771, 1, TOK_ERROR},
+    {772, 1, TOK_ERROR},
+    {773, 1, TOK_ERROR},
+    {774, 1, TOK_ERROR},
+    {775, 1, TOK_ERROR},
+    {776, 1, TOK_ERROR},
+    {777, 1, TOK_ERROR},
+    {778, 1, TOK_ERROR},
+    {779, 0, TOK_OKKEE},
+    {779, 1, TOK_ERROR},
+    {780, 1, TOK_ERROR},
+    {781, 1, TOK_ERROR},
+    {782, 1, TOK_ERROR},
+    {783, 1, TOK_ERROR},
+    {784, 1, TOK_ERROR},
+    {785, 1, TOK_ERROR},
+    {786, 1, TOK_ERROR},
+    {787, 1, TOK_ERROR},
+    {788, 1, TOK_ERROR},
+    {789, 1, TOK_ERROR},
+    {790, 1, TOK_ERROR},
+    {791, 1, TOK_ERROR},
+    {792, 0, TOK_NAGASA_CHAN},
+    {792, 1, TOK_ERROR},
+    {793, 1, TOK_ERROR},
+    {794, 1, TOK_ERROR},
+    {795, 1, TOK_ERROR},
+    {796, 1, TOK_ERROR},
+    {797, 1, TOK_ERROR},
+    {798, 1, TOK_ERROR},
+    {799, 1, TOK_ERROR},
+    {800, 1, TOK_ERROR},
+    {801, 1, TOK_ERROR},
+    {802, 1, TOK_ERROR},
+    {803, 1, TOK_ERROR},
+    {804, 1, TOK_ERROR},
+    {805, 1, TOK_ERROR},
+    {806, 1, TOK_BANME_CHAN},
+    {807, 1, TOK_ERROR},
+    {808, 1, TOK_ERROR},
+    {809, 0, TOK_BANME_CHAN_WA},
+    {809, 1, TOK_ERROR},
+    {810, 1, TOK_ERROR},
+    {811, 1, TOK_ERROR},
+    {812, 1, TOK_ERROR},
+    {813, 1, TOK_ERROR},
+    {814, 1, TOK_ERROR},
+    {815, 1, TOK_ERROR},
+    {816, 0, TOK_CHIGAU_YO},
+    {816, 1, TOK_ERROR},
+    {817, 1, TOK_ERROR},
+    {818, 1, TOK_ERROR},
+    {819, 1, TOK_ERROR},
+    {820, 1, TOK_ERROR},
+    {821, 2, TOK_ERROR},
+    {823, 1, TOK_ERROR},
+    {824, 1, TOK_ERROR},
+    {825, 1, TOK_ERROR},
+    {826, 0, TOK_YORI_UE},
+    {826, 1, TOK_ERROR},
+    {827, 1, TOK_ERROR},
+    {828, 1, TOK_ERROR},
+    {829, 0, TOK_YORI_SHITA},
+    {829, 1, TOK_ERROR},
+    {830, 1, TOK_ERROR},
+    {831, 1, TOK_ERROR},
+    {832, 1, TOK_ERROR},
+    {833, 1, TOK_ERROR},
+    {834, 1, TOK_ERROR},
+    {835, 1, TOK_ERROR},
+    {836, 1, TOK_ERROR},
+    {837, 1, TOK_ERROR},
+    {838, 0, TOK_KOTAE},
+    {838, 1, TOK_ERROR},
+    {839, 1, TOK_ERROR},
+    {840, 1, TOK_ERROR},
+    {841, 1, TOK_ERROR},
+    {842, 1, TOK_ERROR},
+    {843, 1, TOK_ERROR},
+    {844, 1, TOK_ERROR},
+    {845, 0, TOK_DA_YO},
+    {845, 1, TOK_ERROR},
+    {846, 1, TOK_ERROR},
+    {847, 1, TOK_ERROR},
+    {848, 1, TOK_ERROR},
+    {849, 0, TOK_NANDA},
+    {849, 1, TOK_ERROR},
+    {850, 1, TOK_ERROR},
+    {851, 1, TOK_ERROR},
+    {852, 1, TOK_ERROR},
+    {853, 1, TOK_ERROR},
+    {854, 1, TOK_ERROR},
+    {855, 1, TOK_ERROR},
+    {856, 0, TOK_NAI_NAI},
+    {856, 1, TOK_ERROR},
+    {857, 1, TOK_ERROR},
+    {858, 1, TOK_ERROR},
+    {859, 0, TOK_MOSHIKUWA},
+    {859, 1, TOK_ERROR},
+    {860, 1, TOK_ERROR},
+    {861, 1, TOK_ERROR},
+    {862, 1, TOK_ERROR},
+    {863, 2, TOK_ERROR},
+    {865, 1, TOK_ERROR},
+    {866, 1, TOK_ERROR},
+    {867, 1, TOK_ERROR},
+    {868, 0, TOK_IJOU},
+    {868, 1, TOK_ERROR},
+    {869, 1, TOK_ERROR},
+    {870, 1, TOK_ERROR},
+    {871, 0, TOK_IKA},
+    {871, 1, TOK_ERROR},
+    {872, 1, TOK_ERROR},
+    {873, 1, TOK_ERROR},
+    {874, 1, TOK_ERROR},
+    {875, 1, TOK_ERROR},
+    {876, 1, TOK_ERROR},
+    {877, 0, TOK_BOKU_NO},
+    {877, 1, TOK_ERROR},
+    {878, 1, TOK_ERROR},
+    {879, 1, TOK_ERROR},
+    {880, 1, TOK_ERROR},
+    {881, 1, TOK_ERROR},
+    {882, 1, TOK_ERROR},
+    {883, 0, TOK_SHIKAMO},
+    {883, 1, TOK_ERROR},
+    {884, 2, TOK_ERROR},
+    {886, 1, TOK_ERROR},
+    {887, 1, TOK_ERROR},
+    {888, 1, TOK_ERROR},
+    {889, 1, TOK_ERROR},
+    {890, 0, TOK_KAKERU},
+    {890, 1, TOK_ERROR},
+    {891, 1, TOK_ERROR},
+    {892, 1, TOK_ERROR},
+    {893, 1, TOK_ERROR},
+    {894, 1, TOK_ERROR},
+    {895, 1, TOK_ERROR},
+    {896, 0, TOK_KANA},
+    {896, 0, TOK_CHAN_WA},
+    {896, 0, TOK_CHAN_GA},
+    {896, 1, TOK_ERROR},
+    {897, 1, TOK_ERROR},
+    {898, 1, TOK_ERROR},
+    {899, 1, TOK_ERROR},
+    {900, 1, TOK_ERROR},
+    {901, 1, TOK_ERROR},
+    {902, 0, TOK_AMARI},
+    {902, 1, TOK_ERROR},
+    {903, 1, TOK_ERROR},
+    {904, 2, TOK_ERROR},
+    {906, 1, TOK_ERROR},
+    {907, 1, TOK_ERROR},
+    {908, 1, TOK_ERROR},
+    {909, 1, TOK_ERROR},
+    {910, 1, TOK_ERROR},
+    {911, 1, TOK_ERROR},
+    {912, 0, TOK_MAINASU},
+    {912, 0, TOK_MAJI},
+    {912, 1, TOK_ERROR},
+    {913, 1, TOK_ERROR},
+    {914, 1, TOK_ERROR},
+    {915, 0, TOK_HIKU},
+    {915, 1, TOK_ERROR},
+    {916, 1, TOK_ERROR},
+    {917, 1, TOK_ERROR},
+    {918, 0, TOK_WARU},
+    {918, 1, TOK_ERROR},
+    {919, 0, TOK_KARA},
+    {919, 1, TOK_ERROR},
+    {920, 1, TOK_ERROR},
+    {921, 1, TOK_ERROR},
+    {922, 0, TOK_USO},
+    {922, 0, TOK_TO},
+    {922, 5, TOK_ERROR},
+    {927, 0, TOK_COMMA},
+    {927, 1, TOK_ERROR},
+    {928, 1, TOK_ERROR},
+    {929, 0, TOK_ARROW},
+    {929, 0, TOK_LBRACKET},
+    {929, 0, TOK_RBRACKET},
+    {929, 0, TOK_LDICT},
+    {929, 0, TOK_RDICT},
+    {929, 0, TOK_LPAREN},
+    {929, 0, TOK_RPAREN},
+};
+
+static const unsigned char keyword_edge_bytes[929] = {
+    128, 129, 130, 131, 130, 138, 139, 151, 161, 168, 174, 178, 190, 227, 129, 167,
+    233, 150, 162, 228, 191, 130, 227, 129, 130, 227, 130, 139, 227, 130, 147, 227,
+    129, 160, 227, 129, 145, 227, 129, 169, 227, 130, 181, 240, 159, 152, 129, 227,
+    233, 131, 161, 227, 131, 179, 227, 131, 144, 227, 131, 188, 227, 129, 170, 227,
+    130, 147, 227, 129, 160, 227, 129, 145, 227, 129, 169, 227, 130, 181, 240, 159,
+    152, 129, 128, 129, 132, 137, 138, 139, 143, 156, 158, 164, 169, 227, 130, 131,
+    163, 167, 227, 131, 179, 227, 129, 140, 171, 174, 175, 227, 130, 132, 227, 130,
+    138, 230, 150, 185, 230, 149, 153, 227, 129, 136, 227, 130, 139, 227, 131, 141,
+    240, 159, 152, 152, 130, 132, 136, 143, 146, 166, 170, 171, 179, 181, 189, 227,
+    131, 179, 227, 129, 130, 174, 227, 130, 179, 227, 131, 136, 227, 230, 149, 153,
+    227, 129, 136, 227, 130, 139, 227, 131, 168, 240, 159, 152, 131, 129, 138, 227,
+    129, 151, 227, 129, 190, 227, 129, 132, 226, 157, 151, 227, 130, 170, 227, 131,
+    141, 227, 130, 172, 227, 130, 164, 240, 159, 152, 131, 227, 131, 131, 227, 131,
+    136, 230, 232, 149, 153, 227, 129, 136, 227, 129, 166, 227, 131, 168, 240, 159,
+    152, 131, 129, 158, 227, 129, 132, 227, 129, 166, 227, 131, 168, 240, 159, 152,
+    131, 149, 150, 172, 176, 151, 227, 129, 171, 227, 129, 170, 227, 130, 139, 227,
+    130, 147, 227, 129, 160, 227, 129, 145, 227, 129, 169, 240, 159, 152, 154, 227,
+    130, 184, 227, 131, 161, 227, 131, 158, 227, 130, 183, 227, 131, 134, 227, 240,
+    129, 138, 227, 129, 151, 227, 129, 190, 227, 129, 132, 226, 157, 151, 227, 131,
+    138, 227, 131, 131, 227, 131, 129, 227, 131, 163, 227, 131, 131, 227, 130, 191,
+    240, 159, 152, 133, 240, 159, 146, 166, 227, 130, 131, 173, 227, 131, 137, 227,
+    130, 173, 227, 129, 138, 153, 227, 129, 151, 227, 129, 190, 227, 129, 132, 226,
+    157, 151, 227, 130, 139, 227, 129, 145, 227, 129, 169, 240, 159, 152, 133, 240,
+    159, 146, 166, 227, 130, 138, 230, 150, 185, 227, 129, 138, 227, 129, 151, 227,
+    129, 190, 227, 129, 132, 226, 157, 151, 227, 130, 166, 227, 130, 184, 227, 131,
+    163, 227, 131, 138, 227, 130, 171, 227, 131, 131, 227, 130, 191, 227, 131, 169,
+    240, 159, 152, 133, 131, 227, 131, 129, 227, 131, 139, 227, 130, 183, 227, 131,
+    134, 227, 131, 162, 240, 159, 152, 164, 159, 152, 152, 143, 158, 150, 227, 130,
+    138, 229, 175, 132, 227, 129, 155, 227, 129, 166, 227, 131, 168, 240, 159, 152,
+    131, 146, 228, 189, 156, 227, 130, 139, 227, 131, 168, 240, 159, 152, 131, 176,
+    229, 173, 151, 227, 129, 171, 227, 129, 151, 227, 129, 166, 227, 131, 141, 240,
+    159, 152, 152, 135, 229, 173, 151, 227, 129, 171, 227, 129, 151, 227, 129, 166,
+    227, 131, 141, 240, 159, 152, 152, 139, 227, 130, 146, 230, 149, 153, 227, 129,
+    136, 227, 129, 166, 227, 131, 168, 240, 159, 152, 131, 149, 183, 227, 129, 149,
+    227, 130, 146, 230, 149, 153, 227, 129, 136, 227, 129, 166, 227, 131, 168, 240,
+    159, 152, 131, 227, 131, 179, 227, 131, 128, 227, 131, 160, 227, 131, 129, 227,
+    131, 163, 227, 131, 179, 240, 159, 152, 131, 227, 129, 134, 151, 227, 129, 139,
+    143, 227, 129, 151, 227, 129, 166, 240, 159, 152, 141, 227, 130, 131, 179, 227,
+    131, 128, 129, 227, 131, 163, 227, 131, 131, 227, 131, 134, 240, 159, 152, 131,
+    227, 129, 140, 227, 129, 134, 227, 130, 171, 227, 131, 138, 226, 157, 147, 227,
+    129, 170, 227, 129, 152, 227, 130, 171, 227, 131, 138, 226, 157, 147, 227, 129,
+    131, 132, 227, 129, 132, 227, 130, 171, 227, 131, 138, 240, 159, 152, 164, 227,
+    131, 144, 227, 129, 139, 227, 129, 163, 227, 129, 159, 240, 159, 152, 177, 232,
+    191, 189, 229, 138, 160, 227, 131, 128, 227, 131, 168, 240, 159, 152, 129, 161,
+    227, 130, 164, 227, 130, 179, 227, 130, 166, 227, 131, 168, 240, 159, 152, 131,
+    149, 150, 147, 227, 129, 175, 227, 131, 141, 240, 159, 152, 152, 160, 227, 131,
+    170, 240, 159, 152, 177, 240, 159, 146, 166, 227, 131, 150, 227, 131, 164, 227,
+    130, 173, 240, 159, 147, 177, 227, 131, 131, 227, 130, 131, 143, 227, 131, 188,
+    226, 157, 151, 177, 227, 131, 188, 240, 159, 145, 141, 183, 227, 129, 149, 227,
+    131, 129, 227, 131, 163, 227, 131, 179, 149, 170, 231, 155, 174, 227, 131, 129,
+    227, 131, 163, 227, 131, 179, 227, 129, 175, 172, 227, 130, 166, 227, 131, 168,
+    227, 130, 138, 228, 184, 138, 139, 226, 157, 151, 226, 157, 151, 227, 130, 191,
+    227, 130, 168, 227, 129, 175, 227, 131, 168, 240, 159, 152, 129, 240, 159, 152,
+    152, 164, 227, 131, 138, 227, 130, 164, 227, 129, 175, 187, 165, 228, 184, 138,
+    139, 226, 157, 151, 226, 157, 151, 227, 130, 175, 227, 129, 174, 227, 129, 139,
+    227, 130, 130, 227, 129, 130, 145, 227, 130, 139, 227, 131, 138, 226, 157, 147,
+    227, 129, 190, 227, 130, 138, 227, 130, 164, 184, 227, 131, 138, 227, 130, 185,
+    227, 129, 143, 227, 130, 139, 137, 227, 130, 189, 129, 138, 139, 144, 145, 134,
+    146,
+};
+
+static const unsigned short keyword_edge_targets[929] = {
+    928, 2, 109, 73, 895, 616, 879, 872, 600, 927, 38, 913, 3, 4, 5, 6,
+    7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22,
+    23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 39,
+    701, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54,
+    55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70,
+    71, 72, 827, 74, 727, 296, 580, 269, 238, 865, 902, 649, 540, 75, 795, 76,
+    77, 171, 78, 79, 80, 81, 82, 894, 154, 83, 893, 84, 85, 86, 87, 88,
+    89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104,
+    105, 106, 107, 108, 563, 339, 803, 917, 666, 923, 741, 886, 817, 110, 361, 111,
+    112, 113, 114, 115, 437, 116, 117, 118, 119, 120, 121, 122, 139, 123, 124, 125,
+    126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 140, 141, 142,
+    143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 155, 156, 157, 158, 159,
+    160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 172, 173, 174, 175, 176,
+    177, 178, 194, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191,
+    192, 193, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208,
+    209, 452, 473, 683, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222,
+    223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 239,
+    240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 411,
+    255, 256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268, 270, 271,
+    272, 273, 274, 275, 276, 277, 278, 279, 280, 281, 282, 283, 284, 285, 286, 287,
+    288, 289, 290, 291, 292, 293, 294, 295, 297, 298, 390, 299, 300, 301, 302, 303,
+    304, 305, 306, 307, 308, 321, 309, 310, 311, 312, 313, 314, 315, 316, 317, 318,
+    319, 320, 322, 323, 324, 325, 326, 327, 328, 329, 330, 331, 332, 333, 334, 335,
+    336, 337, 338, 340, 341, 342, 343, 344, 345, 346, 347, 348, 349, 350, 351, 352,
+    353, 354, 355, 356, 357, 358, 359, 360, 362, 363, 364, 365, 366, 367, 368, 369,
+    370, 371, 372, 373, 374, 375, 376, 377, 378, 379, 380, 381, 382, 383, 384, 385,
+    386, 387, 388, 389, 391, 392, 393, 394, 395, 396, 397, 398, 399, 400, 401, 402,
+    403, 404, 405, 406, 407, 408, 409, 410, 412, 413, 414, 416, 494, 417, 418, 419,
+    420, 421, 422, 423, 424, 425, 426, 427, 428, 429, 430, 431, 432, 433, 434, 435,
+    436, 438, 439, 440, 441, 442, 443, 444, 445, 446, 447, 448, 449, 450, 451, 453,
+    454, 455, 456, 457, 458, 459, 460, 461, 462, 463, 464, 465, 466, 467, 468, 469,
+    470, 471, 472, 474, 475, 476, 477, 478, 479, 480, 481, 482, 483, 484, 485, 486,
+    487, 488, 489, 490, 491, 492, 493, 495, 496, 497, 498, 499, 500, 501, 502, 503,
+    504, 505, 506, 507, 508, 509, 510, 511, 512, 513, 514, 516, 517, 518, 519, 520,
+    521, 522, 523, 524, 525, 526, 527, 528, 529, 530, 531, 532, 533, 534, 535, 536,
+    537, 538, 539, 541, 542, 543, 544, 545, 546, 547, 548, 549, 550, 551, 552, 553,
+    554, 555, 556, 557, 558, 559, 560, 561, 562, 564, 565, 632, 566, 567, 568, 569,
+    848, 570, 571, 572, 573, 574, 575, 576, 577, 578, 579, 581, 840, 582, 583, 584,
+    585, 835, 586, 587, 588, 589, 590, 591, 592, 593, 594, 595, 596, 597, 598, 599,
+    601, 602, 603, 604, 605, 606, 607, 608, 609, 610, 611, 612, 613, 614, 615, 617,
+    618, 619, 620, 621, 622, 623, 624, 625, 626, 627, 628, 629, 630, 631, 633, 634,
+    714, 635, 636, 637, 638, 639, 640, 641, 642, 643, 644, 645, 646, 647, 648, 650,
+    651, 652, 653, 654, 655, 656, 657, 658, 659, 660, 661, 662, 663, 664, 665, 667,
+    668, 669, 670, 671, 672, 673, 674, 675, 676, 677, 678, 679, 680, 681, 682, 684,
+    685, 686, 687, 688, 689, 690, 691, 692, 693, 694, 695, 696, 697, 698, 699, 700,
+    763, 702, 703, 704, 705, 706, 707, 708, 709, 710, 711, 712, 713, 715, 716, 717,
+    718, 719, 720, 721, 722, 723, 724, 725, 726, 728, 729, 730, 731, 732, 733, 734,
+    735, 736, 737, 738, 739, 740, 742, 743, 744, 745, 754, 746, 747, 748, 749, 750,
+    751, 752, 753, 755, 756, 757, 758, 759, 760, 761, 762, 764, 765, 766, 767, 768,
+    769, 770, 771, 772, 773, 774, 775, 776, 778, 779, 780, 781, 782, 783, 784, 785,
+    786, 787, 788, 789, 790, 791, 792, 793, 794, 796, 797, 798, 799, 800, 801, 802,
+    804, 805, 806, 807, 808, 809, 813, 810, 811, 812, 814, 815, 816, 818, 819, 820,
+    821, 822, 823, 824, 825, 826, 828, 829, 830, 831, 832, 833, 834, 836, 837, 838,
+    839, 841, 842, 843, 844, 845, 846, 847, 849, 850, 851, 853, 854, 855, 856, 857,
+    861, 858, 859, 860, 862, 863, 864, 866, 867, 868, 869, 870, 871, 873, 874, 875,
+    876, 877, 878, 880, 881, 921, 882, 883, 884, 885, 887, 888, 889, 890, 891, 892,
+    896, 897, 898, 899, 900, 901, 903, 904, 905, 912, 906, 907, 908, 909, 910, 911,
+    914, 915, 916, 918, 919, 920, 922, 924, 925, 926, 929, 935, 936, 933, 934, 931,
+    932,
+};
@@ -0,0 +1,91 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGN(size) (((size) + 15) & ~(size_t)15)
+
+struct ArenaBlock {
+    ArenaBlock* next;
+    size_t used;
+    size_t capacity;
+};
+
+#define BLOCK_HEADER ARENA_ALIGN(sizeof(ArenaBlock))
+
+static ArenaBlock* new_block(size_t capacity, ArenaBlock* next) {
+    ArenaBlock* block = malloc(BLOCK_HEADER + capacity);
+    block->next = next;
+    block->used = 0;
+    block->capacity = capacity;
+    return block;
+}
+
+Arena* arena_new(void) {
+    Arena* arena = malloc(sizeof(Arena));
+    arena->blocks = NULL;
+    arena->ref_count = 1;
+    return arena;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    size = ARENA_ALIGN(size);
+    ArenaBlock* block = arena->blocks;
+    if (block == NULL || block->used + size > block->capacity) {
+        if (size > ARENA_BLOCK_SIZE / 4) {
+            if (block == NULL) {
+                arena->blocks = new_block(size, NULL);
+                block = arena->blocks;
+            } else {
+                block->next = new_block(size, block->next);
+                block = block->next;
+            }
+            block->used = size;
+            return (char*)block + BLOCK_HEADER;
+        }
+        arena->blocks = new_block(ARENA_BLOCK_SIZE, block);
+        block = arena->blocks;
+    }
+    void* memory = (char*)block + BLOCK_HEADER + block->used;
+    block->used += size;
+    return memory;
+}
+
+void* arena_grow(Arena* arena, void* old, size_t old_size, size_t new_size) {
+    ArenaBlock* block = arena->blocks;
+    if (old != NULL && block != NULL &&
+        (char*)old + ARENA_ALIGN(old_size) == (char*)block + BLOCK_HEADER + block->used &&
+        block->used - ARENA_ALIGN(old_size) + ARENA_ALIGN(new_size) <= block->capacity) {
+        block->used += ARENA_ALIGN(new_size) - ARENA_ALIGN(old_size);
+        return old;
+    }
+    void* memory = arena_alloc(arena, new_size);
+    if (old != NULL) memcpy(memory, old, old_size);
+    return memory;
+}
+
+char* arena_strndup(Arena* arena, const char* chars, size_t length) {
+    char* str = arena_alloc(arena, length + 1);
+    memcpy(str, chars, length);
+    str[length] = '\0';
+    return str;
+}
+
+char* arena_strdup(Arena* arena, const char* chars) {
+    return arena_strndup(arena, chars, strlen(chars));
+}
+
+void arena_retain(Arena* arena) {
+    if (arena) arena->ref_count++;
+}
+
+void arena_release(Arena* arena) {
+    if (!arena || --arena->ref_count > 0) return;
+    ArenaBlock* block = arena->blocks;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
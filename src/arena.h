@@ -0,0 +1,30 @@
+#ifndef OJISAN_ARENA_H
+#define OJISAN_ARENA_H
+
+#include <stddef.h>
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct Arena {
+    ArenaBlock* blocks;
+    int ref_count;
+} Arena;
+
+
+Arena* arena_new(void);
+
+
+void* arena_alloc(Arena* arena, size_t size);
+
+
+void* arena_grow(Arena* arena, void* old, size_t old_size, size_t new_size);
+
+
+char* arena_strndup(Arena* arena, const char* chars, size_t length);
+char* arena_strdup(Arena* arena, const char* chars);
+
+
+void arena_retain(Arena* arena);
+void arena_release(Arena* arena);
+
+#endif
@@ -1,150 +1,210 @@
 #include "ast.h"
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 
-AstNode* ast_new_node(AstType type, int line) {
-    AstNode* node = malloc(sizeof(AstNode));
-    if (node) {
-        memset(node, 0, sizeof(AstNode));
-        node->type = type;
-        node->line = line;
-    }
+AstNode* ast_new_node(Arena* arena, AstType type, int line) {
+    AstNode* node = arena_alloc(arena, sizeof(AstNode));
+    memset(node, 0, sizeof(AstNode));
+    node->type = type;
+    node->line = line;
+    if (type == AST_FUNC_DECL) node->as.func_decl.arena = arena;
     return node;
 }
 
-void ast_free(AstNode* node) {
-    if (!node) return;
+void ast_free(AstNode* program) {
+    if (!program) return;
+    arena_release(program->as.block.arena);
+}
+
+
+static const char* op_name(TokenType op) {
+    switch (op) {
+        case TOK_TO: return "と";
+        case TOK_HIKU: return "ひく";
+        case TOK_KAKERU: return "かける";
+        case TOK_WARU: return "わる";
+        case TOK_AMARI: return "あまり";
+        case TOK_ONAJI_KANA: return "おなじカナ❓";
+        case TOK_CHIGAU_KANA: return "ちがうカナ❓";
+        case TOK_YORI_UE: return "より上❗";
+        case TOK_YORI_SHITA: return "より下❗";
+        case TOK_IJOU: return "以上❗";
+        case TOK_IKA: return "以下❗";
+        case TOK_SHIKAMO: return "しかも";
+        case TOK_MOSHIKUWA: return "もしくは";
+        case TOK_MAINASU: return "マイナス";
+        case TOK_CHIGAU_YO: return "チガウヨ";
+        default: return "?";
+    }
+}
+
+static void dump_node(AstNode* node, int depth, const char* label);
+
+static void dump_list(AstNode** nodes, int count, int depth, const char* label) {
+    for (int i = 0; i < count; i++) dump_node(nodes[i], depth, label);
+}
 
+static void dump_node(AstNode* node, int depth, const char* label) {
+    if (!node) return;
+    printf("%4d %*s", node->line, depth * 2, "");
+    if (label) printf("%s: ", label);
     switch (node->type) {
         case AST_VAR_DECL:
-            free(node->as.var_decl.name);
-            ast_free(node->as.var_decl.init);
+            printf("VAR_DECL %s\n", node->as.var_decl.name);
+            dump_node(node->as.var_decl.init, depth + 1, NULL);
             break;
         case AST_ASSIGNMENT:
-            free(node->as.assignment.name);
-            ast_free(node->as.assignment.value);
+            printf("ASSIGN %s\n", node->as.assignment.name);
+            dump_node(node->as.assignment.value, depth + 1, NULL);
             break;
         case AST_IF:
-            ast_free(node->as.if_stmt.condition);
-            ast_free(node->as.if_stmt.then_branch);
-            ast_free(node->as.if_stmt.else_branch);
+            printf("IF\n");
+            dump_node(node->as.if_stmt.condition, depth + 1, "cond");
+            dump_node(node->as.if_stmt.then_branch, depth + 1, "then");
+            dump_node(node->as.if_stmt.else_branch, depth + 1, "else");
             break;
         case AST_WHILE:
-            ast_free(node->as.while_stmt.condition);
-            ast_free(node->as.while_stmt.body);
+            printf("WHILE\n");
+            dump_node(node->as.while_stmt.condition, depth + 1, "cond");
+            dump_node(node->as.while_stmt.body, depth + 1, NULL);
             break;
         case AST_FOR_RANGE:
-            free(node->as.for_range.var_name);
-            ast_free(node->as.for_range.start);
-            ast_free(node->as.for_range.end);
-            ast_free(node->as.for_range.body);
+            printf("FOR_RANGE %s\n", node->as.for_range.var_name);
+            dump_node(node->as.for_range.start, depth + 1, "from");
+            dump_node(node->as.for_range.end, depth + 1, "to");
+            dump_node(node->as.for_range.body, depth + 1, NULL);
             break;
         case AST_FOR_EACH:
-            free(node->as.for_each.var_name);
-            ast_free(node->as.for_each.collection);
-            ast_free(node->as.for_each.body);
+            printf("FOR_EACH %s\n", node->as.for_each.var_name);
+            dump_node(node->as.for_each.collection, depth + 1, "in");
+            dump_node(node->as.for_each.body, depth + 1, NULL);
             break;
         case AST_FUNC_DECL:
-            free(node->as.func_decl.name);
-            for (int i = 0; i < node->as.func_decl.param_count; i++) free(node->as.func_decl.params[i]);
-            free(node->as.func_decl.params);
-            ast_free(node->as.func_decl.body);
+            printf("FUNC %s(", node->as.func_decl.name);
+            for (int i = 0; i < node->as.func_decl.param_count; i++) {
+                printf("%s%s", i > 0 ? ", " : "", node->as.func_decl.params[i]);
+            }
+            printf(")\n");
+            dump_node(node->as.func_decl.body, depth + 1, NULL);
             break;
         case AST_CLASS_DECL:
-            free(node->as.class_decl.name);
-            ast_free(node->as.class_decl.constructor);
-            for (int i = 0; i < node->as.class_decl.method_count; i++) ast_free(node->as.class_decl.methods[i]);
-            free(node->as.class_decl.methods);
+            printf("CLASS %s\n", node->as.class_decl.name);
+            dump_node(node->as.class_decl.constructor, depth + 1, "init");
+            dump_list(node->as.class_decl.methods, node->as.class_decl.method_count, depth + 1, NULL);
             break;
         case AST_RETURN:
-            ast_free(node->as.return_stmt.value);
+            printf("RETURN\n");
+            dump_node(node->as.return_stmt.value, depth + 1, NULL);
             break;
         case AST_PRINT:
-            ast_free(node->as.print_stmt.value);
+            printf("%s\n", node->as.print_stmt.is_println ? "PRINTLN" : "PRINT");
+            dump_node(node->as.print_stmt.value, depth + 1, NULL);
             break;
+        case AST_BREAK: printf("BREAK\n"); break;
+        case AST_CONTINUE: printf("CONTINUE\n"); break;
         case AST_TRY:
-            ast_free(node->as.try_stmt.try_block);
-            free(node->as.try_stmt.catch_var);
-            ast_free(node->as.try_stmt.catch_block);
-            ast_free(node->as.try_stmt.finally_block);
+            printf("TRY");
+            if (node->as.try_stmt.catch_var) printf(" catch %s", node->as.try_stmt.catch_var);
+            printf("\n");
+            dump_node(node->as.try_stmt.try_block, depth + 1, "try");
+            dump_node(node->as.try_stmt.catch_block, depth + 1, "catch");
+            dump_node(node->as.try_stmt.finally_block, depth + 1, "finally");
             break;
         case AST_ARRAY_PUSH:
-            free(node->as.array_push.array_name);
-            ast_free(node->as.array_push.value);
-            break;
-        case AST_IMPORT:
-            free(node->as.import_stmt.path);
+            printf("PUSH %s\n", node->as.array_push.array_name);
+            dump_node(node->as.array_push.value, depth + 1, NULL);
             break;
+        case AST_IMPORT: printf("IMPORT \"%s\"\n", node->as.import_stmt.path); break;
         case AST_EXPR_STMT:
-            ast_free(node->as.expr_stmt.expr);
+            printf("EXPR\n");
+            dump_node(node->as.expr_stmt.expr, depth + 1, NULL);
             break;
         case AST_BLOCK:
-            for (int i = 0; i < node->as.block.stmt_count; i++) ast_free(node->as.block.stmts[i]);
-            free(node->as.block.stmts);
+            printf("BLOCK (%d)\n", node->as.block.stmt_count);
+            dump_list(node->as.block.stmts, node->as.block.stmt_count, depth + 1, NULL);
             break;
         case AST_BINARY:
-            ast_free(node->as.binary.left);
-            ast_free(node->as.binary.right);
+            printf("BINARY %s\n", op_name(node->as.binary.op));
+            dump_node(node->as.binary.left, depth + 1, NULL);
+            dump_node(node->as.binary.right, depth + 1, NULL);
             break;
         case AST_UNARY:
-            ast_free(node->as.unary.operand);
+            printf("UNARY %s\n", op_name(node->as.unary.op));
+            dump_node(node->as.unary.operand, depth + 1, NULL);
             break;
         case AST_LITERAL:
-            if (node->as.literal.type == LIT_STR) free(node->as.literal.s_val);
-            break;
-        case AST_VARIABLE:
-            free(node->as.variable.name);
+            switch (node->as.literal.type) {
+                case LIT_INT: printf("INT %lld\n", node->as.literal.i_val); break;
+                case LIT_FLOAT: printf("FLOAT %g\n", node->as.literal.f_val); break;
+                case LIT_STR: printf("STRING 「%s」\n", node->as.literal.s_val); break;
+                case LIT_BOOL: printf("BOOL %s\n", node->as.literal.b_val ? "マジ" : "ウソ"); break;
+                case LIT_NULL: printf("NULL\n"); break;
+            }
             break;
+        case AST_VARIABLE: printf("VAR %s\n", node->as.variable.name); break;
         case AST_CALL:
-            ast_free(node->as.call.callee);
-            for (int i = 0; i < node->as.call.arg_count; i++) ast_free(node->as.call.args[i]);
-            free(node->as.call.args);
+            printf("CALL\n");
+            dump_node(node->as.call.callee, depth + 1, "callee");
+            dump_list(node->as.call.args, node->as.call.arg_count, depth + 1, "arg");
             break;
         case AST_GET:
-            ast_free(node->as.get.object);
-            free(node->as.get.name);
+            printf("GET %s\n", node->as.get.name);
+            dump_node(node->as.get.object, depth + 1, NULL);
+            break;
+        case AST_SET:
+            printf("SET %s\n", node->as.set.name);
+            dump_node(node->as.set.object, depth + 1, NULL);
+            dump_node(node->as.set.value, depth + 1, "value");
             break;
         case AST_INDEX_GET:
-            ast_free(node->as.index_get.object);
-            ast_free(node->as.index_get.index);
+            printf("INDEX_GET\n");
+            dump_node(node->as.index_get.object, depth + 1, NULL);
+            dump_node(node->as.index_get.index, depth + 1, "index");
             break;
         case AST_INDEX_SET:
-            ast_free(node->as.index_set.object);
-            ast_free(node->as.index_set.index);
-            ast_free(node->as.index_set.value);
+            printf("INDEX_SET\n");
+            dump_node(node->as.index_set.object, depth + 1, NULL);
+            dump_node(node->as.index_set.index, depth + 1, "index");
+            dump_node(node->as.index_set.value, depth + 1, "value");
             break;
+        case AST_THIS: printf("THIS\n"); break;
         case AST_ARRAY_LITERAL:
-            for (int i = 0; i < node->as.array_literal.count; i++) ast_free(node->as.array_literal.elements[i]);
-            free(node->as.array_literal.elements);
+            printf("ARRAY (%d)\n", node->as.array_literal.count);
+            dump_list(node->as.array_literal.elements, node->as.array_literal.count, depth + 1, NULL);
             break;
         case AST_DICT_LITERAL:
+            printf("DICT (%d)\n", node->as.dict_literal.count);
             for (int i = 0; i < node->as.dict_literal.count; i++) {
-                ast_free(node->as.dict_literal.keys[i]);
-                ast_free(node->as.dict_literal.values[i]);
+                dump_node(node->as.dict_literal.keys[i], depth + 1, "key");
+                dump_node(node->as.dict_literal.values[i], depth + 1, "value");
             }
-            free(node->as.dict_literal.keys);
-            free(node->as.dict_literal.values);
             break;
         case AST_INPUT:
-            ast_free(node->as.input.prompt);
+            printf("INPUT\n");
+            dump_node(node->as.input.prompt, depth + 1, NULL);
             break;
         case AST_NEW:
-            free(node->as.new_expr.class_name);
-            for (int i = 0; i < node->as.new_expr.arg_count; i++) ast_free(node->as.new_expr.args[i]);
-            free(node->as.new_expr.args);
+            printf("NEW %s\n", node->as.new_expr.class_name);
+            dump_list(node->as.new_expr.args, node->as.new_expr.arg_count, depth + 1, "arg");
             break;
         case AST_CONVERT:
-            ast_free(node->as.convert.target);
+            printf("CONVERT %s\n", node->as.convert.to_string ? "string" : "number");
+            dump_node(node->as.convert.target, depth + 1, NULL);
             break;
         case AST_TYPEOF:
-            ast_free(node->as.typeof_expr.target);
+            printf("TYPEOF\n");
+            dump_node(node->as.typeof_expr.target, depth + 1, NULL);
             break;
         case AST_RANDOM:
-            ast_free(node->as.random_expr.min);
-            ast_free(node->as.random_expr.max);
-            break;
-        default:
+            printf("RANDOM\n");
+            dump_node(node->as.random_expr.min, depth + 1, "min");
+            dump_node(node->as.random_expr.max, depth + 1, "max");
             break;
     }
-    free(node);
+}
+
+void ast_dump(AstNode* node, const char* title) {
+    printf("== %s ==\n", title);
+    dump_node(node, 0, NULL);
 }
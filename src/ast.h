@@ -2,6 +2,7 @@
 #define OJISAN_AST_H
 
 #include "token.h"
+#include "arena.h"
 #include <stdbool.h>
 
 
@@ -54,21 +55,21 @@ struct AstNode {
     
     union {
         
-        struct { char* name; AstNode* init; } var_decl;
-        struct { char* name; AstNode* value; } assignment; 
+        struct { char* name; AstNode* init; int slot; } var_decl;
+        struct { char* name; AstNode* value; int depth; int slot; } assignment; 
         struct { AstNode* condition; AstNode* then_branch; AstNode* else_branch; } if_stmt; 
         struct { AstNode* condition; AstNode* body; } while_stmt;
-        struct { char* var_name; AstNode* start; AstNode* end; AstNode* body; } for_range;
-        struct { char* var_name; AstNode* collection; AstNode* body; } for_each;
-        struct { char* name; int param_count; char** params; AstNode* body; } func_decl;
-        struct { char* name; AstNode* constructor; int method_count; AstNode** methods; } class_decl;
+        struct { char* var_name; AstNode* start; AstNode* end; AstNode* body; bool captured; } for_range;
+        struct { char* var_name; AstNode* collection; AstNode* body; bool captured; } for_each;
+        struct { char* name; int param_count; char** params; AstNode* body; int slot; char** frame_names; bool captured; Arena* arena; } func_decl;
+        struct { char* name; AstNode* constructor; int method_count; AstNode** methods; int slot; } class_decl;
         struct { AstNode* value; } return_stmt;
         struct { AstNode* value; bool is_println; } print_stmt;
-        struct { AstNode* try_block; char* catch_var; AstNode* catch_block; AstNode* finally_block; } try_stmt;
-        struct { char* array_name; AstNode* value; } array_push;
+        struct { AstNode* try_block; char* catch_var; AstNode* catch_block; AstNode* finally_block; bool catch_captured; } try_stmt;
+        struct { char* array_name; AstNode* value; int depth; int slot; } array_push;
         struct { char* path; } import_stmt;
         struct { AstNode* expr; } expr_stmt;
-        struct { int stmt_count; AstNode** stmts; } block;
+        struct { int stmt_count; AstNode** stmts; int local_count; char** local_names; bool captured; Arena* arena; } block;
 
         
         struct { TokenType op; AstNode* left; AstNode* right; } binary;
@@ -76,18 +77,20 @@ struct AstNode {
         struct { 
             enum { LIT_INT, LIT_FLOAT, LIT_STR, LIT_BOOL, LIT_NULL } type;
             union { long long i_val; double f_val; char* s_val; bool b_val; };
+            int const_slot;
+            unsigned int const_session;
         } literal;
-        struct { char* name; } variable;
+        struct { char* name; int depth; int slot; } variable;
         struct { AstNode* callee; int arg_count; AstNode** args; } call;
-        struct { AstNode* object; char* name; } get;
-        struct { AstNode* object; char* name; AstNode* value; } set;
+        struct { AstNode* object; char* name; struct InlineCache* cache; } get;
+        struct { AstNode* object; char* name; AstNode* value; struct InlineCache* cache; } set;
         struct { AstNode* object; AstNode* index; } index_get;
         struct { AstNode* object; AstNode* index; AstNode* value; } index_set;
         
         struct { int count; AstNode** elements; } array_literal;
         struct { int count; AstNode** keys; AstNode** values; } dict_literal;
         struct { AstNode* prompt; } input;
-        struct { char* class_name; int arg_count; AstNode** args; } new_expr;
+        struct { char* class_name; int arg_count; AstNode** args; int depth; int slot; } new_expr;
         struct { bool to_string; AstNode* target; } convert; 
         struct { AstNode* target; } typeof_expr;
         struct { AstNode* min; AstNode* max; } random_expr;
@@ -95,7 +98,8 @@ struct AstNode {
 };
 
 
-AstNode* ast_new_node(AstType type, int line);
-void ast_free(AstNode* node);
+AstNode* ast_new_node(Arena* arena, AstType type, int line);
+void ast_free(AstNode* program);
+void ast_dump(AstNode* node, const char* title);
 
 #endif 
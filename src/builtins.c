@@ -1,5 +1,10 @@
 #include "builtins.h"
 #include "hashtable.h"
+#include "valuetable.h"
+#include "gc.h"
+#include "pool.h"
+#include "typedarray.h"
+#include "sort.h"
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
@@ -233,6 +238,45 @@ static char* winhttp_request(const char* method, const char* url,
 }
 #endif
 
+static NativeCallHook native_call_hook = NULL;
+static bool native_failed = false;
+static ErrorType native_error_type;
+static char native_error[512];
+
+void builtins_set_call_hook(NativeCallHook hook) {
+    native_call_hook = hook;
+}
+
+bool builtins_call(Value callee, int argCount, Value* args, Value* out) {
+    if (native_call_hook == NULL) {
+        builtins_raise(ERR_RUNTIME, "ここからは関数を呼べないヨ😅💦");
+        return false;
+    }
+    if (native_call_hook(callee, argCount, args, out)) return true;
+    native_failed = true;
+    return false;
+}
+
+bool builtins_take_failure(void) {
+    bool failed = native_failed;
+    native_failed = false;
+    return failed;
+}
+
+void builtins_raise(ErrorType type, const char* message) {
+    native_error_type = type;
+    snprintf(native_error, sizeof(native_error), "%s", message);
+    native_failed = true;
+}
+
+bool builtins_take_error(ErrorType* type, char* message, size_t size) {
+    if (native_error[0] == '\0') return false;
+    *type = native_error_type;
+    snprintf(message, size, "%s", native_error);
+    native_error[0] = '\0';
+    return true;
+}
+
 static Value builtin_clock(int argCount, Value* args) {
     (void)argCount; (void)args;
     return FLOAT_VAL((double)clock() / CLOCKS_PER_SEC);
@@ -307,18 +351,18 @@ typedef struct {
     bool first;
 } DictStringContext;
 
-static void dict_string_entry(const char* key, void* val, void* userdata) {
+static void dict_string_entry(ObjString* key, Value val, void* userdata) {
     DictStringContext* ctx = (DictStringContext*)userdata;
     if (!ctx->first) {
         ctx->offset += snprintf(ctx->buffer + ctx->offset, ctx->buf_size - ctx->offset, "、");
     }
     ctx->first = false;
-    ctx->offset += snprintf(ctx->buffer + ctx->offset, ctx->buf_size - ctx->offset, "%s→", key);
-    ctx->offset += value_to_string_buf(*(Value*)val, ctx->buffer + ctx->offset, ctx->buf_size - ctx->offset);
+    ctx->offset += snprintf(ctx->buffer + ctx->offset, ctx->buf_size - ctx->offset, "%s→", key->chars);
+    ctx->offset += value_to_string_buf(val, ctx->buffer + ctx->offset, ctx->buf_size - ctx->offset);
 }
 
 static int value_to_string_buf(Value value, char* buffer, int buf_size) {
-    switch (value.type) {
+    switch (VALUE_TYPE(value)) {
         case VAL_NULL: return snprintf(buffer, buf_size, "ナイナイ");
         case VAL_BOOL: return snprintf(buffer, buf_size, AS_BOOL(value) ? "マジ" : "ウソ");
         case VAL_INT: return snprintf(buffer, buf_size, "%lld", AS_INT(value));
@@ -326,7 +370,7 @@ static int value_to_string_buf(Value value, char* buffer, int buf_size) {
         case VAL_OBJ:
             switch (AS_OBJ(value)->type) {
                 case OBJ_STRING:
-                    return snprintf(buffer, buf_size, "%s", ((ObjString*)AS_OBJ(value))->chars);
+                    return snprintf(buffer, buf_size, "%s", AS_STRING(value)->chars);
                 case OBJ_LIST: {
                     ObjList* list = (ObjList*)AS_OBJ(value);
                     int offset = snprintf(buffer, buf_size, "【");
@@ -341,11 +385,25 @@ static int value_to_string_buf(Value value, char* buffer, int buf_size) {
                     ObjDict* dict = (ObjDict*)AS_OBJ(value);
                     int offset = snprintf(buffer, buf_size, "《");
                     DictStringContext ctx = { .buffer = buffer, .buf_size = buf_size, .offset = offset, .first = true };
-                    table_iterate(dict->items, dict_string_entry, &ctx);
+                    value_table_iterate(&dict->items, dict_string_entry, &ctx);
                     offset = ctx.offset;
                     offset += snprintf(buffer + offset, buf_size - offset, "》");
                     return offset;
                 }
+                case OBJ_TYPED_ARRAY: {
+                    ObjTypedArray* array = (ObjTypedArray*)AS_OBJ(value);
+                    int offset = snprintf(buffer, buf_size, "【");
+                    for (int i = 0; i < array->count; i++) {
+                        int room = offset < buf_size ? buf_size - offset : 0;
+                        char* out = room > 0 ? buffer + offset : NULL;
+                        const char* sep = i > 0 ? "、" : "";
+                        if (array->kind == TYPED_INT64) offset += snprintf(out, room, "%s%lld", sep, (long long)array->as.ints[i]);
+                        else offset += snprintf(out, room, "%s%g", sep, array->as.floats[i]);
+                    }
+                    int room = offset < buf_size ? buf_size - offset : 0;
+                    offset += snprintf(room > 0 ? buffer + offset : NULL, room, "】");
+                    return offset;
+                }
                 default:
                     return snprintf(buffer, buf_size, "オブジェクト");
             }
@@ -385,7 +443,7 @@ static Value builtin_to_number(int argCount, Value* args) {
     if (IS_FLOAT(v)) return v;
     if (IS_OBJ(v)) {
         if (AS_OBJ(v)->type == OBJ_STRING) {
-            char* chars = ((ObjString*)AS_OBJ(v))->chars;
+            char* chars = AS_STRING(v)->chars;
             char* endptr = NULL;
             if (strchr(chars, '.')) {
                 double d = strtod(chars, &endptr);
@@ -406,11 +464,14 @@ static Value builtin_length(int argCount, Value* args) {
     Value v = args[0];
     if (IS_OBJ(v)) {
         if (AS_OBJ(v)->type == OBJ_STRING) {
-            return INT_VAL(((ObjString*)AS_OBJ(v))->length);
+            return INT_VAL(AS_STRING(v)->length);
         }
         if (AS_OBJ(v)->type == OBJ_LIST) {
             return INT_VAL(((ObjList*)AS_OBJ(v))->count);
         }
+        if (AS_OBJ(v)->type == OBJ_TYPED_ARRAY) {
+            return INT_VAL(((ObjTypedArray*)AS_OBJ(v))->count);
+        }
     }
     return INT_VAL(0);
 }
@@ -439,8 +500,8 @@ static Value builtin_contains(int argCount, Value* args) {
     if (argCount < 2) return BOOL_VAL(false);
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return BOOL_VAL(false);
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return BOOL_VAL(false);
-    char* haystack = ((ObjString*)AS_OBJ(args[0]))->chars;
-    char* needle = ((ObjString*)AS_OBJ(args[1]))->chars;
+    char* haystack = AS_STRING(args[0])->chars;
+    char* needle = AS_STRING(args[1])->chars;
     return BOOL_VAL(strstr(haystack, needle) != NULL);
 }
 
@@ -562,7 +623,7 @@ static Value builtin_to_int(int argCount, Value* args) {
     if (IS_INT(v)) return v;
     if (IS_FLOAT(v)) return INT_VAL((long long)AS_FLOAT(v));
     if (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING) {
-        return INT_VAL(strtoll(((ObjString*)AS_OBJ(v))->chars, NULL, 10));
+        return INT_VAL(strtoll(AS_STRING(v)->chars, NULL, 10));
     }
     return INT_VAL(0);
 }
@@ -572,10 +633,12 @@ static Value builtin_split(int argCount, Value* args) {
     if (argCount < 2) return OBJ_VAL(new_list());
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return OBJ_VAL(new_list());
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return OBJ_VAL(new_list());
-    char* str = ((ObjString*)AS_OBJ(args[0]))->chars;
-    char* delim = ((ObjString*)AS_OBJ(args[1]))->chars;
+    char* str = AS_STRING(args[0])->chars;
+    char* delim = AS_STRING(args[1])->chars;
     int delim_len = strlen(delim);
     ObjList* list = new_list();
+    GcRootMark roots = gc_root_mark();
+    gc_push_root(OBJ_VAL(list));
     if (delim_len == 0) {
         
         int len = strlen(str);
@@ -586,13 +649,12 @@ static Value builtin_split(int argCount, Value* args) {
             else if (c >= 0xE0 && c < 0xF0) charlen = 3;
             else if (c >= 0xF0) charlen = 4;
             ObjString* s = copy_string_value(str + i, charlen);
-            if (list->count + 1 > list->capacity) {
-                list->capacity = list->capacity < 8 ? 8 : list->capacity * 2;
-                list->items = realloc(list->items, sizeof(Value) * list->capacity);
-            }
+            list_ensure_capacity(list, list->count + 1);
+            gc_list_write_barrier(list, list->count, OBJ_VAL(s));
             list->items[list->count++] = OBJ_VAL(s);
             i += charlen;
         }
+        gc_root_reset(roots);
         return OBJ_VAL(list);
     }
     char* p = str;
@@ -600,14 +662,13 @@ static Value builtin_split(int argCount, Value* args) {
         char* found = strstr(p, delim);
         int seg_len = found ? (int)(found - p) : (int)strlen(p);
         ObjString* s = copy_string_value(p, seg_len);
-        if (list->count + 1 > list->capacity) {
-            list->capacity = list->capacity < 8 ? 8 : list->capacity * 2;
-            list->items = realloc(list->items, sizeof(Value) * list->capacity);
-        }
+        list_ensure_capacity(list, list->count + 1);
+        gc_list_write_barrier(list, list->count, OBJ_VAL(s));
         list->items[list->count++] = OBJ_VAL(s);
         if (!found) break;
         p = found + delim_len;
     }
+    gc_root_reset(roots);
     return OBJ_VAL(list);
 }
 
@@ -618,7 +679,7 @@ static Value builtin_join(int argCount, Value* args) {
     ObjList* list = (ObjList*)AS_OBJ(args[0]);
     char* delim = "";
     if (argCount >= 2 && IS_OBJ(args[1]) && AS_OBJ(args[1])->type == OBJ_STRING) {
-        delim = ((ObjString*)AS_OBJ(args[1]))->chars;
+        delim = AS_STRING(args[1])->chars;
     }
     int total = 0;
     int delim_len = strlen(delim);
@@ -627,7 +688,7 @@ static Value builtin_join(int argCount, Value* args) {
     for (int i = 0; i < list->count; i++) {
         if (i > 0) total += delim_len;
         Value v = list->items[i];
-        if (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING) total += ((ObjString*)AS_OBJ(v))->length;
+        if (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING) total += AS_STRING(v)->length;
         else { snprintf(buf, sizeof(buf), "%lld", IS_INT(v) ? AS_INT(v) : 0LL); total += strlen(buf); }
     }
     char* result = malloc(total + 1);
@@ -637,7 +698,7 @@ static Value builtin_join(int argCount, Value* args) {
         if (i > 0) { memcpy(result + offset, delim, delim_len); offset += delim_len; }
         Value v = list->items[i];
         if (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING) {
-            ObjString* s = (ObjString*)AS_OBJ(v);
+            ObjString* s = AS_STRING(v);
             memcpy(result + offset, s->chars, s->length);
             offset += s->length;
         } else {
@@ -655,7 +716,7 @@ static Value builtin_join(int argCount, Value* args) {
 static Value builtin_substring(int argCount, Value* args) {
     if (argCount < 2) return NULL_VAL;
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
-    ObjString* str = (ObjString*)AS_OBJ(args[0]);
+    ObjString* str = AS_STRING(args[0]);
     long long start = IS_INT(args[1]) ? AS_INT(args[1]) : 0;
     long long end = (argCount >= 3 && IS_INT(args[2])) ? AS_INT(args[2]) : str->length;
     if (start < 0) start = 0;
@@ -670,9 +731,9 @@ static Value builtin_replace(int argCount, Value* args) {
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return NULL_VAL;
     if (!IS_OBJ(args[2]) || AS_OBJ(args[2])->type != OBJ_STRING) return NULL_VAL;
-    char* src = ((ObjString*)AS_OBJ(args[0]))->chars;
-    char* search = ((ObjString*)AS_OBJ(args[1]))->chars;
-    char* replace = ((ObjString*)AS_OBJ(args[2]))->chars;
+    char* src = AS_STRING(args[0])->chars;
+    char* search = AS_STRING(args[1])->chars;
+    char* replace = AS_STRING(args[2])->chars;
     int search_len = strlen(search);
     int replace_len = strlen(replace);
     if (search_len == 0) return args[0];
@@ -701,8 +762,8 @@ static Value builtin_replace(int argCount, Value* args) {
 
 static Value builtin_trim(int argCount, Value* args) {
     if (argCount < 1 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
-    char* str = ((ObjString*)AS_OBJ(args[0]))->chars;
-    int len = ((ObjString*)AS_OBJ(args[0]))->length;
+    char* str = AS_STRING(args[0])->chars;
+    int len = AS_STRING(args[0])->length;
     int start = 0, end = len;
     while (start < end && (str[start] == ' ' || str[start] == '\t' || str[start] == '\n' || str[start] == '\r')) start++;
     while (end > start && (str[end-1] == ' ' || str[end-1] == '\t' || str[end-1] == '\n' || str[end-1] == '\r')) end--;
@@ -712,7 +773,7 @@ static Value builtin_trim(int argCount, Value* args) {
 
 static Value builtin_upper(int argCount, Value* args) {
     if (argCount < 1 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
-    ObjString* s = (ObjString*)AS_OBJ(args[0]);
+    ObjString* s = AS_STRING(args[0]);
     char* result = malloc(s->length + 1);
     for (int i = 0; i < s->length; i++) {
         char c = s->chars[i];
@@ -727,7 +788,7 @@ static Value builtin_upper(int argCount, Value* args) {
 
 static Value builtin_lower(int argCount, Value* args) {
     if (argCount < 1 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
-    ObjString* s = (ObjString*)AS_OBJ(args[0]);
+    ObjString* s = AS_STRING(args[0]);
     char* result = malloc(s->length + 1);
     for (int i = 0; i < s->length; i++) {
         char c = s->chars[i];
@@ -744,8 +805,8 @@ static Value builtin_index_of(int argCount, Value* args) {
     if (argCount < 2) return INT_VAL(-1);
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return INT_VAL(-1);
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return INT_VAL(-1);
-    char* haystack = ((ObjString*)AS_OBJ(args[0]))->chars;
-    char* needle = ((ObjString*)AS_OBJ(args[1]))->chars;
+    char* haystack = AS_STRING(args[0])->chars;
+    char* needle = AS_STRING(args[1])->chars;
     char* found = strstr(haystack, needle);
     if (!found) return INT_VAL(-1);
     return INT_VAL((long long)(found - haystack));
@@ -756,8 +817,8 @@ static Value builtin_starts_with(int argCount, Value* args) {
     if (argCount < 2) return BOOL_VAL(false);
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return BOOL_VAL(false);
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return BOOL_VAL(false);
-    char* str = ((ObjString*)AS_OBJ(args[0]))->chars;
-    char* prefix = ((ObjString*)AS_OBJ(args[1]))->chars;
+    char* str = AS_STRING(args[0])->chars;
+    char* prefix = AS_STRING(args[1])->chars;
     return BOOL_VAL(strncmp(str, prefix, strlen(prefix)) == 0);
 }
 
@@ -766,8 +827,8 @@ static Value builtin_ends_with(int argCount, Value* args) {
     if (argCount < 2) return BOOL_VAL(false);
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return BOOL_VAL(false);
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return BOOL_VAL(false);
-    char* str = ((ObjString*)AS_OBJ(args[0]))->chars;
-    char* suffix = ((ObjString*)AS_OBJ(args[1]))->chars;
+    char* str = AS_STRING(args[0])->chars;
+    char* suffix = AS_STRING(args[1])->chars;
     int slen = strlen(str), suflen = strlen(suffix);
     if (suflen > slen) return BOOL_VAL(false);
     return BOOL_VAL(strcmp(str + slen - suflen, suffix) == 0);
@@ -777,7 +838,7 @@ static Value builtin_ends_with(int argCount, Value* args) {
 static Value builtin_repeat(int argCount, Value* args) {
     if (argCount < 2) return NULL_VAL;
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
-    ObjString* s = (ObjString*)AS_OBJ(args[0]);
+    ObjString* s = AS_STRING(args[0]);
     long long count = IS_INT(args[1]) ? AS_INT(args[1]) : 0;
     if (count <= 0) return OBJ_VAL(copy_string_value("", 0));
     if (count > 10000) count = 10000; 
@@ -796,7 +857,7 @@ static Value builtin_repeat(int argCount, Value* args) {
 static Value builtin_char_code_at(int argCount, Value* args) {
     if (argCount < 2) return INT_VAL(0);
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return INT_VAL(0);
-    ObjString* s = (ObjString*)AS_OBJ(args[0]);
+    ObjString* s = AS_STRING(args[0]);
     long long idx = IS_INT(args[1]) ? AS_INT(args[1]) : 0;
     if (idx < 0 || idx >= s->length) return INT_VAL(0);
     return INT_VAL((long long)(unsigned char)s->chars[idx]);
@@ -815,10 +876,14 @@ static Value builtin_shift(int argCount, Value* args) {
     if (argCount < 1 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_LIST) return NULL_VAL;
     ObjList* list = (ObjList*)AS_OBJ(args[0]);
     if (list->count == 0) return NULL_VAL;
-    Value first = list->items[0];
-    memmove(list->items, list->items + 1, sizeof(Value) * (list->count - 1));
-    list->count--;
-    return first;
+    return list_shift(list);
+}
+
+
+static Value builtin_unshift(int argCount, Value* args) {
+    if (argCount < 2 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_LIST) return NULL_VAL;
+    list_prepend((ObjList*)AS_OBJ(args[0]), args[1]);
+    return args[0];
 }
 
 
@@ -832,7 +897,7 @@ static Value builtin_slice(int argCount, Value* args) {
     if (start >= end) return OBJ_VAL(new_list());
     ObjList* result = new_list();
     int count = (int)(end - start);
-    result->items = malloc(sizeof(Value) * count);
+    result->items = pool_alloc(sizeof(Value) * count);
     result->capacity = count;
     result->count = count;
     memcpy(result->items, list->items + start, sizeof(Value) * count);
@@ -840,20 +905,17 @@ static Value builtin_slice(int argCount, Value* args) {
 }
 
 
-static int sort_compare(const void* a, const void* b) {
-    Value va = *(const Value*)a;
-    Value vb = *(const Value*)b;
-    if (IS_INT(va) && IS_INT(vb)) return (AS_INT(va) > AS_INT(vb)) - (AS_INT(va) < AS_INT(vb));
-    double da = IS_INT(va) ? (double)AS_INT(va) : (IS_FLOAT(va) ? AS_FLOAT(va) : 0.0);
-    double db = IS_INT(vb) ? (double)AS_INT(vb) : (IS_FLOAT(vb) ? AS_FLOAT(vb) : 0.0);
-    return (da > db) - (da < db);
+static bool is_typed_array_arg(Value value) {
+    return IS_OBJ(value) && AS_OBJ(value)->type == OBJ_TYPED_ARRAY;
 }
 
-
 static Value builtin_sort(int argCount, Value* args) {
+    if (argCount >= 1 && is_typed_array_arg(args[0])) {
+        sort_typed_array((ObjTypedArray*)AS_OBJ(args[0]));
+        return args[0];
+    }
     if (argCount < 1 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_LIST) return NULL_VAL;
-    ObjList* list = (ObjList*)AS_OBJ(args[0]);
-    if (list->count > 1) qsort(list->items, list->count, sizeof(Value), sort_compare);
+    sort_list((ObjList*)AS_OBJ(args[0]), argCount >= 2 ? args[1] : NULL_VAL);
     return args[0];
 }
 
@@ -866,6 +928,7 @@ static Value builtin_reverse(int argCount, Value* args) {
         list->items[i] = list->items[list->count - 1 - i];
         list->items[list->count - 1 - i] = tmp;
     }
+    gc_list_moved_items(list);
     return args[0];
 }
 
@@ -885,23 +948,85 @@ static Value builtin_remove(int argCount, Value* args) {
     ObjList* list = (ObjList*)AS_OBJ(args[0]);
     long long idx = IS_INT(args[1]) ? AS_INT(args[1]) : -1;
     if (idx < 0 || idx >= list->count) return NULL_VAL;
-    Value removed = list->items[idx];
-    memmove(list->items + idx, list->items + idx + 1, sizeof(Value) * (list->count - idx - 1));
-    list->count--;
-    return removed;
+    return list_remove(list, (int)idx);
+}
+
+
+static Value make_typed_array(int argCount, Value* args, TypedKind kind) {
+    if (argCount < 1) return NULL_VAL;
+    if (IS_INT(args[0])) {
+        long long count = AS_INT(args[0]);
+        if (count < 0 || count > INT32_MAX) return NULL_VAL;
+        return OBJ_VAL(new_typed_array(kind, (int)count));
+    }
+    if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_LIST) return NULL_VAL;
+    ObjTypedArray* array = typed_array_from_list((ObjList*)AS_OBJ(args[0]), kind);
+    return array ? OBJ_VAL(array) : NULL_VAL;
+}
+
+static Value builtin_int_array(int argCount, Value* args) {
+    return make_typed_array(argCount, args, TYPED_INT64);
+}
+
+static Value builtin_float_array(int argCount, Value* args) {
+    return make_typed_array(argCount, args, TYPED_FLOAT64);
+}
+
+static Value builtin_to_list(int argCount, Value* args) {
+    if (argCount < 1 || !is_typed_array_arg(args[0])) return NULL_VAL;
+    return OBJ_VAL(typed_array_to_list((ObjTypedArray*)AS_OBJ(args[0])));
+}
+
+static Value builtin_sum(int argCount, Value* args) {
+    if (argCount < 1 || !is_typed_array_arg(args[0])) return NULL_VAL;
+    return typed_array_sum((ObjTypedArray*)AS_OBJ(args[0]));
+}
+
+static Value builtin_array_max(int argCount, Value* args) {
+    if (argCount < 1 || !is_typed_array_arg(args[0])) return NULL_VAL;
+    return typed_array_max((ObjTypedArray*)AS_OBJ(args[0]));
+}
+
+static Value builtin_array_min(int argCount, Value* args) {
+    if (argCount < 1 || !is_typed_array_arg(args[0])) return NULL_VAL;
+    return typed_array_min((ObjTypedArray*)AS_OBJ(args[0]));
+}
+
+static Value builtin_dot(int argCount, Value* args) {
+    if (argCount < 2 || !is_typed_array_arg(args[0]) || !is_typed_array_arg(args[1])) return NULL_VAL;
+    return typed_array_dot((ObjTypedArray*)AS_OBJ(args[0]), (ObjTypedArray*)AS_OBJ(args[1]));
+}
+
+static Value builtin_scale(int argCount, Value* args) {
+    if (argCount < 2 || !is_typed_array_arg(args[0])) return NULL_VAL;
+    ObjTypedArray* result = typed_array_scale((ObjTypedArray*)AS_OBJ(args[0]), args[1]);
+    return result ? OBJ_VAL(result) : NULL_VAL;
+}
+
+static Value builtin_elementwise_add(int argCount, Value* args) {
+    if (argCount < 2 || !is_typed_array_arg(args[0])) return NULL_VAL;
+    ObjTypedArray* result = typed_array_add((ObjTypedArray*)AS_OBJ(args[0]), args[1]);
+    return result ? OBJ_VAL(result) : NULL_VAL;
+}
+
+static Value builtin_prefix_sum(int argCount, Value* args) {
+    if (argCount < 1 || !is_typed_array_arg(args[0])) return NULL_VAL;
+    return OBJ_VAL(typed_array_prefix_sum((ObjTypedArray*)AS_OBJ(args[0])));
+}
+
+static Value builtin_elementwise_compare(int argCount, Value* args) {
+    if (argCount < 2 || !is_typed_array_arg(args[0])) return NULL_VAL;
+    ObjTypedArray* result = typed_array_compare((ObjTypedArray*)AS_OBJ(args[0]), args[1]);
+    return result ? OBJ_VAL(result) : NULL_VAL;
 }
 
 
 typedef struct { ObjList* list; } KeysCtx;
-static void keys_callback(const char* key, void* val, void* userdata) {
+static void keys_callback(ObjString* key, Value val, void* userdata) {
     (void)val;
     KeysCtx* ctx = (KeysCtx*)userdata;
-    ObjString* s = copy_string_value(key, strlen(key));
-    if (ctx->list->count + 1 > ctx->list->capacity) {
-        ctx->list->capacity = ctx->list->capacity < 8 ? 8 : ctx->list->capacity * 2;
-        ctx->list->items = realloc(ctx->list->items, sizeof(Value) * ctx->list->capacity);
-    }
-    ctx->list->items[ctx->list->count++] = OBJ_VAL(s);
+    list_ensure_capacity(ctx->list, ctx->list->count + 1);
+    ctx->list->items[ctx->list->count++] = OBJ_VAL(key);
 }
 
 static Value builtin_keys(int argCount, Value* args) {
@@ -909,20 +1034,17 @@ static Value builtin_keys(int argCount, Value* args) {
     ObjDict* dict = (ObjDict*)AS_OBJ(args[0]);
     ObjList* list = new_list();
     KeysCtx ctx = { .list = list };
-    table_iterate(dict->items, keys_callback, &ctx);
+    value_table_iterate(&dict->items, keys_callback, &ctx);
     return OBJ_VAL(list);
 }
 
 
 typedef struct { ObjList* list; } ValuesCtx;
-static void values_callback(const char* key, void* val, void* userdata) {
+static void values_callback(ObjString* key, Value val, void* userdata) {
     (void)key;
     ValuesCtx* ctx = (ValuesCtx*)userdata;
-    if (ctx->list->count + 1 > ctx->list->capacity) {
-        ctx->list->capacity = ctx->list->capacity < 8 ? 8 : ctx->list->capacity * 2;
-        ctx->list->items = realloc(ctx->list->items, sizeof(Value) * ctx->list->capacity);
-    }
-    ctx->list->items[ctx->list->count++] = *(Value*)val;
+    list_ensure_capacity(ctx->list, ctx->list->count + 1);
+    ctx->list->items[ctx->list->count++] = val;
 }
 
 static Value builtin_values(int argCount, Value* args) {
@@ -930,18 +1052,38 @@ static Value builtin_values(int argCount, Value* args) {
     ObjDict* dict = (ObjDict*)AS_OBJ(args[0]);
     ObjList* list = new_list();
     ValuesCtx ctx = { .list = list };
-    table_iterate(dict->items, values_callback, &ctx);
+    value_table_iterate(&dict->items, values_callback, &ctx);
     return OBJ_VAL(list);
 }
 
+DictView builtin_dict_view(Value callee) {
+    if (!IS_OBJ(callee) || AS_OBJ(callee)->type != OBJ_NATIVE) return DICT_VIEW_NONE;
+    NativeFn function = ((ObjNative*)AS_OBJ(callee))->function;
+    if (function == builtin_keys) return DICT_VIEW_KEYS;
+    if (function == builtin_values) return DICT_VIEW_VALUES;
+    return DICT_VIEW_NONE;
+}
+
+ObjList* dict_view_snapshot(ObjDict* dict, DictView view, int from, int to) {
+    ValueTable* table = &dict->items;
+    if (to > table->used) to = table->used;
+    ObjList* list = new_list();
+    for (int i = from; i < to; i++) {
+        ValueEntry* entry = &table->entries[i];
+        if (entry->key == NULL) continue;
+        list_ensure_capacity(list, list->count + 1);
+        list->items[list->count++] = view == DICT_VIEW_VALUES ? entry->value : OBJ_VAL(entry->key);
+    }
+    return list;
+}
+
 
 static Value builtin_has_key(int argCount, Value* args) {
     if (argCount < 2 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_DICT) return BOOL_VAL(false);
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return BOOL_VAL(false);
     ObjDict* dict = (ObjDict*)AS_OBJ(args[0]);
-    char* key = ((ObjString*)AS_OBJ(args[1]))->chars;
-    void* val;
-    return BOOL_VAL(table_get(dict->items, key, &val));
+    Value val;
+    return BOOL_VAL(value_table_get(&dict->items, AS_STRING(args[1]), &val));
 }
 
 
@@ -949,17 +1091,14 @@ static Value builtin_dict_delete(int argCount, Value* args) {
     if (argCount < 2 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_DICT) return BOOL_VAL(false);
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return BOOL_VAL(false);
     ObjDict* dict = (ObjDict*)AS_OBJ(args[0]);
-    char* key = ((ObjString*)AS_OBJ(args[1]))->chars;
-    return BOOL_VAL(table_delete(dict->items, key));
+    return BOOL_VAL(value_table_delete(&dict->items, AS_STRING(args[1])));
 }
 
 
 typedef struct { ObjDict* dst; } MergeCtx;
-static void merge_callback(const char* key, void* val, void* userdata) {
+static void merge_callback(ObjString* key, Value val, void* userdata) {
     MergeCtx* ctx = (MergeCtx*)userdata;
-    Value* vPtr = malloc(sizeof(Value));
-    *vPtr = *(Value*)val;
-    table_set(ctx->dst->items, key, vPtr);
+    value_table_set(&ctx->dst->items, key, val);
 }
 
 static Value builtin_merge(int argCount, Value* args) {
@@ -968,9 +1107,9 @@ static Value builtin_merge(int argCount, Value* args) {
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_DICT) return args[0];
     ObjDict* result = new_dict();
     MergeCtx ctx1 = { .dst = result };
-    table_iterate(((ObjDict*)AS_OBJ(args[0]))->items, merge_callback, &ctx1);
+    value_table_iterate(&((ObjDict*)AS_OBJ(args[0]))->items, merge_callback, &ctx1);
     MergeCtx ctx2 = { .dst = result };
-    table_iterate(((ObjDict*)AS_OBJ(args[1]))->items, merge_callback, &ctx2);
+    value_table_iterate(&((ObjDict*)AS_OBJ(args[1]))->items, merge_callback, &ctx2);
     return OBJ_VAL(result);
 }
 
@@ -978,7 +1117,7 @@ static Value builtin_merge(int argCount, Value* args) {
 static Value builtin_http_get(int argCount, Value* args) {
 #ifdef _WIN32
     if (argCount < 1 || !IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
-    char* url = ((ObjString*)AS_OBJ(args[0]))->chars;
+    char* url = AS_STRING(args[0])->chars;
     char* body = winhttp_request("GET", url, NULL, 0, NULL, NULL, NULL);
     if (!body) return NULL_VAL;
     ObjString* result = copy_string_value(body, strlen(body));
@@ -996,8 +1135,8 @@ static Value builtin_http_post(int argCount, Value* args) {
     if (argCount < 2) return NULL_VAL;
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return NULL_VAL;
-    char* url = ((ObjString*)AS_OBJ(args[0]))->chars;
-    char* req_body = ((ObjString*)AS_OBJ(args[1]))->chars;
+    char* url = AS_STRING(args[0])->chars;
+    char* req_body = AS_STRING(args[1])->chars;
     char* resp = winhttp_request("POST", url, req_body, (int)strlen(req_body),
                                   "Content-Type: application/json\r\n", NULL, NULL);
     if (!resp) return NULL_VAL;
@@ -1016,16 +1155,16 @@ static Value builtin_http_request(int argCount, Value* args) {
     if (argCount < 2) return NULL_VAL;
     
     if (!IS_OBJ(args[0]) || AS_OBJ(args[0])->type != OBJ_STRING) return NULL_VAL;
-    char* method = ((ObjString*)AS_OBJ(args[0]))->chars;
+    char* method = AS_STRING(args[0])->chars;
     
     if (!IS_OBJ(args[1]) || AS_OBJ(args[1])->type != OBJ_STRING) return NULL_VAL;
-    char* url = ((ObjString*)AS_OBJ(args[1]))->chars;
+    char* url = AS_STRING(args[1])->chars;
     
     char* req_body = NULL;
     int req_body_len = 0;
     if (argCount >= 3 && IS_OBJ(args[2]) && AS_OBJ(args[2])->type == OBJ_STRING) {
-        req_body = ((ObjString*)AS_OBJ(args[2]))->chars;
-        req_body_len = ((ObjString*)AS_OBJ(args[2]))->length;
+        req_body = AS_STRING(args[2])->chars;
+        req_body_len = AS_STRING(args[2])->length;
     }
     
     char* extra_headers = NULL;
@@ -1034,19 +1173,18 @@ static Value builtin_http_request(int argCount, Value* args) {
         
         ObjList* keys = new_list();
         KeysCtx kctx = { .list = keys };
-        table_iterate(hdr_dict->items, keys_callback, &kctx);
+        value_table_iterate(&hdr_dict->items, keys_callback, &kctx);
         
         int hdr_cap = 256;
         int hdr_len = 0;
         extra_headers = malloc(hdr_cap);
         extra_headers[0] = '\0';
         for (int i = 0; i < keys->count; i++) {
-            char* key = ((ObjString*)AS_OBJ(keys->items[i]))->chars;
-            void* valPtr;
-            if (table_get(hdr_dict->items, key, &valPtr)) {
-                Value v = *(Value*)valPtr;
+            char* key = AS_STRING(keys->items[i])->chars;
+            Value v;
+            if (value_table_get(&hdr_dict->items, AS_STRING(keys->items[i]), &v)) {
                 if (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING) {
-                    char* val = ((ObjString*)AS_OBJ(v))->chars;
+                    char* val = AS_STRING(v)->chars;
                     int need = hdr_len + (int)strlen(key) + 2 + (int)strlen(val) + 3;
                     if (need > hdr_cap) {
                         hdr_cap = need + 128;
@@ -1066,31 +1204,34 @@ static Value builtin_http_request(int argCount, Value* args) {
 
     
     ObjDict* result = new_dict();
+    GcRootMark roots = gc_root_mark();
+    gc_push_root(OBJ_VAL(result));
 
     
-    Value* sPtr = malloc(sizeof(Value));
-    *sPtr = INT_VAL(status);
-    table_set(result->items, "status", sPtr);
+    value_table_set(&result->items, copy_string_value("status", 6), INT_VAL(status));
 
     
-    Value* bPtr = malloc(sizeof(Value));
+    Value body;
     if (resp_body) {
-        *bPtr = OBJ_VAL(copy_string_value(resp_body, strlen(resp_body)));
+        body = OBJ_VAL(copy_string_value(resp_body, strlen(resp_body)));
         free(resp_body);
     } else {
-        *bPtr = OBJ_VAL(copy_string_value("", 0));
+        body = OBJ_VAL(copy_string_value("", 0));
     }
-    table_set(result->items, "body", bPtr);
+    gc_push_root(body);
+    value_table_set(&result->items, copy_string_value("body", 4), body);
 
     
-    Value* hPtr = malloc(sizeof(Value));
+    Value headers;
     if (resp_headers) {
-        *hPtr = OBJ_VAL(copy_string_value(resp_headers, strlen(resp_headers)));
+        headers = OBJ_VAL(copy_string_value(resp_headers, strlen(resp_headers)));
         free(resp_headers);
     } else {
-        *hPtr = OBJ_VAL(copy_string_value("", 0));
+        headers = OBJ_VAL(copy_string_value("", 0));
     }
-    table_set(result->items, "headers", hPtr);
+    gc_push_root(headers);
+    value_table_set(&result->items, copy_string_value("headers", 7), headers);
+    gc_root_reset(roots);
 
     return OBJ_VAL(result);
 #else
@@ -1147,6 +1288,7 @@ void register_builtins(Environment* env) {
     
     env_define(env, "最後を取ってネ😘", OBJ_VAL(new_native(builtin_pop)));
     env_define(env, "最初を取ってネ😘", OBJ_VAL(new_native(builtin_shift)));
+    env_define(env, "最初に入れてネ😘", OBJ_VAL(new_native(builtin_unshift)));
     env_define(env, "切り出してネ😘", OBJ_VAL(new_native(builtin_slice)));
     env_define(env, "並べ替えてネ😘", OBJ_VAL(new_native(builtin_sort)));
     env_define(env, "逆にしてネ😘", OBJ_VAL(new_native(builtin_reverse)));
@@ -1154,6 +1296,19 @@ void register_builtins(Environment* env) {
     env_define(env, "消してネ😘", OBJ_VAL(new_native(builtin_remove)));
 
     
+    env_define(env, "整数配列にしてネ😘", OBJ_VAL(new_native(builtin_int_array)));
+    env_define(env, "小数配列にしてネ😘", OBJ_VAL(new_native(builtin_float_array)));
+    env_define(env, "配列に戻してネ😘", OBJ_VAL(new_native(builtin_to_list)));
+    env_define(env, "合計してネ😘", OBJ_VAL(new_native(builtin_sum)));
+    env_define(env, "一番大きいノ😃", OBJ_VAL(new_native(builtin_array_max)));
+    env_define(env, "一番小さいノ😃", OBJ_VAL(new_native(builtin_array_min)));
+    env_define(env, "内積してネ😘", OBJ_VAL(new_native(builtin_dot)));
+    env_define(env, "倍にしてネ😘", OBJ_VAL(new_native(builtin_scale)));
+    env_define(env, "足し合わせてネ😘", OBJ_VAL(new_native(builtin_elementwise_add)));
+    env_define(env, "累積和にしてネ😘", OBJ_VAL(new_native(builtin_prefix_sum)));
+    env_define(env, "比べてネ😘", OBJ_VAL(new_native(builtin_elementwise_compare)));
+
+    
     env_define(env, "キー一覧ダヨ😎", OBJ_VAL(new_native(builtin_keys)));
     env_define(env, "値一覧ダヨ😎", OBJ_VAL(new_native(builtin_values)));
     env_define(env, "持ってるヨ😃", OBJ_VAL(new_native(builtin_has_key)));
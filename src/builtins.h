@@ -2,7 +2,26 @@
 #define OJISAN_BUILTINS_H
 
 #include "env.h"
+#include "error.h"
+#include <stddef.h>
 
 void register_builtins(Environment* env);
 
+typedef enum {
+    DICT_VIEW_NONE,
+    DICT_VIEW_KEYS,
+    DICT_VIEW_VALUES
+} DictView;
+
+DictView builtin_dict_view(Value callee);
+ObjList* dict_view_snapshot(ObjDict* dict, DictView view, int from, int to);
+
+
+typedef bool (*NativeCallHook)(Value callee, int argCount, Value* args, Value* out);
+void builtins_set_call_hook(NativeCallHook hook);
+bool builtins_call(Value callee, int argCount, Value* args, Value* out);
+bool builtins_take_failure(void);
+void builtins_raise(ErrorType type, const char* message);
+bool builtins_take_error(ErrorType* type, char* message, size_t size);
+
 #endif 
@@ -0,0 +1,283 @@
+#include "chunk.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+Chunk* chunk_new(void) {
+    Chunk* chunk = malloc(sizeof(Chunk));
+    chunk->count = 0;
+    chunk->capacity = 0;
+    chunk->code = NULL;
+    chunk->lines = NULL;
+    chunk->const_count = 0;
+    chunk->const_capacity = 0;
+    chunk->constants = NULL;
+    chunk->cache_count = 0;
+    chunk->cache_capacity = 0;
+    chunk->caches = NULL;
+    return chunk;
+}
+
+void chunk_free(Chunk* chunk) {
+    if (!chunk) return;
+    free(chunk->code);
+    free(chunk->lines);
+    free(chunk->constants);
+    free(chunk->caches);
+    free(chunk);
+}
+
+void chunk_write(Chunk* chunk, uint8_t byte, int line) {
+    if (chunk->count + 1 > chunk->capacity) {
+        chunk->capacity = chunk->capacity < 8 ? 8 : chunk->capacity * 2;
+        chunk->code = realloc(chunk->code, sizeof(uint8_t) * chunk->capacity);
+        chunk->lines = realloc(chunk->lines, sizeof(int) * chunk->capacity);
+    }
+    chunk->code[chunk->count] = byte;
+    chunk->lines[chunk->count] = line;
+    chunk->count++;
+}
+
+int chunk_add_constant(Chunk* chunk, Value value) {
+    if (chunk->const_count + 1 > chunk->const_capacity) {
+        chunk->const_capacity = chunk->const_capacity < 8 ? 8 : chunk->const_capacity * 2;
+        chunk->constants = realloc(chunk->constants, sizeof(Value) * chunk->const_capacity);
+    }
+    chunk->constants[chunk->const_count] = value;
+    return chunk->const_count++;
+}
+
+int chunk_add_cache(Chunk* chunk) {
+    if (chunk->cache_count + 1 > chunk->cache_capacity) {
+        chunk->cache_capacity = chunk->cache_capacity < 8 ? 8 : chunk->cache_capacity * 2;
+        chunk->caches = realloc(chunk->caches, sizeof(InlineCache) * chunk->cache_capacity);
+    }
+    chunk->caches[chunk->cache_count].count = 0;
+    return chunk->cache_count++;
+}
+
+
+static const char* op_names[] = {
+    "CONSTANT", "NULL", "TRUE", "FALSE", "POP",
+    "GET_LOCAL", "SET_LOCAL", "GET_UPVALUE", "SET_UPVALUE",
+    "DEFINE_GLOBAL", "GET_GLOBAL", "SET_GLOBAL",
+    "GET_PROPERTY", "SET_PROPERTY", "GET_INDEX", "SET_INDEX",
+    "ADD", "SUBTRACT", "MULTIPLY", "DIVIDE", "MODULO",
+    "EQUAL", "NOT_EQUAL", "GREATER", "LESS", "GREATER_EQUAL", "LESS_EQUAL",
+    "NEGATE", "NOT", "TRUTHY", "PRINT", "PRINTLN",
+    "JUMP", "JUMP_IF_FALSE", "LOOP", "CALL", "INVOKE",
+    "CLOSURE", "CLOSE_UPVALUE", "RETURN",
+    "CLASS", "METHOD", "CONSTRUCTOR", "NEW",
+    "LIST_NEW", "LIST_APPEND", "DICT_NEW", "DICT_ADD", "APPEND",
+    "RANGE_INIT", "RANGE_NEXT", "RANGE_STEP", "ITER_INIT", "ITER_VIEW", "ITER_NEXT",
+    "TRY", "TRY_END", "IMPORT", "RAISE", "FAIL"
+};
+
+static int read_u16(Chunk* chunk, int offset) {
+    return (chunk->code[offset] << 8) | chunk->code[offset + 1];
+}
+
+static int disassemble_instruction(Chunk* chunk, int offset) {
+    uint8_t op = chunk->code[offset];
+    printf("%04d %4d %-14s", offset, chunk->lines[offset], op_names[op]);
+    switch (op) {
+        case OP_GET_PROPERTY:
+        case OP_SET_PROPERTY: {
+            int idx = read_u16(chunk, offset + 1);
+            printf(" %d '", idx);
+            value_print(chunk->constants[idx]);
+            printf("' ic#%d\n", read_u16(chunk, offset + 3));
+            return offset + 5;
+        }
+        case OP_CONSTANT:
+        case OP_DEFINE_GLOBAL:
+        case OP_GET_GLOBAL:
+        case OP_SET_GLOBAL:
+        case OP_CLASS:
+        case OP_METHOD:
+        case OP_APPEND:
+        case OP_IMPORT: {
+            int idx = read_u16(chunk, offset + 1);
+            printf(" %d '", idx);
+            value_print(chunk->constants[idx]);
+            printf("'\n");
+            return offset + 3;
+        }
+        case OP_GET_LOCAL:
+        case OP_SET_LOCAL:
+        case OP_GET_UPVALUE:
+        case OP_SET_UPVALUE:
+        case OP_CALL:
+        case OP_RANGE_STEP:
+            printf(" %d\n", chunk->code[offset + 1]);
+            return offset + 2;
+        case OP_JUMP:
+        case OP_JUMP_IF_FALSE:
+        case OP_ITER_VIEW:
+        case OP_TRY:
+            printf(" -> %d\n", offset + 3 + read_u16(chunk, offset + 1));
+            return offset + 3;
+        case OP_LOOP:
+            printf(" -> %d\n", offset + 3 - read_u16(chunk, offset + 1));
+            return offset + 3;
+        case OP_RANGE_NEXT:
+        case OP_ITER_NEXT:
+            printf(" %d -> %d\n", chunk->code[offset + 1], offset + 4 + read_u16(chunk, offset + 2));
+            return offset + 4;
+        case OP_INVOKE: {
+            int idx = read_u16(chunk, offset + 1);
+            printf(" (%d args) '", chunk->code[offset + 3]);
+            value_print(chunk->constants[idx]);
+            printf("' ic#%d\n", read_u16(chunk, offset + 4));
+            return offset + 6;
+        }
+        case OP_NEW: {
+            int idx = read_u16(chunk, offset + 1);
+            printf(" (%d args) '", chunk->code[offset + 3]);
+            value_print(chunk->constants[idx]);
+            printf("'\n");
+            return offset + 4;
+        }
+        case OP_RAISE: {
+            int idx = read_u16(chunk, offset + 2);
+            printf(" %d '", chunk->code[offset + 1]);
+            value_print(chunk->constants[idx]);
+            printf("'\n");
+            return offset + 4;
+        }
+        case OP_CLOSURE: {
+            int idx = read_u16(chunk, offset + 1);
+            ObjFunc* fn = (ObjFunc*)AS_OBJ(chunk->constants[idx]);
+            printf(" %d ", idx);
+            value_print(chunk->constants[idx]);
+            printf("\n");
+            offset += 3;
+            for (int i = 0; i < fn->upvalue_count; i++) {
+                int is_local = chunk->code[offset++];
+                int index = chunk->code[offset++];
+                printf("%04d    |                 %s %d\n", offset - 2, is_local ? "local" : "upvalue", index);
+            }
+            return offset;
+        }
+        default:
+            printf("\n");
+            return offset + 1;
+    }
+}
+
+static bool constant_is(Chunk* chunk, int idx, ObjType type) {
+    if (idx >= chunk->const_count) return false;
+    Value value = chunk->constants[idx];
+    return IS_OBJ(value) && AS_OBJ(value)->type == type;
+}
+
+static int instruction_length(Chunk* chunk, int offset, int upvalue_count, int* target) {
+    uint8_t op = chunk->code[offset];
+    int remaining = chunk->count - offset;
+    *target = -1;
+    switch (op) {
+        case OP_GET_PROPERTY:
+        case OP_SET_PROPERTY:
+            if (remaining < 5 || !constant_is(chunk, read_u16(chunk, offset + 1), OBJ_STRING)) return -1;
+            return read_u16(chunk, offset + 3) < chunk->cache_count ? 5 : -1;
+        case OP_INVOKE:
+            if (remaining < 6 || !constant_is(chunk, read_u16(chunk, offset + 1), OBJ_STRING)) return -1;
+            return read_u16(chunk, offset + 4) < chunk->cache_count ? 6 : -1;
+        case OP_CONSTANT:
+            if (remaining < 3) return -1;
+            return read_u16(chunk, offset + 1) < chunk->const_count ? 3 : -1;
+        case OP_DEFINE_GLOBAL:
+        case OP_GET_GLOBAL:
+        case OP_SET_GLOBAL:
+        case OP_CLASS:
+        case OP_METHOD:
+        case OP_APPEND:
+        case OP_IMPORT:
+            if (remaining < 3) return -1;
+            return constant_is(chunk, read_u16(chunk, offset + 1), OBJ_STRING) ? 3 : -1;
+        case OP_NEW:
+            if (remaining < 4) return -1;
+            return constant_is(chunk, read_u16(chunk, offset + 1), OBJ_STRING) ? 4 : -1;
+        case OP_RAISE:
+            if (remaining < 4) return -1;
+            return constant_is(chunk, read_u16(chunk, offset + 2), OBJ_STRING) ? 4 : -1;
+        case OP_GET_UPVALUE:
+        case OP_SET_UPVALUE:
+            if (remaining < 2) return -1;
+            return chunk->code[offset + 1] < upvalue_count ? 2 : -1;
+        case OP_GET_LOCAL:
+        case OP_SET_LOCAL:
+        case OP_CALL:
+        case OP_RANGE_STEP:
+            return remaining < 2 ? -1 : 2;
+        case OP_JUMP:
+        case OP_JUMP_IF_FALSE:
+        case OP_ITER_VIEW:
+        case OP_TRY:
+            if (remaining < 3) return -1;
+            *target = offset + 3 + read_u16(chunk, offset + 1);
+            return 3;
+        case OP_LOOP:
+            if (remaining < 3) return -1;
+            *target = offset + 3 - read_u16(chunk, offset + 1);
+            return *target >= 0 ? 3 : -1;
+        case OP_RANGE_NEXT:
+        case OP_ITER_NEXT:
+            if (remaining < 4) return -1;
+            *target = offset + 4 + read_u16(chunk, offset + 2);
+            return 4;
+        case OP_CLOSURE: {
+            if (remaining < 3) return -1;
+            int idx = read_u16(chunk, offset + 1);
+            if (!constant_is(chunk, idx, OBJ_FUNC)) return -1;
+            ObjFunc* fn = (ObjFunc*)AS_OBJ(chunk->constants[idx]);
+            if (fn->chunk == NULL || remaining < 3 + 2 * fn->upvalue_count) return -1;
+            for (int i = 0; i < fn->upvalue_count; i++) {
+                uint8_t is_local = chunk->code[offset + 3 + 2 * i];
+                uint8_t index = chunk->code[offset + 4 + 2 * i];
+                if (is_local > 1 || (!is_local && index >= upvalue_count)) return -1;
+            }
+            return 3 + 2 * fn->upvalue_count;
+        }
+        default:
+            return op <= OP_FAIL ? 1 : -1;
+    }
+}
+
+bool chunk_verify(Chunk* chunk, int upvalue_count) {
+    if (chunk->count == 0) return false;
+    bool* starts = calloc((size_t)chunk->count, sizeof(bool));
+    bool ok = true;
+    int offset = 0;
+    int last = 0;
+    while (ok && offset < chunk->count) {
+        int target;
+        starts[offset] = true;
+        last = offset;
+        int length = instruction_length(chunk, offset, upvalue_count, &target);
+        ok = length > 0;
+        offset += ok ? length : 0;
+    }
+    ok = ok && chunk->code[last] == OP_RETURN;
+    for (offset = 0; ok && offset < chunk->count; ) {
+        int target;
+        int length = instruction_length(chunk, offset, upvalue_count, &target);
+        ok = target < 0 || (target < chunk->count && starts[target]);
+        offset += length;
+    }
+    free(starts);
+    return ok;
+}
+
+void chunk_disassemble(Chunk* chunk, const char* name) {
+    printf("== %s ==\n", name ? name : "<script>");
+    for (int offset = 0; offset < chunk->count; ) {
+        offset = disassemble_instruction(chunk, offset);
+    }
+    for (int i = 0; i < chunk->const_count; i++) {
+        Value c = chunk->constants[i];
+        if (IS_OBJ(c) && AS_OBJ(c)->type == OBJ_FUNC) {
+            ObjFunc* fn = (ObjFunc*)AS_OBJ(c);
+            if (fn->chunk) chunk_disassemble(fn->chunk, fn->name);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef OJISAN_CHUNK_H
+#define OJISAN_CHUNK_H
+
+#include <stdint.h>
+#include "value.h"
+#include "shape.h"
+
+typedef enum {
+    OP_CONSTANT,
+    OP_NULL,
+    OP_TRUE,
+    OP_FALSE,
+    OP_POP,
+    OP_GET_LOCAL,
+    OP_SET_LOCAL,
+    OP_GET_UPVALUE,
+    OP_SET_UPVALUE,
+    OP_DEFINE_GLOBAL,
+    OP_GET_GLOBAL,
+    OP_SET_GLOBAL,
+    OP_GET_PROPERTY,
+    OP_SET_PROPERTY,
+    OP_GET_INDEX,
+    OP_SET_INDEX,
+    OP_ADD,
+    OP_SUBTRACT,
+    OP_MULTIPLY,
+    OP_DIVIDE,
+    OP_MODULO,
+    OP_EQUAL,
+    OP_NOT_EQUAL,
+    OP_GREATER,
+    OP_LESS,
+    OP_GREATER_EQUAL,
+    OP_LESS_EQUAL,
+    OP_NEGATE,
+    OP_NOT,
+    OP_TRUTHY,
+    OP_PRINT,
+    OP_PRINTLN,
+    OP_JUMP,
+    OP_JUMP_IF_FALSE,
+    OP_LOOP,
+    OP_CALL,
+    OP_INVOKE,
+    OP_CLOSURE,
+    OP_CLOSE_UPVALUE,
+    OP_RETURN,
+    OP_CLASS,
+    OP_METHOD,
+    OP_CONSTRUCTOR,
+    OP_NEW,
+    OP_LIST_NEW,
+    OP_LIST_APPEND,
+    OP_DICT_NEW,
+    OP_DICT_ADD,
+    OP_APPEND,
+    OP_RANGE_INIT,
+    OP_RANGE_NEXT,
+    OP_RANGE_STEP,
+    OP_ITER_INIT,
+    OP_ITER_VIEW,
+    OP_ITER_NEXT,
+    OP_TRY,
+    OP_TRY_END,
+    OP_IMPORT,
+    OP_RAISE,
+    OP_FAIL
+} OpCode;
+
+struct Chunk {
+    int count;
+    int capacity;
+    uint8_t* code;
+    int* lines;
+    int const_count;
+    int const_capacity;
+    Value* constants;
+    int cache_count;
+    int cache_capacity;
+    InlineCache* caches;
+};
+
+Chunk* chunk_new(void);
+void chunk_free(Chunk* chunk);
+void chunk_write(Chunk* chunk, uint8_t byte, int line);
+int chunk_add_constant(Chunk* chunk, Value value);
+int chunk_add_cache(Chunk* chunk);
+bool chunk_verify(Chunk* chunk, int upvalue_count);
+void chunk_disassemble(Chunk* chunk, const char* name);
+
+#endif 
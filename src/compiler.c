@@ -0,0 +1,867 @@
+#include "compiler.h"
+#include "chunk.h"
+#include "error.h"
+#include "gc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LOCALS 256
+#define MAX_UPVALUES 256
+
+typedef struct {
+    const char* name;
+    int depth;
+    bool is_captured;
+} Local;
+
+typedef struct {
+    uint8_t index;
+    bool is_local;
+} UpvalueRef;
+
+typedef enum {
+    FN_SCRIPT,
+    FN_FUNCTION,
+    FN_METHOD,
+    FN_CONSTRUCTOR
+} FunctionKind;
+
+typedef struct {
+    int count;
+    int capacity;
+    int* offsets;
+} JumpList;
+
+typedef struct TryScope {
+    struct TryScope* enclosing;
+    AstNode* finally_block;
+    bool handler_active;
+} TryScope;
+
+typedef struct Loop {
+    struct Loop* enclosing;
+    int scope_depth;
+    TryScope* try_scope;
+    int continue_target;
+    JumpList breaks;
+    JumpList continues;
+} Loop;
+
+typedef struct Compiler {
+    struct Compiler* enclosing;
+    ObjFunc* function;
+    FunctionKind kind;
+    Local locals[MAX_LOCALS];
+    int local_count;
+    UpvalueRef upvalues[MAX_UPVALUES];
+    int scope_depth;
+    Loop* loop;
+    TryScope* try_scope;
+} Compiler;
+
+static Compiler* current = NULL;
+static int current_line = 0;
+static bool had_error = false;
+
+static void compile_statement(AstNode* node);
+static void compile_expression(AstNode* node);
+static void compile_block(AstNode* node);
+
+static void compile_error(const char* message) {
+    if (had_error) return;
+    had_error = true;
+    error_report(ERR_SYNTAX, current_line, "%s", message);
+}
+
+static Chunk* current_chunk(void) {
+    return current->function->chunk;
+}
+
+static void emit_byte(uint8_t byte) {
+    chunk_write(current_chunk(), byte, current_line);
+}
+
+static void emit_bytes(uint8_t a, uint8_t b) {
+    emit_byte(a);
+    emit_byte(b);
+}
+
+static void emit_short(int value) {
+    emit_byte((value >> 8) & 0xff);
+    emit_byte(value & 0xff);
+}
+
+static int make_constant(Value value) {
+    gc_write_barrier(&current->function->obj, value);
+    int index = chunk_add_constant(current_chunk(), value);
+    if (index > UINT16_MAX) {
+        compile_error("定数が多すぎるヨ😱💦");
+        return 0;
+    }
+    return index;
+}
+
+static int identifier_constant(const char* name) {
+    Chunk* chunk = current_chunk();
+    ObjString* string = copy_string_value(name, (int)strlen(name));
+    for (int i = 0; i < chunk->const_count; i++) {
+        Value v = chunk->constants[i];
+        if (IS_OBJ(v) && AS_OBJ(v) == (Obj*)string) return i;
+    }
+    return make_constant(OBJ_VAL(string));
+}
+
+static void emit_constant(Value value) {
+    emit_byte(OP_CONSTANT);
+    emit_short(make_constant(value));
+}
+
+static void emit_raise(ErrorType type, const char* message) {
+    int msg = make_constant(OBJ_VAL(copy_string_value(message, strlen(message))));
+    emit_bytes(OP_RAISE, (uint8_t)type);
+    emit_short(msg);
+}
+
+static int emit_jump(uint8_t instruction) {
+    emit_byte(instruction);
+    emit_byte(0xff);
+    emit_byte(0xff);
+    return current_chunk()->count - 2;
+}
+
+static void patch_jump(int offset) {
+    int jump = current_chunk()->count - offset - 2;
+    if (jump > UINT16_MAX) {
+        compile_error("ジャンプが遠すぎるヨ😱💦");
+        return;
+    }
+    current_chunk()->code[offset] = (jump >> 8) & 0xff;
+    current_chunk()->code[offset + 1] = jump & 0xff;
+}
+
+static void emit_loop(int loop_start) {
+    emit_byte(OP_LOOP);
+    int offset = current_chunk()->count - loop_start + 2;
+    if (offset > UINT16_MAX) compile_error("ループが大きすぎるヨ😱💦");
+    emit_short(offset);
+}
+
+static void emit_return(void) {
+    if (current->kind == FN_CONSTRUCTOR) {
+        emit_bytes(OP_GET_LOCAL, 0);
+    } else {
+        emit_byte(OP_NULL);
+    }
+    emit_byte(OP_RETURN);
+}
+
+static void jump_list_add(JumpList* list, int offset) {
+    if (list->count + 1 > list->capacity) {
+        list->capacity = list->capacity < 8 ? 8 : list->capacity * 2;
+        list->offsets = realloc(list->offsets, sizeof(int) * list->capacity);
+    }
+    list->offsets[list->count++] = offset;
+}
+
+static void jump_list_patch(JumpList* list) {
+    for (int i = 0; i < list->count; i++) patch_jump(list->offsets[i]);
+    free(list->offsets);
+    list->offsets = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+
+static void init_compiler(Compiler* compiler, FunctionKind kind, const char* name, int arity) {
+    compiler->enclosing = current;
+    compiler->function = NULL;
+    compiler->kind = kind;
+    compiler->local_count = 0;
+    compiler->scope_depth = 0;
+    compiler->loop = NULL;
+    compiler->try_scope = NULL;
+    current = compiler;
+    compiler->function = new_compiled_function(name, arity);
+
+    Local* local = &compiler->locals[compiler->local_count++];
+    local->depth = 0;
+    local->is_captured = false;
+    local->name = (kind == FN_METHOD || kind == FN_CONSTRUCTOR) ? "this" : NULL;
+}
+
+static ObjFunc* end_compiler(void) {
+    emit_return();
+    ObjFunc* function = current->function;
+    current = current->enclosing;
+    return function;
+}
+
+static void begin_scope(void) {
+    current->scope_depth++;
+}
+
+static void end_scope(void) {
+    current->scope_depth--;
+    while (current->local_count > 0 &&
+           current->locals[current->local_count - 1].depth > current->scope_depth) {
+        emit_byte(current->locals[current->local_count - 1].is_captured ? OP_CLOSE_UPVALUE : OP_POP);
+        current->local_count--;
+    }
+}
+
+static void discard_locals(int depth) {
+    for (int i = current->local_count - 1; i >= 0 && current->locals[i].depth > depth; i--) {
+        emit_byte(current->locals[i].is_captured ? OP_CLOSE_UPVALUE : OP_POP);
+    }
+}
+
+static int add_local(const char* name) {
+    if (current->local_count == MAX_LOCALS) {
+        compile_error("ローカル変数が多すぎるヨ😱💦");
+        return 0;
+    }
+    Local* local = &current->locals[current->local_count];
+    local->name = name;
+    local->depth = current->scope_depth;
+    local->is_captured = false;
+    return current->local_count++;
+}
+
+static int resolve_local(Compiler* compiler, const char* name) {
+    for (int i = compiler->local_count - 1; i >= 0; i--) {
+        Local* local = &compiler->locals[i];
+        if (local->name && strcmp(local->name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static int find_local_in_scope(const char* name) {
+    for (int i = current->local_count - 1; i >= 0; i--) {
+        Local* local = &current->locals[i];
+        if (local->depth < current->scope_depth) break;
+        if (local->name && strcmp(local->name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static int add_upvalue(Compiler* compiler, uint8_t index, bool is_local) {
+    int count = compiler->function->upvalue_count;
+    for (int i = 0; i < count; i++) {
+        UpvalueRef* up = &compiler->upvalues[i];
+        if (up->index == index && up->is_local == is_local) return i;
+    }
+    if (count == MAX_UPVALUES) {
+        compile_error("クロージャの変数が多すぎるヨ😱💦");
+        return 0;
+    }
+    compiler->upvalues[count].is_local = is_local;
+    compiler->upvalues[count].index = index;
+    return compiler->function->upvalue_count++;
+}
+
+static int resolve_upvalue(Compiler* compiler, const char* name) {
+    if (compiler->enclosing == NULL) return -1;
+
+    int local = resolve_local(compiler->enclosing, name);
+    if (local != -1) {
+        compiler->enclosing->locals[local].is_captured = true;
+        return add_upvalue(compiler, (uint8_t)local, true);
+    }
+
+    int upvalue = resolve_upvalue(compiler->enclosing, name);
+    if (upvalue != -1) {
+        return add_upvalue(compiler, (uint8_t)upvalue, false);
+    }
+    return -1;
+}
+
+static void emit_get_variable(const char* name) {
+    int arg = resolve_local(current, name);
+    if (arg != -1) {
+        emit_bytes(OP_GET_LOCAL, (uint8_t)arg);
+    } else if ((arg = resolve_upvalue(current, name)) != -1) {
+        emit_bytes(OP_GET_UPVALUE, (uint8_t)arg);
+    } else {
+        emit_byte(OP_GET_GLOBAL);
+        emit_short(identifier_constant(name));
+    }
+}
+
+static void emit_set_variable(const char* name) {
+    int arg = resolve_local(current, name);
+    if (arg != -1) {
+        emit_bytes(OP_SET_LOCAL, (uint8_t)arg);
+    } else if ((arg = resolve_upvalue(current, name)) != -1) {
+        emit_bytes(OP_SET_UPVALUE, (uint8_t)arg);
+    } else {
+        emit_byte(OP_SET_GLOBAL);
+        emit_short(identifier_constant(name));
+    }
+}
+
+
+static void define_variable(const char* name) {
+    if (current->scope_depth == 0) {
+        emit_byte(OP_DEFINE_GLOBAL);
+        emit_short(identifier_constant(name));
+        return;
+    }
+    int slot = find_local_in_scope(name);
+    if (slot != -1) {
+        emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+        emit_byte(OP_POP);
+        return;
+    }
+    add_local(name);
+}
+
+static void hoist_declarations(AstNode* block) {
+    for (int i = 0; i < block->as.block.stmt_count; i++) {
+        AstNode* stmt = block->as.block.stmts[i];
+        const char* name = NULL;
+        if (!stmt) continue;
+        if (stmt->type == AST_FUNC_DECL) name = stmt->as.func_decl.name;
+        else if (stmt->type == AST_CLASS_DECL) name = stmt->as.class_decl.name;
+        if (name && find_local_in_scope(name) == -1) {
+            emit_byte(OP_NULL);
+            add_local(name);
+        }
+    }
+}
+
+
+static void unwind_try_scopes(TryScope* until) {
+    TryScope* saved = current->try_scope;
+    for (TryScope* ts = saved; ts != until; ts = ts->enclosing) {
+        if (ts->handler_active) emit_byte(OP_TRY_END);
+        if (ts->finally_block) {
+            current->try_scope = ts->enclosing;
+            compile_block(ts->finally_block);
+        }
+    }
+    current->try_scope = saved;
+}
+
+static void emit_function_return(void) {
+    unwind_try_scopes(NULL);
+    if (current->kind == FN_CONSTRUCTOR) {
+        emit_byte(OP_POP);
+        emit_bytes(OP_GET_LOCAL, 0);
+    }
+    emit_byte(OP_RETURN);
+}
+
+static void compile_function(AstNode* decl, FunctionKind kind) {
+    Compiler compiler;
+    int param_count = decl->as.func_decl.param_count;
+    init_compiler(&compiler, kind, decl->as.func_decl.name, param_count);
+    current_line = decl->line;
+    if (param_count > UINT8_MAX) compile_error("引数が多すぎるヨ😱💦");
+
+    begin_scope();
+    for (int i = 0; i < param_count; i++) {
+        add_local(decl->as.func_decl.params[i]);
+    }
+    compile_block(decl->as.func_decl.body);
+
+    ObjFunc* function = end_compiler();
+    current_line = decl->line;
+    emit_byte(OP_CLOSURE);
+    emit_short(make_constant(OBJ_VAL(function)));
+    for (int i = 0; i < function->upvalue_count; i++) {
+        emit_byte(compiler.upvalues[i].is_local ? 1 : 0);
+        emit_byte(compiler.upvalues[i].index);
+    }
+}
+
+static int compile_arguments(int count, AstNode** args) {
+    if (count > UINT8_MAX) compile_error("引数が多すぎるヨ😱💦");
+    for (int i = 0; i < count; i++) compile_expression(args[i]);
+    return count;
+}
+
+
+static void compile_binary(AstNode* node) {
+    TokenType op = node->as.binary.op;
+
+    if (op == TOK_SHIKAMO || op == TOK_MOSHIKUWA) {
+        compile_expression(node->as.binary.left);
+        emit_byte(OP_TRUTHY);
+        int short_circuit;
+        if (op == TOK_SHIKAMO) {
+            short_circuit = emit_jump(OP_JUMP_IF_FALSE);
+        } else {
+            int else_jump = emit_jump(OP_JUMP_IF_FALSE);
+            short_circuit = emit_jump(OP_JUMP);
+            patch_jump(else_jump);
+        }
+        emit_byte(OP_POP);
+        compile_expression(node->as.binary.right);
+        emit_byte(OP_TRUTHY);
+        patch_jump(short_circuit);
+        return;
+    }
+
+    compile_expression(node->as.binary.left);
+    compile_expression(node->as.binary.right);
+    current_line = node->line;
+    switch (op) {
+        case TOK_TO:          emit_byte(OP_ADD); break;
+        case TOK_HIKU:        emit_byte(OP_SUBTRACT); break;
+        case TOK_KAKERU:      emit_byte(OP_MULTIPLY); break;
+        case TOK_WARU:        emit_byte(OP_DIVIDE); break;
+        case TOK_AMARI:       emit_byte(OP_MODULO); break;
+        case TOK_ONAJI_KANA:  emit_byte(OP_EQUAL); break;
+        case TOK_CHIGAU_KANA: emit_byte(OP_NOT_EQUAL); break;
+        case TOK_YORI_UE:     emit_byte(OP_GREATER); break;
+        case TOK_YORI_SHITA:  emit_byte(OP_LESS); break;
+        case TOK_IJOU:        emit_byte(OP_GREATER_EQUAL); break;
+        case TOK_IKA:         emit_byte(OP_LESS_EQUAL); break;
+        default:
+            emit_byte(OP_POP);
+            emit_byte(OP_POP);
+            emit_raise(ERR_RUNTIME, "式の評価に失敗したヨ😅💦");
+            emit_byte(OP_NULL);
+            break;
+    }
+}
+
+static void compile_expression(AstNode* node) {
+    if (!node) {
+        emit_byte(OP_FAIL);
+        emit_byte(OP_NULL);
+        return;
+    }
+    current_line = node->line;
+
+    switch (node->type) {
+        case AST_LITERAL:
+            switch (node->as.literal.type) {
+                case LIT_INT: emit_constant(INT_VAL(node->as.literal.i_val)); break;
+                case LIT_FLOAT: emit_constant(FLOAT_VAL(node->as.literal.f_val)); break;
+                case LIT_STR:
+                    emit_constant(OBJ_VAL(copy_string_value(node->as.literal.s_val, strlen(node->as.literal.s_val))));
+                    break;
+                case LIT_BOOL: emit_byte(node->as.literal.b_val ? OP_TRUE : OP_FALSE); break;
+                case LIT_NULL: emit_byte(OP_NULL); break;
+            }
+            break;
+        case AST_BINARY:
+            compile_binary(node);
+            break;
+        case AST_UNARY:
+            compile_expression(node->as.unary.operand);
+            current_line = node->line;
+            if (node->as.unary.op == TOK_MAINASU) {
+                emit_byte(OP_NEGATE);
+            } else if (node->as.unary.op == TOK_CHIGAU_YO) {
+                emit_byte(OP_NOT);
+            } else {
+                emit_byte(OP_POP);
+                emit_raise(ERR_RUNTIME, "式の評価に失敗したヨ😅💦");
+                emit_byte(OP_NULL);
+            }
+            break;
+        case AST_VARIABLE:
+            emit_get_variable(node->as.variable.name);
+            break;
+        case AST_ASSIGNMENT:
+            compile_expression(node->as.assignment.value);
+            current_line = node->line;
+            emit_set_variable(node->as.assignment.name);
+            break;
+        case AST_THIS:
+            if (resolve_local(current, "this") != -1 || resolve_upvalue(current, "this") != -1) {
+                emit_get_variable("this");
+            } else {
+                emit_raise(ERR_RUNTIME, "ここはクラスの中じゃないヨ😅💦");
+                emit_byte(OP_NULL);
+            }
+            break;
+        case AST_GET:
+            compile_expression(node->as.get.object);
+            current_line = node->line;
+            emit_byte(OP_GET_PROPERTY);
+            emit_short(identifier_constant(node->as.get.name));
+            emit_short(chunk_add_cache(current_chunk()));
+            break;
+        case AST_SET:
+            compile_expression(node->as.set.object);
+            compile_expression(node->as.set.value);
+            current_line = node->line;
+            emit_byte(OP_SET_PROPERTY);
+            emit_short(identifier_constant(node->as.set.name));
+            emit_short(chunk_add_cache(current_chunk()));
+            break;
+        case AST_INDEX_GET:
+            compile_expression(node->as.index_get.object);
+            compile_expression(node->as.index_get.index);
+            current_line = node->line;
+            emit_byte(OP_GET_INDEX);
+            break;
+        case AST_INDEX_SET:
+            compile_expression(node->as.index_set.object);
+            compile_expression(node->as.index_set.index);
+            compile_expression(node->as.index_set.value);
+            current_line = node->line;
+            emit_byte(OP_SET_INDEX);
+            break;
+        case AST_ARRAY_LITERAL:
+            emit_byte(OP_LIST_NEW);
+            for (int i = 0; i < node->as.array_literal.count; i++) {
+                compile_expression(node->as.array_literal.elements[i]);
+                emit_byte(OP_LIST_APPEND);
+            }
+            break;
+        case AST_DICT_LITERAL:
+            emit_byte(OP_DICT_NEW);
+            for (int i = 0; i < node->as.dict_literal.count; i++) {
+                compile_expression(node->as.dict_literal.keys[i]);
+                compile_expression(node->as.dict_literal.values[i]);
+                current_line = node->line;
+                emit_byte(OP_DICT_ADD);
+            }
+            break;
+        case AST_CALL: {
+            AstNode* callee = node->as.call.callee;
+            if (callee && callee->type == AST_GET) {
+                compile_expression(callee->as.get.object);
+                int argc = compile_arguments(node->as.call.arg_count, node->as.call.args);
+                current_line = node->line;
+                emit_byte(OP_INVOKE);
+                emit_short(identifier_constant(callee->as.get.name));
+                emit_byte((uint8_t)argc);
+                emit_short(chunk_add_cache(current_chunk()));
+            } else {
+                compile_expression(callee);
+                int argc = compile_arguments(node->as.call.arg_count, node->as.call.args);
+                current_line = node->line;
+                emit_bytes(OP_CALL, (uint8_t)argc);
+            }
+            break;
+        }
+        case AST_NEW: {
+            emit_get_variable(node->as.new_expr.class_name);
+            int argc = compile_arguments(node->as.new_expr.arg_count, node->as.new_expr.args);
+            current_line = node->line;
+            emit_byte(OP_NEW);
+            emit_short(identifier_constant(node->as.new_expr.class_name));
+            emit_byte((uint8_t)argc);
+            break;
+        }
+        default:
+            emit_raise(ERR_RUNTIME, "未対応のASTノードだヨ😅💦");
+            emit_byte(OP_NULL);
+            break;
+    }
+}
+
+
+static void begin_loop(Loop* loop) {
+    loop->enclosing = current->loop;
+    loop->scope_depth = current->scope_depth;
+    loop->try_scope = current->try_scope;
+    loop->continue_target = -1;
+    loop->breaks = (JumpList){0, 0, NULL};
+    loop->continues = (JumpList){0, 0, NULL};
+    current->loop = loop;
+}
+
+static void end_loop(Loop* loop) {
+    jump_list_patch(&loop->breaks);
+    current->loop = loop->enclosing;
+}
+
+static void compile_loop_exit(bool is_break) {
+    Loop* loop = current->loop;
+    if (!loop) {
+        emit_byte(OP_NULL);
+        emit_function_return();
+        return;
+    }
+    unwind_try_scopes(loop->try_scope);
+    discard_locals(loop->scope_depth);
+    if (!is_break && loop->continue_target >= 0) {
+        emit_loop(loop->continue_target);
+    } else {
+        jump_list_add(is_break ? &loop->breaks : &loop->continues, emit_jump(OP_JUMP));
+    }
+}
+
+static void compile_if(AstNode* node) {
+    compile_expression(node->as.if_stmt.condition);
+    int then_jump = emit_jump(OP_JUMP_IF_FALSE);
+    emit_byte(OP_POP);
+    compile_block(node->as.if_stmt.then_branch);
+    if (node->as.if_stmt.else_branch) {
+        int else_jump = emit_jump(OP_JUMP);
+        patch_jump(then_jump);
+        emit_byte(OP_POP);
+        compile_block(node->as.if_stmt.else_branch);
+        patch_jump(else_jump);
+    } else {
+        int end_jump = emit_jump(OP_JUMP);
+        patch_jump(then_jump);
+        emit_byte(OP_POP);
+        patch_jump(end_jump);
+    }
+}
+
+static void compile_while(AstNode* node) {
+    Loop loop;
+    int loop_start = current_chunk()->count;
+    begin_loop(&loop);
+    loop.continue_target = loop_start;
+
+    compile_expression(node->as.while_stmt.condition);
+    int exit_jump = emit_jump(OP_JUMP_IF_FALSE);
+    emit_byte(OP_POP);
+    compile_block(node->as.while_stmt.body);
+    emit_loop(loop_start);
+
+    patch_jump(exit_jump);
+    emit_byte(OP_POP);
+    end_loop(&loop);
+}
+
+static void compile_for_range(AstNode* node) {
+    begin_scope();
+    compile_expression(node->as.for_range.start);
+    compile_expression(node->as.for_range.end);
+    current_line = node->line;
+    emit_byte(OP_RANGE_INIT);
+    int base = add_local(NULL);
+    add_local(NULL);
+    add_local(NULL);
+    emit_byte(OP_NULL);
+    add_local(node->as.for_range.var_name);
+
+    Loop loop;
+    begin_loop(&loop);
+    int loop_start = current_chunk()->count;
+    emit_bytes(OP_RANGE_NEXT, (uint8_t)base);
+    emit_byte(0xff);
+    emit_byte(0xff);
+    int exit_jump = current_chunk()->count - 2;
+
+    compile_block(node->as.for_range.body);
+
+    jump_list_patch(&loop.continues);
+    current_line = node->line;
+    emit_bytes(OP_RANGE_STEP, (uint8_t)base);
+    emit_loop(loop_start);
+
+    patch_jump(exit_jump);
+    end_loop(&loop);
+    end_scope();
+}
+
+static void compile_for_each(AstNode* node) {
+    begin_scope();
+    AstNode* collection = node->as.for_each.collection;
+    if (collection->type == AST_CALL && collection->as.call.arg_count == 1 &&
+        collection->as.call.callee->type == AST_VARIABLE) {
+        compile_expression(collection->as.call.callee);
+        compile_expression(collection->as.call.args[0]);
+        current_line = node->line;
+        int view_jump = emit_jump(OP_ITER_VIEW);
+        emit_bytes(OP_CALL, 1);
+        emit_byte(OP_ITER_INIT);
+        patch_jump(view_jump);
+    } else {
+        compile_expression(collection);
+        current_line = node->line;
+        emit_byte(OP_ITER_INIT);
+    }
+    int base = add_local(NULL);
+    add_local(NULL);
+    add_local(NULL);
+    add_local(NULL);
+    emit_byte(OP_NULL);
+    add_local(node->as.for_each.var_name);
+
+    Loop loop;
+    begin_loop(&loop);
+    int loop_start = current_chunk()->count;
+    loop.continue_target = loop_start;
+    emit_bytes(OP_ITER_NEXT, (uint8_t)base);
+    emit_byte(0xff);
+    emit_byte(0xff);
+    int exit_jump = current_chunk()->count - 2;
+
+    compile_block(node->as.for_each.body);
+    emit_loop(loop_start);
+
+    patch_jump(exit_jump);
+    end_loop(&loop);
+    end_scope();
+}
+
+static void compile_try(AstNode* node) {
+    TryScope scope;
+    scope.enclosing = current->try_scope;
+    scope.finally_block = node->as.try_stmt.finally_block;
+    scope.handler_active = true;
+
+    current->try_scope = &scope;
+    int catch_jump = emit_jump(OP_TRY);
+    compile_block(node->as.try_stmt.try_block);
+    emit_byte(OP_TRY_END);
+    scope.handler_active = false;
+    current->try_scope = scope.enclosing;
+    if (scope.finally_block) compile_block(scope.finally_block);
+    int end_jump = emit_jump(OP_JUMP);
+
+    patch_jump(catch_jump);
+    if (node->as.try_stmt.catch_block) {
+        current->try_scope = &scope;
+        begin_scope();
+        add_local(node->as.try_stmt.catch_var);
+        compile_block(node->as.try_stmt.catch_block);
+        end_scope();
+        current->try_scope = scope.enclosing;
+    } else {
+        emit_byte(OP_POP);
+    }
+    if (scope.finally_block) compile_block(scope.finally_block);
+    patch_jump(end_jump);
+}
+
+static void compile_class(AstNode* node) {
+    emit_byte(OP_CLASS);
+    emit_short(identifier_constant(node->as.class_decl.name));
+    for (int i = 0; i < node->as.class_decl.method_count; i++) {
+        AstNode* method = node->as.class_decl.methods[i];
+        compile_function(method, FN_METHOD);
+        current_line = node->line;
+        emit_byte(OP_METHOD);
+        emit_short(identifier_constant(method->as.func_decl.name));
+    }
+    if (node->as.class_decl.constructor) {
+        compile_function(node->as.class_decl.constructor, FN_CONSTRUCTOR);
+        current_line = node->line;
+        emit_byte(OP_CONSTRUCTOR);
+    }
+    define_variable(node->as.class_decl.name);
+}
+
+static void compile_statement(AstNode* node) {
+    if (!node) {
+        emit_byte(OP_FAIL);
+        return;
+    }
+    current_line = node->line;
+
+    switch (node->type) {
+        case AST_VAR_DECL:
+            compile_expression(node->as.var_decl.init);
+            current_line = node->line;
+            define_variable(node->as.var_decl.name);
+            break;
+        case AST_FUNC_DECL:
+            compile_function(node, FN_FUNCTION);
+            define_variable(node->as.func_decl.name);
+            break;
+        case AST_CLASS_DECL:
+            compile_class(node);
+            break;
+        case AST_PRINT:
+            compile_expression(node->as.print_stmt.value);
+            current_line = node->line;
+            emit_byte(node->as.print_stmt.is_println ? OP_PRINTLN : OP_PRINT);
+            break;
+        case AST_IF:
+            compile_if(node);
+            break;
+        case AST_WHILE:
+            compile_while(node);
+            break;
+        case AST_FOR_RANGE:
+            compile_for_range(node);
+            break;
+        case AST_FOR_EACH:
+            compile_for_each(node);
+            break;
+        case AST_RETURN:
+            compile_expression(node->as.return_stmt.value);
+            current_line = node->line;
+            emit_function_return();
+            break;
+        case AST_BREAK:
+            compile_loop_exit(true);
+            break;
+        case AST_CONTINUE:
+            compile_loop_exit(false);
+            break;
+        case AST_TRY:
+            compile_try(node);
+            break;
+        case AST_ARRAY_PUSH:
+            emit_get_variable(node->as.array_push.array_name);
+            compile_expression(node->as.array_push.value);
+            current_line = node->line;
+            emit_byte(OP_APPEND);
+            emit_short(identifier_constant(node->as.array_push.array_name));
+            break;
+        case AST_IMPORT:
+            emit_byte(OP_IMPORT);
+            emit_short(identifier_constant(node->as.import_stmt.path));
+            emit_byte(OP_POP);
+            break;
+        case AST_EXPR_STMT:
+            compile_expression(node->as.expr_stmt.expr);
+            emit_byte(OP_POP);
+            break;
+        case AST_BLOCK:
+            compile_block(node);
+            break;
+        default:
+            compile_expression(node);
+            emit_byte(OP_POP);
+            break;
+    }
+}
+
+static void compile_block(AstNode* node) {
+    if (!node) {
+        emit_byte(OP_FAIL);
+        return;
+    }
+    if (node->type != AST_BLOCK) {
+        compile_statement(node);
+        return;
+    }
+    begin_scope();
+    hoist_declarations(node);
+    for (int i = 0; i < node->as.block.stmt_count; i++) {
+        compile_statement(node->as.block.stmts[i]);
+    }
+    end_scope();
+}
+
+ObjFunc* compile_program(AstNode* program) {
+    Compiler compiler;
+    had_error = false;
+    current_line = program ? program->line : 0;
+    init_compiler(&compiler, FN_SCRIPT, NULL, 0);
+
+    if (!program) {
+        emit_byte(OP_FAIL);
+    } else if (program->type == AST_BLOCK) {
+        for (int i = 0; i < program->as.block.stmt_count; i++) {
+            compile_statement(program->as.block.stmts[i]);
+        }
+    } else {
+        compile_statement(program);
+    }
+
+    ObjFunc* function = end_compiler();
+    return had_error ? NULL : function;
+}
+
+void compiler_mark_roots(void) {
+    for (Compiler* compiler = current; compiler != NULL; compiler = compiler->enclosing) {
+        gc_mark_obj((Obj*)compiler->function);
+    }
+}
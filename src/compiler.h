@@ -0,0 +1,10 @@
+#ifndef OJISAN_COMPILER_H
+#define OJISAN_COMPILER_H
+
+#include "ast.h"
+#include "value.h"
+
+ObjFunc* compile_program(AstNode* program);
+void compiler_mark_roots(void);
+
+#endif 
@@ -1,18 +1,87 @@
 #include "env.h"
+#include "gc.h"
 #include <stdlib.h>
 #include <string.h>
 
+#define FRAME_STACK_SIZE (4 * 1024 * 1024)
+#define FRAME_SIZE(count) ((sizeof(Environment) + sizeof(Value) * (count) + 7) & ~(size_t)7)
+
+static char* frame_stack = NULL;
+static size_t frame_top = 0;
+
+static void free_table_value(const char* key, void* value, void* userdata) {
+    (void)key;
+    (void)userdata;
+    free(value);
+}
+
 Environment* env_new(Environment* enclosing) {
-    Environment* env = malloc(sizeof(Environment));
+    return env_new_frame(enclosing, 0, NULL);
+}
+
+Environment* env_new_frame(Environment* enclosing, int slot_count, char** slot_names) {
+    Environment* env = malloc(sizeof(Environment) + sizeof(Value) * slot_count);
     env->enclosing = enclosing;
-    env->values = table_create();
+    env->values = NULL;
     env->ref_count = 1;
-    if (enclosing) {
+    env->slot_count = slot_count;
+    env->defined = 0;
+    env->on_stack = false;
+    env->epoch = gc_epoch;
+    env->remembered_index = -1;
+    env->slot_names = slot_names;
+    env->slots = (Value*)(env + 1);
+    if (enclosing && !enclosing->on_stack) {
         env_retain(enclosing);
     }
     return env;
 }
 
+Environment* env_push_frame(Environment* enclosing, int slot_count, char** slot_names) {
+    size_t size = FRAME_SIZE(slot_count);
+    if (frame_stack == NULL) frame_stack = malloc(FRAME_STACK_SIZE);
+    if (frame_top + size > FRAME_STACK_SIZE) {
+        return env_new_frame(enclosing, slot_count, slot_names);
+    }
+    Environment* env = (Environment*)(frame_stack + frame_top);
+    frame_top += size;
+    env->enclosing = enclosing;
+    env->values = NULL;
+    env->ref_count = 1;
+    env->slot_count = slot_count;
+    env->defined = 0;
+    env->on_stack = true;
+    env->epoch = gc_epoch;
+    env->remembered_index = -1;
+    env->slot_names = slot_names;
+    env->slots = (Value*)(env + 1);
+    return env;
+}
+
+size_t env_stack_mark(void) {
+    return frame_top;
+}
+
+void env_stack_reset(size_t mark) {
+    size_t top = mark;
+    while (top < frame_top) {
+        Environment* env = (Environment*)(frame_stack + top);
+        table_iterate(env->values, free_table_value, NULL);
+        table_free(env->values);
+        top += FRAME_SIZE(env->slot_count);
+    }
+    frame_top = mark;
+}
+
+void env_stack_iterate(EnvVisitFn visit) {
+    size_t top = 0;
+    while (top < frame_top) {
+        Environment* env = (Environment*)(frame_stack + top);
+        visit(env);
+        top += FRAME_SIZE(env->slot_count);
+    }
+}
+
 void env_retain(Environment* env) {
     if (env) {
         env->ref_count++;
@@ -21,46 +90,95 @@ void env_retain(Environment* env) {
 
 void env_release(Environment* env) {
     if (!env) return;
+    if (env->on_stack) {
+        table_iterate(env->values, free_table_value, NULL);
+        table_free(env->values);
+        frame_top = (char*)env - frame_stack;
+        return;
+    }
     env->ref_count--;
     if (env->ref_count <= 0) {
+        if (env->remembered_index >= 0) gc_forget_env(env);
+        table_iterate(env->values, free_table_value, NULL);
         table_free(env->values);
-        if (env->enclosing) {
+        if (env->enclosing && !env->enclosing->on_stack) {
             env_release(env->enclosing);
         }
         free(env);
     }
 }
 
+static int find_slot(Environment* env, const char* name) {
+    for (int i = env->defined - 1; i >= 0; i--) {
+        if (strcmp(env->slot_names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
 void env_define(Environment* env, const char* name, Value value) {
-    void* old_ptr;
-    if (table_get(env->values, name, &old_ptr)) {
-        free(old_ptr);
+    gc_env_write_barrier(env, value);
+    int slot = find_slot(env, name);
+    if (slot != -1) {
+        env->slots[slot] = value;
+        return;
     }
+    if (env->values == NULL) env->values = table_create();
     Value* v = malloc(sizeof(Value));
     *v = value;
     table_set(env->values, name, v);
 }
 
 bool env_get(Environment* env, const char* name, Value* out_value) {
-    void* ptr;
-    if (table_get(env->values, name, &ptr)) {
-        *out_value = *(Value*)ptr;
-        return true;
-    }
-    if (env->enclosing) {
-        return env_get(env->enclosing, name, out_value);
+    for (; env != NULL; env = env->enclosing) {
+        int slot = find_slot(env, name);
+        if (slot != -1) {
+            *out_value = env->slots[slot];
+            return true;
+        }
+        void* ptr;
+        if (env->values && table_get(env->values, name, &ptr)) {
+            *out_value = *(Value*)ptr;
+            return true;
+        }
     }
     return false;
 }
 
 bool env_assign(Environment* env, const char* name, Value value) {
-    void* ptr;
-    if (table_get(env->values, name, &ptr)) {
-        *(Value*)ptr = value; 
-        return true;
-    }
-    if (env->enclosing) {
-        return env_assign(env->enclosing, name, value);
+    for (; env != NULL; env = env->enclosing) {
+        int slot = find_slot(env, name);
+        if (slot != -1) {
+            gc_env_write_barrier(env, value);
+            env->slots[slot] = value;
+            return true;
+        }
+        void* ptr;
+        if (env->values && table_get(env->values, name, &ptr)) {
+            gc_env_write_barrier(env, value);
+            *(Value*)ptr = value; 
+            return true;
+        }
     }
     return false;
 }
+
+void env_define_slot(Environment* env, int slot, Value value) {
+    gc_env_write_barrier(env, value);
+    env->slots[slot] = value;
+    if (slot >= env->defined) env->defined = slot + 1;
+}
+
+bool env_get_at(Environment* env, int depth, int slot, Value* out_value) {
+    while (depth-- > 0) env = env->enclosing;
+    if (slot >= env->defined) return false;
+    *out_value = env->slots[slot];
+    return true;
+}
+
+bool env_assign_at(Environment* env, int depth, int slot, Value value) {
+    while (depth-- > 0) env = env->enclosing;
+    if (slot >= env->defined) return false;
+    gc_env_write_barrier(env, value);
+    env->slots[slot] = value;
+    return true;
+}
@@ -10,13 +10,30 @@ struct Environment {
     Environment* enclosing;
     HashTable* values; 
     int ref_count;     
+    int slot_count;
+    int defined;
+    bool on_stack;
+    unsigned int epoch;
+    int remembered_index;
+    char** slot_names;
+    Value* slots;
 };
 
+typedef void (*EnvVisitFn)(Environment* env);
+
 Environment* env_new(Environment* enclosing);
+Environment* env_new_frame(Environment* enclosing, int slot_count, char** slot_names);
+Environment* env_push_frame(Environment* enclosing, int slot_count, char** slot_names);
+size_t env_stack_mark(void);
+void env_stack_reset(size_t mark);
+void env_stack_iterate(EnvVisitFn visit);
 void env_retain(Environment* env);
 void env_release(Environment* env);
 void env_define(Environment* env, const char* name, Value value);
 bool env_get(Environment* env, const char* name, Value* out_value);
 bool env_assign(Environment* env, const char* name, Value value);
+void env_define_slot(Environment* env, int slot, Value value);
+bool env_get_at(Environment* env, int depth, int slot, Value* out_value);
+bool env_assign_at(Environment* env, int depth, int slot, Value value);
 
 #endif 
@@ -2,12 +2,17 @@
 #include "error.h"
 #include "builtins.h"
 #include "parser.h"
+#include "resolver.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <math.h>
-#include <limits.h>
 #include "gc.h"
+#include "pool.h"
+#include "valuetable.h"
+#include "shape.h"
+#include "source.h"
+#include "module.h"
+#include "typedarray.h"
 
 
 TryContext* current_try_ctx = NULL;
@@ -15,35 +20,85 @@ TryContext* current_try_ctx = NULL;
 
 #define MAX_CALL_DEPTH 1000
 static int call_depth = 0;
+static int native_call_line = 0;
+
+static Value* string_constants = NULL;
+static int string_constant_count = 0;
+static int string_constant_capacity = 0;
+static unsigned int constant_session = 1;
 
 
-#define MAX_IMPORTS 256
-static char* imported_paths[MAX_IMPORTS];
-static int import_count = 0;
 
 
 #define RETURN_OK(v) return (EvalResult){RES_OK, v}
 #define RETURN_ERR() return (EvalResult){RES_ERROR, NULL_VAL}
-#define IS_TRUTHY(v) (!IS_NULL(v) && (!IS_BOOL(v) || AS_BOOL(v)))
 
 static EvalResult exec_block(AstNode* node, Environment* env);
+static Environment* new_frame(Environment* enclosing, int slot_count, char** slot_names, bool captured);
+static Environment* new_call_frame(ObjFunc* func, int argCount, Value* args, Value thisVal);
 static EvalResult call_function(ObjFunc* func, int argCount, Value* args);
 static EvalResult call_native(ObjNative* native, int argCount, Value* args);
+static void release_frame(Environment* env);
+
+
+static EvalResult for_each_collection(AstNode* coll, Environment* env, DictView* view) {
+    *view = DICT_VIEW_NONE;
+    if (coll->type == AST_CALL && coll->as.call.arg_count == 1 && coll->as.call.callee->type == AST_VARIABLE) {
+        EvalResult callee = evaluate(coll->as.call.callee, env);
+        if (callee.type != RES_OK) return callee;
+        DictView candidate = builtin_dict_view(callee.value);
+        if (candidate != DICT_VIEW_NONE) {
+            EvalResult arg = evaluate(coll->as.call.args[0], env);
+            if (arg.type != RES_OK) return arg;
+            if (IS_OBJ(arg.value) && AS_OBJ(arg.value)->type == OBJ_DICT) {
+                *view = candidate;
+                return arg;
+            }
+            gc_push_root(arg.value);
+            return call_native((ObjNative*)AS_OBJ(callee.value), 1, &arg.value);
+        }
+    }
+    return evaluate(coll, env);
+}
+
+int eval_constant_mark(void) {
+    return string_constant_count;
+}
+
+void eval_release_constants(int mark) {
+    if (mark < 0 || mark > string_constant_count) return;
+    string_constant_count = mark;
+    constant_session++;
+}
+
+void eval_reset_constants(void) {
+    eval_release_constants(0);
+}
 
+void eval_mark_roots(void) {
+    for (int i = 0; i < string_constant_count; i++) gc_mark_value(string_constants[i]);
+}
 
-typedef struct { ObjList* list; } ForEachDictCtx;
-static void for_each_dict_callback(const char* key, void* val, void* userdata) {
-    (void)val;
-    ForEachDictCtx* ctx = (ForEachDictCtx*)userdata;
-    ObjString* s = copy_string_value(key, strlen(key));
-    if (ctx->list->count + 1 > ctx->list->capacity) {
-        ctx->list->capacity = ctx->list->capacity < 8 ? 8 : ctx->list->capacity * 2;
-        ctx->list->items = realloc(ctx->list->items, sizeof(Value) * ctx->list->capacity);
+static Value string_constant(AstNode* node) {
+    if (node->as.literal.const_session == constant_session) {
+        return string_constants[node->as.literal.const_slot];
     }
-    ctx->list->items[ctx->list->count++] = OBJ_VAL(s);
+    Value value = OBJ_VAL(copy_string_value(node->as.literal.s_val, strlen(node->as.literal.s_val)));
+    if (string_constant_count == string_constant_capacity) {
+        string_constant_capacity = string_constant_capacity < 64 ? 64 : string_constant_capacity * 2;
+        string_constants = realloc(string_constants, sizeof(Value) * string_constant_capacity);
+    }
+    node->as.literal.const_slot = string_constant_count;
+    node->as.literal.const_session = constant_session;
+    string_constants[string_constant_count++] = value;
+    return value;
 }
 
-EvalResult evaluate(AstNode* node, Environment* env) {
+static ObjString* member_name(const char* name) {
+    return copy_string_value(name, (int)strlen(name));
+}
+
+static EvalResult evaluate_node(AstNode* node, Environment* env) {
     if (!node) RETURN_ERR();
 
     switch (node->type) {
@@ -51,7 +106,7 @@ EvalResult evaluate(AstNode* node, Environment* env) {
             switch (node->as.literal.type) {
                 case LIT_INT: RETURN_OK(INT_VAL(node->as.literal.i_val));
                 case LIT_FLOAT: RETURN_OK(FLOAT_VAL(node->as.literal.f_val));
-                case LIT_STR: RETURN_OK(OBJ_VAL(copy_string_value(node->as.literal.s_val, strlen(node->as.literal.s_val))));
+                case LIT_STR: RETURN_OK(string_constant(node));
                 case LIT_BOOL: RETURN_OK(BOOL_VAL(node->as.literal.b_val));
                 case LIT_NULL: RETURN_OK(NULL_VAL);
             }
@@ -78,133 +133,18 @@ EvalResult evaluate(AstNode* node, Environment* env) {
 
             EvalResult left = evaluate(node->as.binary.left, env);
             if (left.type != RES_OK) return left;
+            gc_push_root(left.value);
             EvalResult right = evaluate(node->as.binary.right, env);
             if (right.type != RES_OK) return right;
+            gc_push_root(right.value);
 
-            Value l = left.value;
-            Value r = right.value;
-
-            
-            #define NUM_AS_DOUBLE(v) (IS_INT(v) ? (double)AS_INT(v) : AS_FLOAT(v))
-            #define IS_NUM(v) (IS_INT(v) || IS_FLOAT(v))
-
-            switch (node->as.binary.op) {
-                
-                case TOK_TO: 
-                    
-                    if (IS_INT(l) && IS_INT(r)) {
-                        long long a = AS_INT(l), b = AS_INT(r);
-                        if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b)) {
-                            
-                            RETURN_OK(FLOAT_VAL((double)a + (double)b));
-                        }
-                        RETURN_OK(INT_VAL(a + b));
-                    }
-                    if (IS_NUM(l) && IS_NUM(r)) RETURN_OK(FLOAT_VAL(NUM_AS_DOUBLE(l) + NUM_AS_DOUBLE(r)));
-                    
-                    if (IS_OBJ(l) && AS_OBJ(l)->type == OBJ_STRING && IS_OBJ(r) && AS_OBJ(r)->type == OBJ_STRING) {
-                         ObjString* s1 = (ObjString*)AS_OBJ(l);
-                         ObjString* s2 = (ObjString*)AS_OBJ(r);
-                         char* newStr = malloc(s1->length + s2->length + 1);
-                         strcpy(newStr, s1->chars);
-                         strcat(newStr, s2->chars);
-                         ObjString* result = copy_string_value(newStr, s1->length + s2->length);
-                         free(newStr);
-                         RETURN_OK(OBJ_VAL(result));
-                    }
-                    
-                    {
-                        bool l_is_str = IS_OBJ(l) && AS_OBJ(l)->type == OBJ_STRING;
-                        bool r_is_str = IS_OBJ(r) && AS_OBJ(r)->type == OBJ_STRING;
-                        if (l_is_str || r_is_str) {
-                            char lbuf[64] = {0}, rbuf[64] = {0};
-                            const char* ls; const char* rs;
-                            if (l_is_str) { ls = ((ObjString*)AS_OBJ(l))->chars; }
-                            else if (IS_INT(l)) { snprintf(lbuf, sizeof(lbuf), "%lld", AS_INT(l)); ls = lbuf; }
-                            else if (IS_FLOAT(l)) { snprintf(lbuf, sizeof(lbuf), "%g", AS_FLOAT(l)); ls = lbuf; }
-                            else if (IS_BOOL(l)) { ls = AS_BOOL(l) ? "マジ" : "ウソ"; }
-                            else if (IS_NULL(l)) { ls = "ナイナイ"; }
-                            else { ls = ""; }
-                            if (r_is_str) { rs = ((ObjString*)AS_OBJ(r))->chars; }
-                            else if (IS_INT(r)) { snprintf(rbuf, sizeof(rbuf), "%lld", AS_INT(r)); rs = rbuf; }
-                            else if (IS_FLOAT(r)) { snprintf(rbuf, sizeof(rbuf), "%g", AS_FLOAT(r)); rs = rbuf; }
-                            else if (IS_BOOL(r)) { rs = AS_BOOL(r) ? "マジ" : "ウソ"; }
-                            else if (IS_NULL(r)) { rs = "ナイナイ"; }
-                            else { rs = ""; }
-                            int ll = strlen(ls), rl = strlen(rs);
-                            char* newStr = malloc(ll + rl + 1);
-                            memcpy(newStr, ls, ll);
-                            memcpy(newStr + ll, rs, rl);
-                            newStr[ll + rl] = '\0';
-                            ObjString* result = copy_string_value(newStr, ll + rl);
-                            free(newStr);
-                            RETURN_OK(OBJ_VAL(result));
-                        }
-                    }
-                    break;
-                case TOK_HIKU:
-                    if (IS_INT(l) && IS_INT(r)) RETURN_OK(INT_VAL(AS_INT(l) - AS_INT(r)));
-                    if (IS_NUM(l) && IS_NUM(r)) RETURN_OK(FLOAT_VAL(NUM_AS_DOUBLE(l) - NUM_AS_DOUBLE(r)));
-                    break;
-                case TOK_KAKERU:
-                    
-                    if (IS_INT(l) && IS_INT(r)) {
-                        long long a = AS_INT(l), b = AS_INT(r);
-                        if (a != 0 && b != 0 && ((a > 0) == (b > 0)
-                            ? (a > LLONG_MAX / b) : (a < LLONG_MIN / b))) {
-                            RETURN_OK(FLOAT_VAL((double)a * (double)b));
-                        }
-                        RETURN_OK(INT_VAL(a * b));
-                    }
-                    if (IS_NUM(l) && IS_NUM(r)) RETURN_OK(FLOAT_VAL(NUM_AS_DOUBLE(l) * NUM_AS_DOUBLE(r)));
-                    break;
-                case TOK_WARU:
-                     if (IS_INT(l) && IS_INT(r)) {
-                        if (AS_INT(r) == 0) { error_report(ERR_ZERO_DIV, node->line, "0で割っちゃダメだヨ😱💦"); RETURN_ERR(); }
-                        RETURN_OK(INT_VAL(AS_INT(l) / AS_INT(r)));
-                     }
-                     if (IS_NUM(l) && IS_NUM(r)) {
-                        if (NUM_AS_DOUBLE(r) == 0.0) { error_report(ERR_ZERO_DIV, node->line, "0で割っちゃダメだヨ😱💦"); RETURN_ERR(); }
-                        RETURN_OK(FLOAT_VAL(NUM_AS_DOUBLE(l) / NUM_AS_DOUBLE(r)));
-                     }
-                     break;
-                case TOK_AMARI:
-                     if (IS_INT(l) && IS_INT(r)) {
-                        if (AS_INT(r) == 0) { error_report(ERR_ZERO_DIV, node->line, "0で割っちゃダメだヨ😱💦"); RETURN_ERR(); }
-                        RETURN_OK(INT_VAL(AS_INT(l) % AS_INT(r)));
-                     }
-                     if (IS_NUM(l) && IS_NUM(r)) {
-                        if (NUM_AS_DOUBLE(r) == 0.0) { error_report(ERR_ZERO_DIV, node->line, "0で割っちゃダメだヨ😱💦"); RETURN_ERR(); }
-                        RETURN_OK(FLOAT_VAL(fmod(NUM_AS_DOUBLE(l), NUM_AS_DOUBLE(r))));
-                     }
-                     break;
-
-                
-                case TOK_ONAJI_KANA: RETURN_OK(BOOL_VAL(value_equal(l, r)));
-                case TOK_CHIGAU_KANA: RETURN_OK(BOOL_VAL(!value_equal(l, r)));
-                case TOK_YORI_UE:
-                    if (IS_INT(l) && IS_INT(r)) RETURN_OK(BOOL_VAL(AS_INT(l) > AS_INT(r)));
-                    if (IS_NUM(l) && IS_NUM(r)) RETURN_OK(BOOL_VAL(NUM_AS_DOUBLE(l) > NUM_AS_DOUBLE(r)));
-                    break;
-                case TOK_YORI_SHITA:
-                    if (IS_INT(l) && IS_INT(r)) RETURN_OK(BOOL_VAL(AS_INT(l) < AS_INT(r)));
-                    if (IS_NUM(l) && IS_NUM(r)) RETURN_OK(BOOL_VAL(NUM_AS_DOUBLE(l) < NUM_AS_DOUBLE(r)));
-                    break;
-                case TOK_IJOU:
-                    if (IS_INT(l) && IS_INT(r)) RETURN_OK(BOOL_VAL(AS_INT(l) >= AS_INT(r)));
-                    if (IS_NUM(l) && IS_NUM(r)) RETURN_OK(BOOL_VAL(NUM_AS_DOUBLE(l) >= NUM_AS_DOUBLE(r)));
-                    break;
-                case TOK_IKA:
-                    if (IS_INT(l) && IS_INT(r)) RETURN_OK(BOOL_VAL(AS_INT(l) <= AS_INT(r)));
-                    if (IS_NUM(l) && IS_NUM(r)) RETURN_OK(BOOL_VAL(NUM_AS_DOUBLE(l) <= NUM_AS_DOUBLE(r)));
-                    break;
-
-                
-                default: break;
+            Value result;
+            BinaryOpStatus status = value_binary_op(node->as.binary.op, left.value, right.value, &result);
+            if (status == BINOP_OK) RETURN_OK(result);
+            if (status == BINOP_ZERO_DIV) {
+                error_report(ERR_ZERO_DIV, node->line, "0で割っちゃダメだヨ😱💦");
+                RETURN_ERR();
             }
-
-            #undef NUM_AS_DOUBLE
-            #undef IS_NUM
             break;
         }
         case AST_UNARY: {
@@ -269,33 +209,41 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                  RETURN_ERR();
             }
             
-            Environment* loopEnv = env_new(env);
-            env_define(loopEnv, node->as.for_range.var_name, start.value);
+            Environment* loopEnv = new_frame(env, 1, &node->as.for_range.var_name, node->as.for_range.captured);
+            env_define_slot(loopEnv, 0, start.value);
             
             long long current = AS_INT(start.value);
             long long limit = AS_INT(end.value);
             int step = (current <= limit) ? 1 : -1;
             
             while ((step > 0 && current <= limit) || (step < 0 && current >= limit)) {
-                env_assign(loopEnv, node->as.for_range.var_name, INT_VAL(current));
+                env_define_slot(loopEnv, 0, INT_VAL(current));
                 
                 EvalResult res = exec_block(node->as.for_range.body, loopEnv);
-                if (res.type == RES_RETURN || res.type == RES_ERROR) { env_release(loopEnv); return res; }
+                if (res.type == RES_RETURN || res.type == RES_ERROR) { release_frame(loopEnv); return res; }
                 if (res.type == RES_BREAK) break;
                 
                 current += step;
             }
-            env_release(loopEnv);
+            release_frame(loopEnv);
             RETURN_OK(NULL_VAL);
         }
         case AST_VAR_DECL: {
              EvalResult val = evaluate(node->as.var_decl.init, env);
              if (val.type != RES_OK) return val;
-             env_define(env, node->as.var_decl.name, val.value);
+             if (node->as.var_decl.slot >= 0) {
+                 env_define_slot(env, node->as.var_decl.slot, val.value);
+             } else {
+                 env_define(env, node->as.var_decl.name, val.value);
+             }
              RETURN_OK(val.value);
         }
         case AST_VARIABLE: {
              Value val;
+             if (node->as.variable.slot >= 0 &&
+                 env_get_at(env, node->as.variable.depth, node->as.variable.slot, &val)) {
+                 RETURN_OK(val);
+             }
              if (env_get(env, node->as.variable.name, &val)) {
                  RETURN_OK(val);
              }
@@ -305,7 +253,9 @@ EvalResult evaluate(AstNode* node, Environment* env) {
         case AST_NEW: {
              
              Value klassVal;
-             if (!env_get(env, node->as.new_expr.class_name, &klassVal)) {
+             if (!(node->as.new_expr.slot >= 0 &&
+                   env_get_at(env, node->as.new_expr.depth, node->as.new_expr.slot, &klassVal)) &&
+                 !env_get(env, node->as.new_expr.class_name, &klassVal)) {
                  error_report(ERR_UNDEFINED, node->line, "クラス「%s」が見つからないヨ😅💦", node->as.new_expr.class_name);
                  RETURN_ERR();
              }
@@ -317,33 +267,26 @@ EvalResult evaluate(AstNode* node, Environment* env) {
              
              
              ObjInstance* instance = new_instance(klass);
+             gc_push_root(OBJ_VAL(instance));
              
              
              if (klass->constructor) {
+                 ObjFunc* ctor = (ObjFunc*)klass->constructor;
                  
                  Value* args = malloc(sizeof(Value) * node->as.new_expr.arg_count);
                  for(int i=0; i<node->as.new_expr.arg_count; i++) {
                      EvalResult r = evaluate(node->as.new_expr.args[i], env);
                      if (r.type != RES_OK) { free(args); return r; }
                      args[i] = r.value;
+                     gc_push_root(r.value);
                  }
                  
                  
-                 Environment* ctorEnv = env_new(klass->constructor->closure);
-                 env_define(ctorEnv, "this", OBJ_VAL(instance));
-                 
-                 
-                 for (int i = 0; i < klass->constructor->param_count; i++) {
-                    if (i < node->as.new_expr.arg_count) {
-                        env_define(ctorEnv, klass->constructor->params[i], args[i]);
-                    } else {
-                        env_define(ctorEnv, klass->constructor->params[i], NULL_VAL);
-                    }
-                 }
+                 Environment* ctorEnv = new_call_frame(ctor, node->as.new_expr.arg_count, args, OBJ_VAL(instance));
                  free(args);
                  
-                 EvalResult res = exec_block(klass->constructor->body, ctorEnv);
-                 env_release(ctorEnv);
+                 EvalResult res = exec_block(ctor->body, ctorEnv);
+                 release_frame(ctorEnv);
                  if (res.type == RES_ERROR) return res;
              }
              RETURN_OK(OBJ_VAL(instance));
@@ -357,16 +300,11 @@ EvalResult evaluate(AstNode* node, Environment* env) {
              
              if (AS_OBJ(objVal)->type == OBJ_INSTANCE) {
                  ObjInstance* inst = (ObjInstance*)AS_OBJ(objVal);
-                 void* valPtr;
-                 if (table_get(inst->fields, node->as.get.name, &valPtr)) {
-                     RETURN_OK(*(Value*)valPtr);
-                 }
-                 
-                 void* methodPtr;
-                 if (table_get(inst->klass->methods, node->as.get.name, &methodPtr)) {
-                     
-                     
-                     RETURN_OK(*(Value*)methodPtr);
+                 gc_push_root(objVal);
+                 ObjString* name = member_name(node->as.get.name);
+                 Value val;
+                 if (inline_cache_get(node->as.get.cache, inst, name, &val)) {
+                     RETURN_OK(val);
                  }
                  error_report(ERR_UNDEFINED, node->line, "「%s」なんてメンバ持ってないヨ😅💦", node->as.get.name);
                  RETURN_ERR();
@@ -388,14 +326,14 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                  RETURN_ERR();
              }
              ObjInstance* inst = (ObjInstance*)AS_OBJ(objVal);
+             gc_push_root(objVal);
              
              EvalResult valRes = evaluate(node->as.set.value, env);
              if (valRes.type != RES_OK) return valRes;
+             gc_push_root(valRes.value);
              
              
-             Value* vPtr = malloc(sizeof(Value));
-             *vPtr = valRes.value;
-             table_set(inst->fields, node->as.set.name, vPtr);
+             inline_cache_set(node->as.set.cache, inst, member_name(node->as.set.name), valRes.value);
              RETURN_OK(valRes.value);
         }
         case AST_THIS: {
@@ -406,14 +344,16 @@ EvalResult evaluate(AstNode* node, Environment* env) {
         }
         case AST_ARRAY_LITERAL: {
              ObjList* list = new_list();
+             gc_push_root(OBJ_VAL(list));
              if (node->as.array_literal.count > 0) {
-                 list->items = malloc(sizeof(Value) * node->as.array_literal.count);
+                 list->items = pool_alloc(sizeof(Value) * node->as.array_literal.count);
                  list->capacity = node->as.array_literal.count;
-                 list->count = node->as.array_literal.count;
-                 for(int i=0; i<list->count; i++) {
+                 for(int i=0; i<node->as.array_literal.count; i++) {
                      EvalResult r = evaluate(node->as.array_literal.elements[i], env);
-                     if (r.type != RES_OK) { free(list->items); return r; } 
+                     if (r.type != RES_OK) return r;
+                     gc_list_write_barrier(list, i, r.value);
                      list->items[i] = r.value;
+                     list->count = i + 1;
                  }
                  
              }
@@ -422,6 +362,10 @@ EvalResult evaluate(AstNode* node, Environment* env) {
         case AST_ASSIGNMENT: {
              EvalResult val = evaluate(node->as.assignment.value, env);
              if (val.type != RES_OK) return val;
+             if (node->as.assignment.slot >= 0 &&
+                 env_assign_at(env, node->as.assignment.depth, node->as.assignment.slot, val.value)) {
+                 RETURN_OK(val.value);
+             }
              if (env_assign(env, node->as.assignment.name, val.value)) {
                  RETURN_OK(val.value);
              }
@@ -429,36 +373,43 @@ EvalResult evaluate(AstNode* node, Environment* env) {
              RETURN_ERR();
         }
         case AST_FUNC_DECL: {
-             ObjFunc* func = new_function(node->as.func_decl.name, node->as.func_decl.param_count, node->as.func_decl.params, node->as.func_decl.body);
+             ObjFunc* func = new_function(node);
              func->closure = env;
              env_retain(env);
-             env_define(env, node->as.func_decl.name, OBJ_VAL(func));
+             if (node->as.func_decl.slot >= 0) {
+                 env_define_slot(env, node->as.func_decl.slot, OBJ_VAL(func));
+             } else {
+                 env_define(env, node->as.func_decl.name, OBJ_VAL(func));
+             }
              RETURN_OK(OBJ_VAL(func));
         }
         case AST_CLASS_DECL: {
              ObjClass* klass = new_class(node->as.class_decl.name);
+             gc_push_root(OBJ_VAL(klass));
              for (int i = 0; i < node->as.class_decl.method_count; i++) {
                  AstNode* methodNode = node->as.class_decl.methods[i];
-                 ObjFunc* method = new_function(methodNode->as.func_decl.name, 
-                                                methodNode->as.func_decl.param_count,
-                                                methodNode->as.func_decl.params,
-                                                methodNode->as.func_decl.body);
+                 ObjFunc* method = new_function(methodNode);
                  method->closure = env;
                  env_retain(env);
-                 Value* vPtr = malloc(sizeof(Value));
-                 *vPtr = OBJ_VAL(method);
-                 table_set(klass->methods, method->name, vPtr);
+                 gc_push_root(OBJ_VAL(method));
+                 ObjString* methodName = member_name(method->name);
+                 gc_write_barrier(&klass->obj, OBJ_VAL(methodName));
+                 gc_write_barrier(&klass->obj, OBJ_VAL(method));
+                 value_table_set(&klass->methods, methodName, OBJ_VAL(method));
              }
              if (node->as.class_decl.constructor) {
                  AstNode* ctorNode = node->as.class_decl.constructor;
-                 klass->constructor = new_function(ctorNode->as.func_decl.name,
-                                                   ctorNode->as.func_decl.param_count,
-                                                   ctorNode->as.func_decl.params,
-                                                   ctorNode->as.func_decl.body);
-                 klass->constructor->closure = env;
+                 ObjFunc* ctor = new_function(ctorNode);
+                 gc_write_barrier(&klass->obj, OBJ_VAL(ctor));
+                 klass->constructor = (Obj*)ctor;
+                 ctor->closure = env;
                  env_retain(env);
              }
-             env_define(env, klass->name, OBJ_VAL(klass));
+             if (node->as.class_decl.slot >= 0) {
+                 env_define_slot(env, node->as.class_decl.slot, OBJ_VAL(klass));
+             } else {
+                 env_define(env, klass->name, OBJ_VAL(klass));
+             }
              RETURN_OK(NULL_VAL);
         }
         case AST_RETURN: {
@@ -476,6 +427,7 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                  EvalResult objRes = evaluate(node->as.call.callee->as.get.object, env);
                  if (objRes.type != RES_OK) return objRes;
                  thisVal = objRes.value;
+                 gc_push_root(thisVal);
 
                  if (IS_OBJ(thisVal) && AS_OBJ(thisVal)->type == OBJ_INSTANCE) {
                      is_method_call = true;
@@ -484,6 +436,7 @@ EvalResult evaluate(AstNode* node, Environment* env) {
 
              EvalResult callee = evaluate(node->as.call.callee, env);
              if (callee.type != RES_OK) return callee;
+             gc_push_root(callee.value);
 
              
              Value* args = NULL;
@@ -493,6 +446,7 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                      EvalResult a = evaluate(node->as.call.args[i], env);
                      if (a.type != RES_OK) { free(args); return a; }
                      args[i] = a.value;
+                     gc_push_root(a.value);
                  }
              }
 
@@ -511,15 +465,9 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                          RETURN_ERR();
                      }
                      
-                     Environment* fnEnv = env_new(func->closure);
-                     env_define(fnEnv, "this", thisVal);
-                     for (int i = 0; i < func->param_count; i++) {
-                         Value val = NULL_VAL;
-                         if (i < node->as.call.arg_count) val = args[i];
-                         env_define(fnEnv, func->params[i], val);
-                     }
+                     Environment* fnEnv = new_call_frame(func, node->as.call.arg_count, args, thisVal);
                      EvalResult res = exec_block(func->body, fnEnv);
-                     env_release(fnEnv);
+                     release_frame(fnEnv);
                      call_depth--;
                      if (res.type == RES_RETURN) ret = (EvalResult){RES_OK, res.value};
                      else if (res.type == RES_ERROR) ret = res;
@@ -528,7 +476,10 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                      ret = call_function(func, node->as.call.arg_count, args);
                  }
              } else if (AS_OBJ(callee.value)->type == OBJ_NATIVE) {
+                 int saved_line = native_call_line;
+                 native_call_line = node->line;
                  ret = call_native((ObjNative*)AS_OBJ(callee.value), node->as.call.arg_count, args);
+                 native_call_line = saved_line;
              } else {
                  error_report(ERR_TYPE, node->line, "それは関数じゃないヨ😅💦");
                  ret = (EvalResult){RES_ERROR, NULL_VAL};
@@ -541,8 +492,10 @@ EvalResult evaluate(AstNode* node, Environment* env) {
         case AST_CONTINUE: return (EvalResult){RES_CONTINUE, NULL_VAL};
 
         case AST_FOR_EACH: {
-            EvalResult collRes = evaluate(node->as.for_each.collection, env);
+            DictView view;
+            EvalResult collRes = for_each_collection(node->as.for_each.collection, env, &view);
             if (collRes.type != RES_OK) return collRes;
+            gc_push_root(collRes.value);
             if (!IS_OBJ(collRes.value)) {
                 error_report(ERR_TYPE, node->line, "配列か辞書じゃないとfor-eachできないヨ😅💦");
                 RETURN_ERR();
@@ -551,32 +504,59 @@ EvalResult evaluate(AstNode* node, Environment* env) {
             if (AS_OBJ(collRes.value)->type == OBJ_LIST) {
                 
                 ObjList* list = (ObjList*)AS_OBJ(collRes.value);
-                Environment* loopEnv = env_new(env);
-                env_define(loopEnv, node->as.for_each.var_name, NULL_VAL);
+                Environment* loopEnv = new_frame(env, 1, &node->as.for_each.var_name, node->as.for_each.captured);
+                env_define_slot(loopEnv, 0, NULL_VAL);
                 for (int i = 0; i < list->count; i++) {
-                    env_assign(loopEnv, node->as.for_each.var_name, list->items[i]);
+                    env_define_slot(loopEnv, 0, list->items[i]);
+                    EvalResult res = exec_block(node->as.for_each.body, loopEnv);
+                    if (res.type == RES_RETURN || res.type == RES_ERROR) { release_frame(loopEnv); return res; }
+                    if (res.type == RES_BREAK) break;
+                }
+                release_frame(loopEnv);
+            } else if (AS_OBJ(collRes.value)->type == OBJ_TYPED_ARRAY) {
+                ObjTypedArray* array = (ObjTypedArray*)AS_OBJ(collRes.value);
+                Environment* loopEnv = new_frame(env, 1, &node->as.for_each.var_name, node->as.for_each.captured);
+                env_define_slot(loopEnv, 0, NULL_VAL);
+                for (int i = 0; i < array->count; i++) {
+                    env_define_slot(loopEnv, 0, typed_array_get(array, i));
                     EvalResult res = exec_block(node->as.for_each.body, loopEnv);
-                    if (res.type == RES_RETURN || res.type == RES_ERROR) { env_release(loopEnv); return res; }
+                    if (res.type == RES_RETURN || res.type == RES_ERROR) { release_frame(loopEnv); return res; }
                     if (res.type == RES_BREAK) break;
                 }
-                env_release(loopEnv);
+                release_frame(loopEnv);
             } else if (AS_OBJ(collRes.value)->type == OBJ_DICT) {
                 
                 ObjDict* dict = (ObjDict*)AS_OBJ(collRes.value);
-                
-                ObjList* keys = new_list();
-                ForEachDictCtx feCtx = { .list = keys };
-                table_iterate(dict->items, for_each_dict_callback, &feCtx);
-
-                Environment* loopEnv = env_new(env);
-                env_define(loopEnv, node->as.for_each.var_name, NULL_VAL);
-                for (int i = 0; i < keys->count; i++) {
-                    env_assign(loopEnv, node->as.for_each.var_name, keys->items[i]);
+                unsigned int version = dict->items.version;
+                int end = dict->items.used;
+                int cursor = 0;
+                ObjString* key;
+                Value value;
+
+                Environment* loopEnv = new_frame(env, 1, &node->as.for_each.var_name, node->as.for_each.captured);
+                env_define_slot(loopEnv, 0, NULL_VAL);
+                while (value_table_next(&dict->items, &cursor, &key, &value)) {
+                    env_define_slot(loopEnv, 0, view == DICT_VIEW_VALUES ? value : OBJ_VAL(key));
                     EvalResult res = exec_block(node->as.for_each.body, loopEnv);
-                    if (res.type == RES_RETURN || res.type == RES_ERROR) { env_release(loopEnv); return res; }
+                    if (res.type == RES_RETURN || res.type == RES_ERROR) { release_frame(loopEnv); return res; }
                     if (res.type == RES_BREAK) break;
+                    if (dict->items.version == version) continue;
+                    if (view == DICT_VIEW_NONE) {
+                        release_frame(loopEnv);
+                        error_report(ERR_RUNTIME, node->line, "for-eachで回してる辞書のキーを途中で増やしたり消したりしちゃダメだヨ😅💦");
+                        RETURN_ERR();
+                    }
+                    ObjList* rest = dict_view_snapshot(dict, view, cursor, end);
+                    gc_push_root(OBJ_VAL(rest));
+                    for (int i = 0; i < rest->count; i++) {
+                        env_define_slot(loopEnv, 0, rest->items[i]);
+                        res = exec_block(node->as.for_each.body, loopEnv);
+                        if (res.type == RES_RETURN || res.type == RES_ERROR) { release_frame(loopEnv); return res; }
+                        if (res.type == RES_BREAK) break;
+                    }
+                    break;
                 }
-                env_release(loopEnv);
+                release_frame(loopEnv);
             } else {
                 error_report(ERR_TYPE, node->line, "配列か辞書じゃないとfor-eachできないヨ😅💦");
                 RETURN_ERR();
@@ -587,6 +567,7 @@ EvalResult evaluate(AstNode* node, Environment* env) {
         case AST_INDEX_GET: {
             EvalResult objRes = evaluate(node->as.index_get.object, env);
             if (objRes.type != RES_OK) return objRes;
+            gc_push_root(objRes.value);
             EvalResult idxRes = evaluate(node->as.index_get.index, env);
             if (idxRes.type != RES_OK) return idxRes;
 
@@ -603,16 +584,28 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                 }
                 RETURN_OK(list->items[idx]);
             }
+            if (IS_OBJ(objRes.value) && AS_OBJ(objRes.value)->type == OBJ_TYPED_ARRAY) {
+                ObjTypedArray* array = (ObjTypedArray*)AS_OBJ(objRes.value);
+                if (!IS_INT(idxRes.value)) {
+                    error_report(ERR_TYPE, node->line, "配列のインデックスは整数じゃないとダメだヨ😅💦");
+                    RETURN_ERR();
+                }
+                long long idx = AS_INT(idxRes.value);
+                if (idx < 0 || idx >= array->count) {
+                    error_report(ERR_INDEX_OUT_OF_BOUNDS, node->line, "インデックス %lld は範囲外だヨ😅💦", idx);
+                    RETURN_ERR();
+                }
+                RETURN_OK(typed_array_get(array, (int)idx));
+            }
             if (IS_OBJ(objRes.value) && AS_OBJ(objRes.value)->type == OBJ_DICT) {
                 ObjDict* dict = (ObjDict*)AS_OBJ(objRes.value);
                 if (!IS_OBJ(idxRes.value) || AS_OBJ(idxRes.value)->type != OBJ_STRING) {
                     error_report(ERR_TYPE, node->line, "辞書のキーは文字列じゃないとダメだヨ😅💦");
                     RETURN_ERR();
                 }
-                char* key = ((ObjString*)AS_OBJ(idxRes.value))->chars;
-                void* valPtr;
-                if (table_get(dict->items, key, &valPtr)) {
-                    RETURN_OK(*(Value*)valPtr);
+                Value val;
+                if (value_table_get(&dict->items, (ObjString*)AS_OBJ(idxRes.value), &val)) {
+                    RETURN_OK(val);
                 }
                 RETURN_OK(NULL_VAL);
             }
@@ -623,8 +616,10 @@ EvalResult evaluate(AstNode* node, Environment* env) {
         case AST_INDEX_SET: {
             EvalResult objRes = evaluate(node->as.index_set.object, env);
             if (objRes.type != RES_OK) return objRes;
+            gc_push_root(objRes.value);
             EvalResult idxRes = evaluate(node->as.index_set.index, env);
             if (idxRes.type != RES_OK) return idxRes;
+            gc_push_root(idxRes.value);
             EvalResult valRes = evaluate(node->as.index_set.value, env);
             if (valRes.type != RES_OK) return valRes;
 
@@ -639,19 +634,35 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                     error_report(ERR_INDEX_OUT_OF_BOUNDS, node->line, "インデックス %lld は範囲外だヨ😅💦", idx);
                     RETURN_ERR();
                 }
+                gc_list_write_barrier(list, idx, valRes.value);
                 list->items[idx] = valRes.value;
                 RETURN_OK(valRes.value);
             }
+            if (IS_OBJ(objRes.value) && AS_OBJ(objRes.value)->type == OBJ_TYPED_ARRAY) {
+                ObjTypedArray* array = (ObjTypedArray*)AS_OBJ(objRes.value);
+                if (!IS_INT(idxRes.value)) {
+                    error_report(ERR_TYPE, node->line, "配列のインデックスは整数じゃないとダメだヨ😅💦");
+                    RETURN_ERR();
+                }
+                long long idx = AS_INT(idxRes.value);
+                if (idx < 0 || idx >= array->count) {
+                    error_report(ERR_INDEX_OUT_OF_BOUNDS, node->line, "インデックス %lld は範囲外だヨ😅💦", idx);
+                    RETURN_ERR();
+                }
+                if (!typed_array_set(array, (int)idx, valRes.value)) {
+                    error_report(ERR_TYPE, node->line, "%s", array->kind == TYPED_INT64 ? "整数配列には整数しか入れられないヨ😅💦" : "小数配列には数字しか入れられないヨ😅💦");
+                    RETURN_ERR();
+                }
+                RETURN_OK(valRes.value);
+            }
             if (IS_OBJ(objRes.value) && AS_OBJ(objRes.value)->type == OBJ_DICT) {
                 ObjDict* dict = (ObjDict*)AS_OBJ(objRes.value);
                 if (!IS_OBJ(idxRes.value) || AS_OBJ(idxRes.value)->type != OBJ_STRING) {
                     error_report(ERR_TYPE, node->line, "辞書のキーは文字列じゃないとダメだヨ😅💦");
                     RETURN_ERR();
                 }
-                char* key = ((ObjString*)AS_OBJ(idxRes.value))->chars;
-                Value* vPtr = malloc(sizeof(Value));
-                *vPtr = valRes.value;
-                table_set(dict->items, key, vPtr);
+                value_table_set(&dict->items, (ObjString*)AS_OBJ(idxRes.value), valRes.value);
+                gc_dict_write_barrier(dict, (ObjString*)AS_OBJ(idxRes.value), valRes.value);
                 RETURN_OK(valRes.value);
             }
             error_report(ERR_TYPE, node->line, "インデックス代入できないヨ😅💦");
@@ -660,7 +671,9 @@ EvalResult evaluate(AstNode* node, Environment* env) {
 
         case AST_ARRAY_PUSH: {
             Value arrVal;
-            if (!env_get(env, node->as.array_push.array_name, &arrVal)) {
+            if (!(node->as.array_push.slot >= 0 &&
+                  env_get_at(env, node->as.array_push.depth, node->as.array_push.slot, &arrVal)) &&
+                !env_get(env, node->as.array_push.array_name, &arrVal)) {
                 error_report(ERR_UNDEFINED, node->line, "配列「%s」が見つからないヨ😅💦", node->as.array_push.array_name);
                 RETURN_ERR();
             }
@@ -671,29 +684,27 @@ EvalResult evaluate(AstNode* node, Environment* env) {
             ObjList* list = (ObjList*)AS_OBJ(arrVal);
             EvalResult valRes = evaluate(node->as.array_push.value, env);
             if (valRes.type != RES_OK) return valRes;
-            if (list->count + 1 > list->capacity) {
-                list->capacity = list->capacity < 8 ? 8 : list->capacity * 2;
-                list->items = realloc(list->items, sizeof(Value) * list->capacity);
-            }
+            list_ensure_capacity(list, list->count + 1);
+            gc_list_write_barrier(list, list->count, valRes.value);
             list->items[list->count++] = valRes.value;
             RETURN_OK(NULL_VAL);
         }
 
         case AST_DICT_LITERAL: {
             ObjDict* dict = new_dict();
+            gc_push_root(OBJ_VAL(dict));
             for (int i = 0; i < node->as.dict_literal.count; i++) {
                 EvalResult keyRes = evaluate(node->as.dict_literal.keys[i], env);
                 if (keyRes.type != RES_OK) return keyRes;
+                gc_push_root(keyRes.value);
                 EvalResult valRes = evaluate(node->as.dict_literal.values[i], env);
                 if (valRes.type != RES_OK) return valRes;
                 if (!IS_OBJ(keyRes.value) || AS_OBJ(keyRes.value)->type != OBJ_STRING) {
                     error_report(ERR_TYPE, node->line, "辞書のキーは文字列じゃないとダメだヨ😅💦");
                     RETURN_ERR();
                 }
-                char* key = ((ObjString*)AS_OBJ(keyRes.value))->chars;
-                Value* vPtr = malloc(sizeof(Value));
-                *vPtr = valRes.value;
-                table_set(dict->items, key, vPtr);
+                value_table_set(&dict->items, (ObjString*)AS_OBJ(keyRes.value), valRes.value);
+                gc_dict_write_barrier(dict, (ObjString*)AS_OBJ(keyRes.value), valRes.value);
             }
             RETURN_OK(OBJ_VAL(dict));
         }
@@ -702,6 +713,8 @@ EvalResult evaluate(AstNode* node, Environment* env) {
             TryContext tryCtx;
             tryCtx.prev = current_try_ctx;
             tryCtx.error_message[0] = '\0';
+            tryCtx.frame_mark = env_stack_mark();
+            tryCtx.root_mark = gc_root_mark();
             current_try_ctx = &tryCtx;
 
             EvalResult result;
@@ -712,14 +725,19 @@ EvalResult evaluate(AstNode* node, Environment* env) {
             } else {
                 
                 current_try_ctx = tryCtx.prev;
+                env_stack_reset(tryCtx.frame_mark);
+                gc_root_reset(tryCtx.root_mark);
                 if (node->as.try_stmt.catch_block) {
-                    Environment* catchEnv = env_new(env);
+                    Environment* catchEnv;
                     if (node->as.try_stmt.catch_var) {
+                        catchEnv = new_frame(env, 1, &node->as.try_stmt.catch_var, node->as.try_stmt.catch_captured);
                         ObjString* errStr = copy_string_value(tryCtx.error_message, strlen(tryCtx.error_message));
-                        env_define(catchEnv, node->as.try_stmt.catch_var, OBJ_VAL(errStr));
+                        env_define_slot(catchEnv, 0, OBJ_VAL(errStr));
+                    } else {
+                        catchEnv = new_frame(env, 0, NULL, node->as.try_stmt.catch_captured);
                     }
                     result = exec_block(node->as.try_stmt.catch_block, catchEnv);
-                    env_release(catchEnv);
+                    release_frame(catchEnv);
                 } else {
                     result = (EvalResult){RES_OK, NULL_VAL};
                 }
@@ -742,43 +760,30 @@ EvalResult evaluate(AstNode* node, Environment* env) {
                 RETURN_ERR();
             }
             
-            for (int i = 0; i < import_count; i++) {
-                if (strcmp(imported_paths[i], path) == 0) {
-                    RETURN_OK(NULL_VAL); 
-                }
-            }
-            if (import_count >= MAX_IMPORTS) {
-                error_report(ERR_RUNTIME, node->line, "インポートが多すぎるヨ😱💦");
-                RETURN_ERR();
-            }
-            imported_paths[import_count++] = strdup(path);
-            
-            FILE* f = fopen(path, "rb");
-            if (!f) {
+            Module* module = module_lookup(path);
+            if (!module) {
                 error_report(ERR_RUNTIME, node->line,
                     "ファイルが開けないヨ😅💦: \"%s\"", path);
                 RETURN_ERR();
             }
-            fseek(f, 0L, SEEK_END);
-            size_t fsize = ftell(f);
-            rewind(f);
-            char* src = malloc(fsize + 1);
-            size_t rd = fread(src, 1, fsize, f);
-            src[rd] = '\0';
-            fclose(f);
-            
-            AstNode* prog = parse_program(src);
-            if (prog) {
-                EvalResult res = (EvalResult){RES_OK, NULL_VAL};
-                for (int i = 0; i < prog->as.block.stmt_count; i++) {
-                    res = evaluate(prog->as.block.stmts[i], env);
-                    if (res.type == RES_ERROR) break;
+            if (!module_claim(module, MODULE_WALKER)) RETURN_OK(NULL_VAL);
+
+            if (!module->program) {
+                SourceFile src;
+                if (!source_open(&src, module->path)) {
+                    error_report(ERR_RUNTIME, node->line,
+                        "ファイルが開けないヨ😅💦: \"%s\"", path);
+                    RETURN_ERR();
                 }
-                ast_free(prog);
-                free(src);
+                module->program = parse_program(src.text);
+                source_close(&src);
+                resolve_program(module->program);
+            }
+
+            AstNode* prog = module->program;
+            for (int i = 0; i < prog->as.block.stmt_count; i++) {
+                EvalResult res = evaluate(prog->as.block.stmts[i], env);
                 if (res.type == RES_ERROR) return res;
-            } else {
-                free(src);
             }
             RETURN_OK(NULL_VAL);
         }
@@ -800,18 +805,48 @@ EvalResult evaluate(AstNode* node, Environment* env) {
 }
 
 
+EvalResult evaluate(AstNode* node, Environment* env) {
+    GcRootMark roots = gc_root_mark();
+    EvalResult res = evaluate_node(node, env);
+    gc_root_reset(roots);
+    return res;
+}
+
+static Environment* new_frame(Environment* enclosing, int slot_count, char** slot_names, bool captured) {
+    Environment* frame = captured ? env_new_frame(enclosing, slot_count, slot_names)
+                                  : env_push_frame(enclosing, slot_count, slot_names);
+    if (!frame->on_stack) gc_push_frame_root(frame);
+    return frame;
+}
+
+static void release_frame(Environment* env) {
+    if (!env->on_stack) gc_pop_frame_root();
+    env_release(env);
+}
+
+static Environment* new_call_frame(ObjFunc* func, int argCount, Value* args, Value thisVal) {
+    Environment* fnEnv = new_frame(func->closure, func->param_count + 1, func->frame_names, func->frame_captured);
+    for (int i = 0; i < func->param_count; i++) {
+        Value val = NULL_VAL;
+        if (i < argCount) val = args[i];
+        env_define_slot(fnEnv, i, val);
+    }
+    if (!IS_NULL(thisVal)) env_define_slot(fnEnv, func->param_count, thisVal);
+    return fnEnv;
+}
+
 static EvalResult exec_block(AstNode* node, Environment* env) {
     if (node->type != AST_BLOCK) return evaluate(node, env);
 
-    Environment* blockEnv = env_new(env);
+    Environment* blockEnv = new_frame(env, node->as.block.local_count, node->as.block.local_names, node->as.block.captured);
     for (int i = 0; i < node->as.block.stmt_count; i++) {
         EvalResult res = evaluate(node->as.block.stmts[i], blockEnv);
         if (res.type != RES_OK) {
-            env_release(blockEnv); 
+            release_frame(blockEnv); 
             return res;
         }
     }
-    env_release(blockEnv);
+    release_frame(blockEnv);
     RETURN_OK(NULL_VAL);
 }
 
@@ -824,16 +859,11 @@ static EvalResult call_function(ObjFunc* func, int argCount, Value* args) {
          RETURN_ERR();
      }
 
-     Environment* fnEnv = env_new(func->closure);
-     for (int i = 0; i < func->param_count; i++) {
-         Value val = NULL_VAL;
-         if (i < argCount) val = args[i];
-         env_define(fnEnv, func->params[i], val);
-     }
+     Environment* fnEnv = new_call_frame(func, argCount, args, NULL_VAL);
 
      
      EvalResult res = exec_block(func->body, fnEnv);
-     env_release(fnEnv);
+     release_frame(fnEnv);
      call_depth--;
 
      if (res.type == RES_RETURN) return (EvalResult){RES_OK, res.value}; 
@@ -843,22 +873,48 @@ static EvalResult call_function(ObjFunc* func, int argCount, Value* args) {
 
 static EvalResult call_native(ObjNative* native, int argCount, Value* args) {
     Value res = native->function(argCount, args);
+    if (builtins_take_failure()) {
+        ErrorType type;
+        char message[512];
+        if (builtins_take_error(&type, message, sizeof(message))) error_report(type, native_call_line, "%s", message);
+        RETURN_ERR();
+    }
     RETURN_OK(res);
 }
 
+static bool call_from_native(Value callee, int argCount, Value* args, Value* out) {
+    EvalResult res;
+    if (IS_OBJ(callee) && AS_OBJ(callee)->type == OBJ_FUNC) {
+        res = call_function((ObjFunc*)AS_OBJ(callee), argCount, args);
+    } else if (IS_OBJ(callee) && AS_OBJ(callee)->type == OBJ_NATIVE) {
+        res = call_native((ObjNative*)AS_OBJ(callee), argCount, args);
+    } else {
+        error_report(ERR_TYPE, native_call_line, "それは関数じゃないヨ😅💦");
+        return false;
+    }
+    if (res.type == RES_ERROR) return false;
+    *out = res.value;
+    return true;
+}
+
+Environment* eval_new_global(void) {
+    Environment* global = env_new(NULL);
+    register_builtins(global);
+    builtins_set_call_hook(call_from_native);
+    gc_set_root(global);
+    return global;
+}
+
 void interpret(const char* source) {
     gc_init();
-    
-    for (int i = 0; i < import_count; i++) free(imported_paths[i]);
-    import_count = 0;
+    module_begin_session(MODULE_WALKER);
     AstNode* program = parse_program(source);
     
     
     if (!program) return;
+    resolve_program(program);
 
-    Environment* global = env_new(NULL);
-    register_builtins(global);
-    gc_set_root(global); 
+    Environment* global = eval_new_global();
 
     call_depth = 0; 
     evaluate(program, global);
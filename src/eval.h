@@ -4,6 +4,7 @@
 #include "ast.h"
 #include "env.h"
 #include "value.h"
+#include "gc.h"
 #include <setjmp.h>
 
 typedef enum {
@@ -23,6 +24,8 @@ typedef struct {
 typedef struct TryContext {
     jmp_buf buf;
     char error_message[512];
+    size_t frame_mark;
+    GcRootMark root_mark;
     struct TryContext* prev;
 } TryContext;
 
@@ -30,6 +33,11 @@ typedef struct TryContext {
 extern TryContext* current_try_ctx;
 
 EvalResult evaluate(AstNode* node, Environment* env);
+Environment* eval_new_global(void);
 void interpret(const char* source);
+void eval_reset_constants(void);
+int eval_constant_mark(void);
+void eval_release_constants(int mark);
+void eval_mark_roots(void);
 
 #endif 
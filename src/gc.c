@@ -1,38 +1,216 @@
 #include "gc.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include "value.h"
 #include "hashtable.h"
+#include "valuetable.h"
+#include "shape.h"
+#include "chunk.h"
+#include "compiler.h"
+#include "vm.h"
+#include "pool.h"
+#include "module.h"
+#include "eval.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#define NURSERY_BLOCK_SIZE (256 * 1024)
+#define NURSERY_BLOCKS 16
+#define FREE_BLOCK_LIMIT 16
+#define OLD_THRESHOLD_MIN (256 * 1024)
+#define CARD_SHIFT 4
+
+typedef struct NurseryBlock {
+    struct NurseryBlock* next;
+    size_t used;
+    int live;
+} NurseryBlock;
+
+#define BLOCK_HEADER ((sizeof(NurseryBlock) + 15) & ~(size_t)15)
+#define BLOCK_OF(obj) ((NurseryBlock*)((uintptr_t)(obj) & ~(uintptr_t)(NURSERY_BLOCK_SIZE - 1)))
 
 Obj* vm_objects = NULL; 
+static Obj* young_objects = NULL;
 static int gc_object_count = 0;       
-static int gc_threshold = 256;        
+static int old_object_count = 0;
+static int old_threshold = OLD_THRESHOLD_MIN;
 static Environment* gc_root_env = NULL; 
+static bool collecting_young = false;
+unsigned int gc_epoch = 0;
+static size_t objects_allocated = 0;
+static size_t minor_collections = 0;
+static size_t full_collections = 0;
+
+static NurseryBlock* nursery_current = NULL;
+static NurseryBlock* active_blocks = NULL;
+static int active_block_count = 0;
+static NurseryBlock* retired_blocks = NULL;
+static NurseryBlock* free_blocks = NULL;
+static int free_block_count = 0;
+
+static Obj** remembered = NULL;
+static int remembered_count = 0;
+static int remembered_capacity = 0;
+static Environment** remembered_envs = NULL;
+static int remembered_env_count = 0;
+static int remembered_env_capacity = 0;
+
+Value* gc_temp_roots = NULL;
+int gc_temp_root_count = 0;
+int gc_temp_root_capacity = 0;
+Environment** gc_frame_roots = NULL;
+int gc_frame_root_count = 0;
+int gc_frame_root_capacity = 0;
+
+static void collect(bool full);
 
 void gc_init(void) {
     vm_objects = NULL;
+    young_objects = NULL;
     gc_object_count = 0;
-    gc_threshold = 256;
+    old_object_count = 0;
+    old_threshold = OLD_THRESHOLD_MIN;
+    intern_reset();
     gc_root_env = NULL;
+    remembered_count = 0;
+    remembered_env_count = 0;
+    gc_temp_root_count = 0;
+    gc_frame_root_count = 0;
+    module_forget_functions();
+    eval_reset_constants();
+}
+
+void gc_grow_temp_roots(void) {
+    gc_temp_root_capacity = gc_temp_root_capacity < 64 ? 64 : gc_temp_root_capacity * 2;
+    gc_temp_roots = realloc(gc_temp_roots, sizeof(Value) * gc_temp_root_capacity);
+}
+
+void gc_grow_frame_roots(void) {
+    gc_frame_root_capacity = gc_frame_root_capacity < 64 ? 64 : gc_frame_root_capacity * 2;
+    gc_frame_roots = realloc(gc_frame_roots, sizeof(Environment*) * gc_frame_root_capacity);
 }
 
 void gc_set_root(Environment* root) {
     gc_root_env = root;
 }
 
+static NurseryBlock* block_alloc(void) {
+    void* memory;
+#ifdef _WIN32
+    memory = _aligned_malloc(NURSERY_BLOCK_SIZE, NURSERY_BLOCK_SIZE);
+#else
+    if (posix_memalign(&memory, NURSERY_BLOCK_SIZE, NURSERY_BLOCK_SIZE) != 0) memory = NULL;
+#endif
+    if (memory == NULL) {
+        fprintf(stderr, "メモリが足りないヨ😱💦\n");
+        exit(1);
+    }
+    return (NurseryBlock*)memory;
+}
+
+static void block_release(NurseryBlock* block) {
+    if (free_block_count >= FREE_BLOCK_LIMIT) {
+#ifdef _WIN32
+        _aligned_free(block);
+#else
+        free(block);
+#endif
+        return;
+    }
+    block->next = free_blocks;
+    free_blocks = block;
+    free_block_count++;
+}
+
+static NurseryBlock* take_block(void) {
+    NurseryBlock* block = free_blocks;
+    if (block != NULL) {
+        free_blocks = block->next;
+        free_block_count--;
+    } else {
+        block = block_alloc();
+    }
+    block->used = BLOCK_HEADER;
+    block->live = 0;
+    block->next = active_blocks;
+    active_blocks = block;
+    active_block_count++;
+    return block;
+}
+
+void* gc_allocate(size_t size) {
+    size = (size + 15) & ~(size_t)15;
+    if (nursery_current == NULL || nursery_current->used + size > NURSERY_BLOCK_SIZE) {
+        if (active_block_count >= NURSERY_BLOCKS && gc_root_env != NULL) {
+            collect(old_object_count >= old_threshold);
+        }
+        nursery_current = take_block();
+    }
+    void* memory = (char*)nursery_current + nursery_current->used;
+    nursery_current->used += size;
+    nursery_current->live++;
+    return memory;
+}
+
 void gc_register_new_object(Obj* obj) {
-    obj->next = vm_objects;
-    vm_objects = obj;
+    obj->next = young_objects;
+    young_objects = obj;
     gc_object_count++;
+    objects_allocated++;
+}
+
+void gc_remember(Obj* obj) {
+    if (remembered_count + 1 > remembered_capacity) {
+        remembered_capacity = remembered_capacity < 64 ? 64 : remembered_capacity * 2;
+        remembered = realloc(remembered, sizeof(Obj*) * remembered_capacity);
+    }
+    obj->is_remembered = true;
+    remembered[remembered_count++] = obj;
+}
+
+void gc_remember_card(Obj* owner, CardTable* cards, int index, int span) {
+    int card = index >> CARD_SHIFT;
+    if (card >= cards->count) {
+        int count = cards->count < 8 ? 8 : cards->count;
+        while (count <= card) count *= 2;
+        cards->marks = realloc(cards->marks, count);
+        memset(cards->marks + cards->count, 0, count - cards->count);
+        cards->count = count;
+    }
+    if (!owner->is_remembered) {
+        cards->span = span;
+        gc_remember(owner);
+    }
+    cards->marks[card] = 1;
+}
+
+void gc_dict_write_barrier(ObjDict* dict, ObjString* key, Value value) {
+    if (!dict->obj.is_old) return;
+    if (!gc_is_young(OBJ_VAL(key)) && !gc_is_young(value)) return;
+    int index = value_table_index(&dict->items, key);
+    if (index < 0) return;
+    gc_remember_card(&dict->obj, &dict->cards, index, dict->items.layout);
+}
 
-    
-    if (gc_object_count > gc_threshold && gc_root_env != NULL) {
-        gc_collect(gc_root_env);
-        
-        gc_threshold = gc_object_count < 256 ? 256 : gc_object_count * 2;
+void gc_remember_env(Environment* env) {
+    if (remembered_env_count + 1 > remembered_env_capacity) {
+        remembered_env_capacity = remembered_env_capacity < 64 ? 64 : remembered_env_capacity * 2;
+        remembered_envs = realloc(remembered_envs, sizeof(Environment*) * remembered_env_capacity);
     }
+    env->remembered_index = remembered_env_count;
+    remembered_envs[remembered_env_count++] = env;
 }
 
+void gc_forget_env(Environment* env) {
+    Environment* last = remembered_envs[--remembered_env_count];
+    remembered_envs[env->remembered_index] = last;
+    last->remembered_index = env->remembered_index;
+    env->remembered_index = -1;
+}
 
 static void mark_table_value(const char* key, void* value, void* userdata) {
     (void)key;
@@ -42,12 +220,48 @@ static void mark_table_value(const char* key, void* value, void* userdata) {
     }
 }
 
-void gc_mark_obj(Obj* obj) {
-    if (obj == NULL) return;
-    if (obj->is_marked) return;
-    obj->is_marked = true;
+static void mark_value_table(ValueTable* table) {
+    for (int i = 0; i < table->used; i++) {
+        ValueEntry* entry = &table->entries[i];
+        if (entry->key == NULL) continue;
+        gc_mark_obj((Obj*)entry->key);
+        gc_mark_value(entry->value);
+    }
+}
+
+static Obj** rope_stack = NULL;
+static int rope_stack_capacity = 0;
 
+static void mark_rope(ObjString* rope) {
+    int top = 0;
+    if (rope_stack_capacity == 0) {
+        rope_stack_capacity = 64;
+        rope_stack = malloc(sizeof(Obj*) * rope_stack_capacity);
+    }
+    rope_stack[top++] = &rope->obj;
+    while (top > 0) {
+        ObjString* node = (ObjString*)rope_stack[--top];
+        ObjString* children[2] = {node->left, node->right};
+        for (int i = 0; i < 2; i++) {
+            Obj* child = (Obj*)children[i];
+            if (child == NULL || child->is_marked) continue;
+            if (collecting_young && child->is_old) continue;
+            child->is_marked = true;
+            if (children[i]->chars != NULL) continue;
+            if (top == rope_stack_capacity) {
+                rope_stack_capacity *= 2;
+                rope_stack = realloc(rope_stack, sizeof(Obj*) * rope_stack_capacity);
+            }
+            rope_stack[top++] = child;
+        }
+    }
+}
+
+static void blacken_object(Obj* obj) {
     switch (obj->type) {
+        case OBJ_STRING:
+            if (((ObjString*)obj)->chars == NULL) mark_rope((ObjString*)obj);
+            break;
         case OBJ_LIST: {
             ObjList* list = (ObjList*)obj;
             for (int i = 0; i < list->count; i++) {
@@ -57,7 +271,7 @@ void gc_mark_obj(Obj* obj) {
         }
         case OBJ_DICT: {
             ObjDict* dict = (ObjDict*)obj;
-            table_iterate(dict->items, mark_table_value, NULL);
+            mark_value_table(&dict->items);
             break;
         }
         case OBJ_FUNC: {
@@ -65,11 +279,27 @@ void gc_mark_obj(Obj* obj) {
             if (func->closure) {
                 gc_mark_env(func->closure);
             }
+            if (func->chunk) {
+                for (int i = 0; i < func->chunk->const_count; i++) {
+                    gc_mark_value(func->chunk->constants[i]);
+                }
+            }
+            break;
+        }
+        case OBJ_CLOSURE: {
+            ObjClosure* closure = (ObjClosure*)obj;
+            gc_mark_obj((Obj*)closure->function);
+            for (int i = 0; i < closure->upvalue_count; i++) {
+                gc_mark_obj((Obj*)closure->upvalues[i]);
+            }
             break;
         }
+        case OBJ_UPVALUE:
+            gc_mark_value(((ObjUpvalue*)obj)->closed);
+            break;
         case OBJ_CLASS: {
             ObjClass* klass = (ObjClass*)obj;
-            table_iterate(klass->methods, mark_table_value, NULL);
+            mark_value_table(&klass->methods);
             if (klass->constructor) {
                 gc_mark_obj((Obj*)klass->constructor);
             }
@@ -78,73 +308,259 @@ void gc_mark_obj(Obj* obj) {
         case OBJ_INSTANCE: {
             ObjInstance* inst = (ObjInstance*)obj;
             gc_mark_obj((Obj*)inst->klass);
-            table_iterate(inst->fields, mark_table_value, NULL);
+            for (int i = 0; i < inst->shape->slot_count; i++) {
+                gc_mark_value(inst->fields[i]);
+            }
             break;
         }
         default: break;
     }
 }
 
+void gc_mark_obj(Obj* obj) {
+    if (obj == NULL) return;
+    if (obj->is_marked) return;
+    if (collecting_young && obj->is_old) return;
+    obj->is_marked = true;
+    blacken_object(obj);
+}
+
 void gc_mark_value(Value value) {
     if (IS_OBJ(value)) {
         gc_mark_obj(AS_OBJ(value));
     }
+#ifdef NAN_BOXING
+    else if (IS_BOXED_INT(value)) {
+        gc_mark_obj((Obj*)AS_BOXED_INT(value));
+    }
+#endif
 }
 
 void gc_mark_env(Environment* env) {
     while (env != NULL) {
+        for (int i = 0; i < env->defined; i++) gc_mark_value(env->slots[i]);
         table_iterate(env->values, mark_table_value, NULL);
         env = env->enclosing;
     }
 }
 
+static void scan_list_cards(ObjList* list) {
+    for (int card = 0; card < list->cards.count; card++) {
+        if (!list->cards.marks[card]) continue;
+        int end = (card + 1) << CARD_SHIFT;
+        if (end > list->count) end = list->count;
+        for (int i = card << CARD_SHIFT; i < end; i++) gc_mark_value(list->items[i]);
+    }
+}
+
+static void scan_dict_cards(ObjDict* dict) {
+    for (int card = 0; card < dict->cards.count; card++) {
+        if (!dict->cards.marks[card]) continue;
+        int end = (card + 1) << CARD_SHIFT;
+        if (end > dict->items.used) end = dict->items.used;
+        for (int i = card << CARD_SHIFT; i < end; i++) {
+            ValueEntry* entry = &dict->items.entries[i];
+            if (entry->key == NULL) continue;
+            gc_mark_obj((Obj*)entry->key);
+            gc_mark_value(entry->value);
+        }
+    }
+}
+
+static void scan_remembered(Obj* obj) {
+    if (obj->type == OBJ_LIST && ((ObjList*)obj)->cards.span == 0) {
+        scan_list_cards((ObjList*)obj);
+    } else if (obj->type == OBJ_DICT && ((ObjDict*)obj)->cards.span == ((ObjDict*)obj)->items.layout) {
+        scan_dict_cards((ObjDict*)obj);
+    } else {
+        blacken_object(obj);
+    }
+}
+
+static void reset_cards(CardTable* cards) {
+    if (cards->marks) memset(cards->marks, 0, cards->count);
+    cards->span = -1;
+}
+
+static void mark_frame_values(Environment* env) {
+    for (int i = 0; i < env->defined; i++) gc_mark_value(env->slots[i]);
+    table_iterate(env->values, mark_table_value, NULL);
+}
+
+static void mark_stack_frame(Environment* env) {
+    mark_frame_values(env);
+    if (env->enclosing && !env->enclosing->on_stack) gc_mark_env(env->enclosing);
+}
+
 static void free_object(Obj* obj) {
     switch (obj->type) {
         case OBJ_STRING:
-            free(((ObjString*)obj)->chars);
+            pool_free(((ObjString*)obj)->chars, ((ObjString*)obj)->length + 1);
             break;
-        case OBJ_LIST:
-            free(((ObjList*)obj)->items);
+        case OBJ_LIST: {
+            ObjList* list = (ObjList*)obj;
+            pool_free(list->items - list->head, sizeof(Value) * (list->head + list->capacity));
+            free(list->cards.marks);
             break;
+        }
         case OBJ_DICT:
-            table_free(((ObjDict*)obj)->items);
+            value_table_free(&((ObjDict*)obj)->items);
+            free(((ObjDict*)obj)->cards.marks);
             break;
         case OBJ_FUNC:
-            free(((ObjFunc*)obj)->name);
-            for(int i=0; i<((ObjFunc*)obj)->param_count; i++) free(((ObjFunc*)obj)->params[i]);
-            free(((ObjFunc*)obj)->params);
+            if (((ObjFunc*)obj)->arena) {
+                arena_release(((ObjFunc*)obj)->arena);
+            } else {
+                free(((ObjFunc*)obj)->name);
+            }
+            if (((ObjFunc*)obj)->chunk) chunk_free(((ObjFunc*)obj)->chunk);
+            break;
+        case OBJ_CLOSURE:
+            free(((ObjClosure*)obj)->upvalues);
             break;
         case OBJ_CLASS:
             free(((ObjClass*)obj)->name);
-            table_free(((ObjClass*)obj)->methods);
+            value_table_free(&((ObjClass*)obj)->methods);
             break;
         case OBJ_INSTANCE:
-            table_free(((ObjInstance*)obj)->fields);
+            pool_free(((ObjInstance*)obj)->fields, sizeof(Value) * ((ObjInstance*)obj)->field_capacity);
+            break;
+        case OBJ_TYPED_ARRAY:
+            pool_free(((ObjTypedArray*)obj)->as.ints, sizeof(int64_t) * ((ObjTypedArray*)obj)->count);
             break;
         default: break;
     }
-    free(obj);
+    BLOCK_OF(obj)->live--;
 }
 
-void gc_collect(Environment* root) {
-    
-    if (root != NULL) {
-        gc_mark_env(root);
+static void retire_active_blocks(void) {
+    NurseryBlock* block = active_blocks;
+    while (block != NULL) {
+        NurseryBlock* next = block->next;
+        if (block->live == 0) {
+            block_release(block);
+        } else {
+            block->next = retired_blocks;
+            retired_blocks = block;
+        }
+        block = next;
     }
+    active_blocks = NULL;
+    active_block_count = 0;
+    nursery_current = NULL;
+}
 
-    
-    int alive = 0;
+static void release_empty_blocks(void) {
+    NurseryBlock** block = &retired_blocks;
+    while (*block != NULL) {
+        if ((*block)->live == 0) {
+            NurseryBlock* empty = *block;
+            *block = empty->next;
+            block_release(empty);
+        } else {
+            block = &(*block)->next;
+        }
+    }
+}
+
+static void sweep_young(void) {
+    Obj* object = young_objects;
+    while (object != NULL) {
+        Obj* next = object->next;
+        if (object->is_marked) {
+            object->is_marked = false;
+            object->is_old = true;
+            object->next = vm_objects;
+            vm_objects = object;
+            old_object_count++;
+        } else {
+            if (collecting_young && object->type == OBJ_STRING && ((ObjString*)object)->chars != NULL) intern_remove((ObjString*)object);
+            free_object(object);
+            gc_object_count--;
+        }
+        object = next;
+    }
+    young_objects = NULL;
+    retire_active_blocks();
+}
+
+static void sweep_old(void) {
     Obj** object = &vm_objects;
     while (*object != NULL) {
         if (!(*object)->is_marked) {
             Obj* unreached = *object;
             *object = unreached->next;
             free_object(unreached);
+            gc_object_count--;
+            old_object_count--;
         } else {
             (*object)->is_marked = false; 
             object = &(*object)->next;
-            alive++;
         }
     }
-    gc_object_count = alive;
+    release_empty_blocks();
+}
+
+static void mark_roots(Environment* root) {
+    if (root != NULL) {
+        gc_mark_env(root);
+    }
+    env_stack_iterate(mark_stack_frame);
+    for (int i = 0; i < gc_frame_root_count; i++) mark_frame_values(gc_frame_roots[i]);
+    for (int i = 0; i < gc_temp_root_count; i++) gc_mark_value(gc_temp_roots[i]);
+    vm_mark_roots();
+    compiler_mark_roots();
+    eval_mark_roots();
+    module_mark_roots();
+    shape_mark_all();
+}
+
+static void clear_remembered(void) {
+    for (int i = 0; i < remembered_count; i++) {
+        Obj* obj = remembered[i];
+        obj->is_remembered = false;
+        if (obj->type == OBJ_LIST) reset_cards(&((ObjList*)obj)->cards);
+        else if (obj->type == OBJ_DICT) reset_cards(&((ObjDict*)obj)->cards);
+    }
+    remembered_count = 0;
+    for (int i = 0; i < remembered_env_count; i++) remembered_envs[i]->remembered_index = -1;
+    remembered_env_count = 0;
+}
+
+static void collect_with_root(Environment* root, bool full) {
+    collecting_young = !full;
+    if (full) full_collections++;
+    else minor_collections++;
+    mark_roots(root);
+    if (full) {
+        intern_remove_unmarked();
+    } else {
+        for (int i = 0; i < remembered_count; i++) scan_remembered(remembered[i]);
+        for (int i = 0; i < remembered_env_count; i++) mark_frame_values(remembered_envs[i]);
+    }
+    clear_remembered();
+
+    if (full) sweep_old();
+    sweep_young();
+    collecting_young = false;
+    gc_epoch++;
+
+    if (full) {
+        old_threshold = old_object_count < OLD_THRESHOLD_MIN / 2 ? OLD_THRESHOLD_MIN : old_object_count * 2;
+        pool_trim();
+    }
+}
+
+static void collect(bool full) {
+    collect_with_root(gc_root_env, full);
+}
+
+void gc_collect(Environment* root) {
+    collect_with_root(root, true);
+}
+
+void gc_print_stats(FILE* out) {
+    fprintf(out, "🍺 GCの統計だヨ😘\n");
+    fprintf(out, "  オブジェクト確保 %zu 個 / マイナーGC %zu 回 / フルGC %zu 回\n",
+            objects_allocated, minor_collections, full_collections);
 }
@@ -1,15 +1,93 @@
 #ifndef OJISAN_GC_H
 #define OJISAN_GC_H
 
+#include <stddef.h>
+#include <stdio.h>
 #include "value.h"
 #include "env.h"
 
+extern unsigned int gc_epoch;
+
+typedef struct {
+    int temps;
+    int frames;
+} GcRootMark;
+
+extern Value* gc_temp_roots;
+extern int gc_temp_root_count;
+extern int gc_temp_root_capacity;
+extern Environment** gc_frame_roots;
+extern int gc_frame_root_count;
+extern int gc_frame_root_capacity;
+
 void gc_init(void);
 void gc_set_root(Environment* root);
+void* gc_allocate(size_t size);
 void gc_register_new_object(Obj* obj);
 void gc_collect(Environment* root);
+void gc_print_stats(FILE* out);
 void gc_mark_obj(Obj* obj);
 void gc_mark_value(Value value);
 void gc_mark_env(Environment* env);
+void gc_remember(Obj* obj);
+void gc_remember_env(Environment* env);
+void gc_forget_env(Environment* env);
+void gc_remember_card(Obj* owner, CardTable* cards, int index, int span);
+void gc_dict_write_barrier(ObjDict* dict, ObjString* key, Value value);
+void gc_grow_temp_roots(void);
+void gc_grow_frame_roots(void);
+
+static inline void gc_push_root(Value value) {
+    if (gc_temp_root_count == gc_temp_root_capacity) gc_grow_temp_roots();
+    gc_temp_roots[gc_temp_root_count++] = value;
+}
+
+static inline void gc_pop_roots(int count) {
+    gc_temp_root_count -= count;
+}
+
+static inline void gc_push_frame_root(Environment* env) {
+    if (gc_frame_root_count == gc_frame_root_capacity) gc_grow_frame_roots();
+    gc_frame_roots[gc_frame_root_count++] = env;
+}
+
+static inline void gc_pop_frame_root(void) {
+    gc_frame_root_count--;
+}
+
+static inline GcRootMark gc_root_mark(void) {
+    return (GcRootMark){gc_temp_root_count, gc_frame_root_count};
+}
+
+static inline void gc_root_reset(GcRootMark mark) {
+    gc_temp_root_count = mark.temps;
+    gc_frame_root_count = mark.frames;
+}
+
+static inline bool gc_is_young(Value value) {
+    if (IS_OBJ(value)) return !AS_OBJ(value)->is_old;
+#ifdef NAN_BOXING
+    if (IS_BOXED_INT(value)) return !AS_BOXED_INT(value)->obj.is_old;
+#endif
+    return false;
+}
+
+static inline void gc_write_barrier(Obj* owner, Value value) {
+    if (owner->is_old && !owner->is_remembered && gc_is_young(value)) gc_remember(owner);
+}
+
+static inline void gc_list_write_barrier(ObjList* list, int index, Value value) {
+    if (list->obj.is_old && gc_is_young(value)) gc_remember_card(&list->obj, &list->cards, index, 0);
+}
+
+static inline void gc_list_moved_items(ObjList* list) {
+    if (list->obj.is_remembered) list->cards.span = -1;
+}
+
+static inline void gc_env_write_barrier(Environment* env, Value value) {
+    if (!env->on_stack && env->epoch != gc_epoch && env->remembered_index < 0 && gc_is_young(value)) {
+        gc_remember_env(env);
+    }
+}
 
 #endif 
@@ -1,188 +1,97 @@
 #include "lexer.h"
 #include "utf8.h"
+#include "keyword_dfa.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
 
 typedef struct {
+    const char* source;
     const char* start;
     const char* current;
     int line;
 } Lexer;
 
-Lexer lexer;
-
-
-typedef struct {
-    const char* pattern;
-    TokenType type;
-} KeywordEntry;
-
-
-static const KeywordEntry keywords[] = {
-    {"まで関係あるんだけどサ😁",   TOK_MADE_KANKEI},
-    {"のメンバーなんだけどサ😁",   TOK_NO_MEMBER},
-    {"チャンのやり方教えるネ😘",   TOK_YARIKATA},
-    {"サンのコト教えるヨ😃",       TOK_SAN_KOTO},
-    {"サンのコトおしまい❗",        TOK_SAN_KOTO_OSHIMAI},
-    {"チャンにオネガイ😃",         TOK_ONEGAI},
-    {"チョット教えてヨ😃",         TOK_OSHIETE_YO},
-    {"チョット聞いてヨ😃",         TOK_CHOTTO_KIITE},
-    {"気になるんだけど😚",         TOK_KININARU},
-    {"ハジメマシテおしまい❗",      TOK_HAJIME_OSHIMAI},
-    {"ニナッチャッタ😅💦",         TOK_NI_NACCHATTA},
-    {"ドキドキおしまい❗",          TOK_DOKIDOKI_OSHIMAI},
-    {"ドキドキするけど😅💦",       TOK_DOKIDOKI},
-    {"やり方おしまい❗",            TOK_YARIKATA_OSHIMAI},
-    {"ソウジャナカッタラ😅",       TOK_SOUJANAKATTARA},
-    {"ドッチニシテモ😤",           TOK_DOCCHI_NI_SHITEMO},
-    {"ハジメマシテ😘",             TOK_HAJIMEMASHITE},
-    {"取り寄せてヨ😃",             TOK_TORIYOSE},
-    {"サンを作るヨ😃",             TOK_SAN_WO_TSUKURU},
-    {"数字にしてネ😘",             TOK_SUUJI_NI},
-    {"文字にしてネ😘",             TOK_MOJI_NI},
-    {"型を教えてヨ😃",             TOK_KATA_WO},
-    {"長さを教えてヨ😃",           TOK_NAGASA_WO},
-    {"ランダムチャン😃",           TOK_RANDOM_CHAN},
-    {"もしかして😍",               TOK_MOSHIKASHITE},
-    {"ナンチャッテ😃",             TOK_NANCHATTE},
-    {"ちがうカナ❓",                TOK_CHIGAU_KANA},
-    {"おなじカナ❓",                TOK_ONAJI_KANA},
-    {"もういいカナ😤",             TOK_MOU_II},
-    {"ヤバかった😱",               TOK_YABAKATTA},
-    {"を追加ダヨ😁",               TOK_WO_TSUIKA},
-    {"次イコウヨ😃",               TOK_TSUGI_IKOU},
-    {"の間はネ😘",                 TOK_AIDA_WA},
-    {"もうムリ😱💦",               TOK_MOU_MURI},
-    {"ツブヤキ📱",                 TOK_TSUBUYAKI},
-    {"オッハー❗",                  TOK_OHHA},
-    {"オッケー👍",                 TOK_OKKEE},
-    {"の長さチャン",               TOK_NAGASA_CHAN},
-    {"番目チャンは",               TOK_BANME_CHAN_WA},
-    {"番目チャン",                 TOK_BANME_CHAN},
-    {"チガウヨ",                   TOK_CHIGAU_YO},
-    {"より上❗",                    TOK_YORI_UE},
-    {"より下❗",                    TOK_YORI_SHITA},
-    {"コタエは",                    TOK_KOTAE},
-    {"ダヨ😁",                     TOK_DA_YO},
-    {"ナンダ😘",                   TOK_NANDA},
-    {"ナイナイ",                    TOK_NAI_NAI},
-    {"もしくは",                    TOK_MOSHIKUWA},
-    {"以上❗",                      TOK_IJOU},
-    {"以下❗",                      TOK_IKA},
-    {"ボクの",                      TOK_BOKU_NO},
-    {"しかも",                      TOK_SHIKAMO},
-    {"かける",                      TOK_KAKERU},
-    {"カナ❓",                      TOK_KANA},
-    {"チャンは",                    TOK_CHAN_WA},
-    {"チャンが",                    TOK_CHAN_GA},
-    {"チャンに",                    TOK_CHAN_NI},
-    {"あまり",                      TOK_AMARI},
-    {"マイナス",                    TOK_MAINASU},
-    {"マジ",                        TOK_MAJI},
-    {"チャン",                      TOK_CHAN},
-    {"ひく",                        TOK_HIKU},
-    {"わる",                        TOK_WARU},
-    {"から",                        TOK_KARA},
-    {"ウソ",                        TOK_USO},
-    {"と",                          TOK_TO},
-    {"の",                          TOK_NO},
-    {"、",                          TOK_COMMA},
-    {"→",                          TOK_ARROW},
-    {"【",                          TOK_LBRACKET},
-    {"】",                          TOK_RBRACKET},
-    {"《",                          TOK_LDICT},
-    {"》",                          TOK_RDICT},
-    {"(",                           TOK_LPAREN},
-    {")",                           TOK_RPAREN},
-    {NULL, 0}
+static const char* const error_messages[] = {
+    "文字列が閉じてないヨ😅💦",
+    "ナニコレ？読めないヨ😅💦",
 };
 
-void lexer_init(const char* source) {
-    lexer.start = source;
-    lexer.current = source;
-    lexer.line = 1;
-}
-
-LexerState lexer_save_state(void) {
-    LexerState state;
-    state.start = lexer.start;
-    state.current = lexer.current;
-    state.line = lexer.line;
-    return state;
+static bool is_at_end(Lexer* lexer) {
+    return *lexer->current == '\0';
 }
 
-void lexer_restore_state(LexerState state) {
-    lexer.start = state.start;
-    lexer.current = state.current;
-    lexer.line = state.line;
-}
-
-static bool is_at_end() {
-    return *lexer.current == '\0';
-}
-
-static Token make_token(TokenType type) {
-    Token token;
-    token.type = type;
-    token.start = lexer.start;
-    token.length = (int)(lexer.current - lexer.start);
-    token.line = lexer.line;
+static PackedToken make_token(Lexer* lexer, TokenType type) {
+    PackedToken token;
+    token.type = (unsigned char)type;
+    token.offset = (unsigned int)(lexer->start - lexer->source);
+    token.length = (unsigned int)(lexer->current - lexer->start);
+    token.line = lexer->line;
     return token;
 }
 
-static Token error_token(const char* message) {
-    Token token;
+static PackedToken error_token(Lexer* lexer, int message) {
+    PackedToken token;
     token.type = TOK_ERROR;
-    token.start = message;
-    token.length = (int)strlen(message);
-    token.line = lexer.line;
+    token.offset = (unsigned int)message;
+    token.length = (unsigned int)strlen(error_messages[message]);
+    token.line = lexer->line;
     return token;
 }
 
-static bool match_keyword(TokenType* out_type) {
-    for (int i = 0; keywords[i].pattern != NULL; i++) {
-        int len = strlen(keywords[i].pattern);
-        if (memcmp(lexer.start, keywords[i].pattern, len) == 0) {
-            
-            
-            lexer.current = lexer.start + len;
-            *out_type = keywords[i].type;
-            return true;
+static bool match_keyword(const char* start, TokenType* out_type, int* out_len) {
+    const unsigned char* p = (const unsigned char*)start;
+    int state = keyword_root[p[0]];
+    int matched = 0;
+    for (int len = 1; state != 0; len++) {
+        const KeywordState* s = &keyword_states[state];
+        if (s->accept != TOK_ERROR) {
+            *out_type = s->accept;
+            matched = len;
+        }
+        int next = 0;
+        for (int e = s->first_edge; e < s->first_edge + s->edge_count; e++) {
+            if (keyword_edge_bytes[e] >= p[len]) {
+                if (keyword_edge_bytes[e] == p[len]) next = keyword_edge_targets[e];
+                break;
+            }
         }
+        state = next;
     }
-    return false;
+    *out_len = matched;
+    return matched > 0;
 }
 
-Token lexer_scan_token() {
+static PackedToken scan_token(Lexer* lexer) {
     
     for (;;) {
         Codepoint cp;
-        const char* p = lexer.current;
+        const char* p = lexer->current;
         int w = utf8_decode(p, &cp);
         if (w == 0) break;
 
         if (cp == ' ' || cp == '\r' || cp == '\t' || cp == 0x3000 ) {
-            lexer.current += w;
+            lexer->current += w;
         } else if (cp == '\n') {
-            lexer.line++;
-            lexer.current += w;
+            lexer->line++;
+            lexer->current += w;
         } else {
             
             
-            if (strncmp(lexer.current, "（ココだけの話…", strlen("（ココだけの話…")) == 0) {
+            if (strncmp(lexer->current, "（ココだけの話…", strlen("（ココだけの話…")) == 0) {
                 
-                lexer.current += strlen("（ココだけの話…");
-                while (!is_at_end()) {
-                    w = utf8_decode(lexer.current, &cp);
-                    if (cp == '\n') lexer.line++;
-                    if (memcmp(lexer.current, "）", 3) == 0) { 
+                lexer->current += strlen("（ココだけの話…");
+                while (!is_at_end(lexer)) {
+                    w = utf8_decode(lexer->current, &cp);
+                    if (cp == '\n') lexer->line++;
+                    if (strncmp(lexer->current, "）", 3) == 0) { 
                          
                          
-                        lexer.current += strlen("）");
+                        lexer->current += strlen("）");
                         break;
                     }
-                    lexer.current += w;
+                    lexer->current += w;
                 }
             } else {
                 break;
@@ -190,54 +99,56 @@ Token lexer_scan_token() {
         }
     }
 
-    lexer.start = lexer.current;
+    lexer->start = lexer->current;
 
-    if (is_at_end()) return make_token(TOK_EOF);
+    if (is_at_end(lexer)) return make_token(lexer, TOK_EOF);
 
     
     TokenType type;
-    if (match_keyword(&type)) {
-        return make_token(type);
+    int keyword_len;
+    if (match_keyword(lexer->start, &type, &keyword_len)) {
+        lexer->current = lexer->start + keyword_len;
+        return make_token(lexer, type);
     }
 
     
     {
         Codepoint cp;
-        int w = utf8_decode(lexer.current, &cp);
+        int w = utf8_decode(lexer->current, &cp);
         if (utf8_is_digit(cp)) {
             bool has_dot = false;
-            while (!is_at_end()) {
-                w = utf8_decode(lexer.current, &cp);
+            while (!is_at_end(lexer)) {
+                w = utf8_decode(lexer->current, &cp);
                 if (utf8_is_digit(cp)) {
-                    lexer.current += w;
+                    lexer->current += w;
                 } else if (cp == '.' && !has_dot) {
                      has_dot = true;
-                     lexer.current++; 
+                     lexer->current++; 
                 } else {
                     break;
                 }
             }
-            return make_token(TOK_NUMBER);
+            return make_token(lexer, TOK_NUMBER);
         }
     }
 
     
-    if (memcmp(lexer.current, "「", 3) == 0) {
-         lexer.current += 3;
-         while (!is_at_end()) {
-             if (*lexer.current == '\\') {
+    if (strncmp(lexer->current, "「", 3) == 0) {
+         lexer->current += 3;
+         while (!is_at_end(lexer)) {
+             if (*lexer->current == '\\') {
                  
-                 lexer.current++;
-                 if (!is_at_end()) lexer.current++;
-             } else if (memcmp(lexer.current, "」", 3) == 0) {
-                 lexer.current += 3;
-                 return make_token(TOK_STRING);
+                 lexer->current++;
+                 if (!is_at_end(lexer)) lexer->current++;
+             } else if (strncmp(lexer->current, "」", 3) == 0) {
+                 lexer->current += 3;
+                 return make_token(lexer, TOK_STRING);
              } else {
-                 if (*lexer.current == '\n') lexer.line++;
-                 lexer.current++;
+                 if (*lexer->current == '\n') lexer->line++;
+                 lexer->current++;
              }
          }
-         return error_token("文字列が閉じてないヨ😅💦");
+         return error_token(lexer, 0);
     }
 
     
@@ -245,37 +156,66 @@ Token lexer_scan_token() {
 
     
     Codepoint cp;
-    int w = utf8_decode(lexer.current, &cp);
+    int w = utf8_decode(lexer->current, &cp);
     if (utf8_is_alnum(cp) || cp > 0x7F) { 
-        while (!is_at_end()) {
-             
-             
-             TokenType dummy;
-             const char* saved_start = lexer.start;
-             lexer.start = lexer.current; 
-             bool is_keyword = match_keyword(&dummy);
-             lexer.start = saved_start;   
-             lexer.current = lexer.start + len; 
-             
-             if (is_keyword && dummy != TOK_NO && dummy != TOK_TO) {
-                 
-                 
-                 break;
-             }
-             
-             w = utf8_decode(lexer.current, &cp);
-             if (utf8_is_space(cp)) break; 
-             
-             lexer.current += w;
-             len += w;
+        while (!is_at_end(lexer)) {
+            if (match_keyword(lexer->current, &type, &keyword_len) && type != TOK_NO && type != TOK_TO) {
+                break;
+            }
+
+            w = utf8_decode(lexer->current, &cp);
+            if (utf8_is_space(cp)) break;
+
+            lexer->current += w;
+            len += w;
         }
         
         if (len > 0) {
-            return make_token(TOK_IDENTIFIER);
+            return make_token(lexer, TOK_IDENTIFIER);
         }
     }
 
     
-    lexer.current++;
-    return error_token("ナニコレ？読めないヨ😅💦");
+    lexer->current++;
+    return error_token(lexer, 1);
+}
+
+void lexer_tokenize(TokenBuffer* buffer, const char* source) {
+    Lexer lexer;
+    lexer.source = source;
+    lexer.start = source;
+    lexer.current = source;
+    lexer.line = 1;
+
+    size_t length = strlen(source);
+    buffer->source = source;
+    buffer->count = 0;
+    buffer->capacity = length / 8 + 16;
+    buffer->tokens = malloc(sizeof(PackedToken) * buffer->capacity);
+    for (;;) {
+        if (buffer->count == buffer->capacity) {
+            buffer->capacity *= 2;
+            buffer->tokens = realloc(buffer->tokens, sizeof(PackedToken) * buffer->capacity);
+        }
+        PackedToken token = scan_token(&lexer);
+        buffer->tokens[buffer->count++] = token;
+        if (token.type == TOK_EOF) break;
+    }
+}
+
+Token token_buffer_get(const TokenBuffer* buffer, int index) {
+    const PackedToken* packed = &buffer->tokens[index];
+    Token token;
+    token.type = (TokenType)packed->type;
+    token.start = packed->type == TOK_ERROR ? error_messages[packed->offset] : buffer->source + packed->offset;
+    token.length = (int)packed->length;
+    token.line = packed->line;
+    return token;
+}
+
+void token_buffer_free(TokenBuffer* buffer) {
+    free(buffer->tokens);
+    buffer->tokens = NULL;
+    buffer->count = 0;
+    buffer->capacity = 0;
 }
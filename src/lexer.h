@@ -3,17 +3,15 @@
 
 #include "token.h"
 
-void lexer_init(const char* source);
-Token lexer_scan_token(void);
-
-
 typedef struct {
-    const char* start;
-    const char* current;
-    int line;
-} LexerState;
+    const char* source;
+    PackedToken* tokens;
+    int count;
+    int capacity;
+} TokenBuffer;
 
-LexerState lexer_save_state(void);
-void lexer_restore_state(LexerState state);
+void lexer_tokenize(TokenBuffer* buffer, const char* source);
+Token token_buffer_get(const TokenBuffer* buffer, int index);
+void token_buffer_free(TokenBuffer* buffer);
 
 #endif 
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <time.h>
 
 #include "lexer.h"
 #include "parser.h"
@@ -9,6 +10,14 @@
 #include "utf8.h"
 #include "builtins.h"
 #include "gc.h"
+#include "vm.h"
+#include "resolver.h"
+#include "pool.h"
+#include "source.h"
+#include "version.h"
+#include "modcache.h"
+#include "optimizer.h"
+#include "sort.h"
 
 #ifdef _WIN32
 #include <io.h>
@@ -31,6 +40,10 @@ __declspec(dllimport) int __stdcall WideCharToMultiByte(unsigned int, DWORD, con
 #endif
 
 
+static bool use_walker = false;
+static bool show_mem_stats = false;
+static bool lex_only = false;
+
 void run_file(const char* path);
 void run_repl();
 
@@ -50,39 +63,53 @@ int main(int argc, char* argv[]) {
     }
 #endif
     
-    if (argc == 1) {
+    const char* path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--walker") == 0) {
+            use_walker = true;
+        } else if (strcmp(argv[i], "--dump-bytecode") == 0) {
+            vm_set_dump_bytecode(true);
+        } else if (strcmp(argv[i], "--dump-ast") == 0) {
+            optimizer_set_dump(true);
+        } else if (strcmp(argv[i], "--mem-stats") == 0) {
+            show_mem_stats = true;
+        } else if (strcmp(argv[i], "--no-cache") == 0) {
+            module_cache_set_enabled(false);
+        } else if (strcmp(argv[i], "--lex-only") == 0) {
+            lex_only = true;
+        } else if (strcmp(argv[i], "--sort-threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            sort_set_workers(atoi(argv[++i]));
+        } else if (path == NULL && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "使い方だヨ😘: ojisan [--walker] [--dump-bytecode] [--dump-ast] [--no-cache] [--mem-stats] [--lex-only] [--sort-threads 数] [ファイル]\n");
+            return 64;
+        }
+    }
+
+    if (path == NULL) {
         run_repl();
-    } else if (argc == 2) {
-        run_file(argv[1]);
     } else {
-        fprintf(stderr, "使い方だヨ😘: ojisan [ファイル]\n");
-        return 64;
+        run_file(path);
+    }
+    if (show_mem_stats) {
+        pool_print_stats(stderr);
+        gc_print_stats(stderr);
     }
     return 0;
 }
 
-static char* read_file(const char* path) {
-    FILE* file = fopen(path, "rb");
-    if (file == NULL) {
-        fprintf(stderr, "ファイルが開けないヨ😅💦 \"%s\"\n", path);
-        exit(74);
-    }
-    
-    fseek(file, 0L, SEEK_END);
-    size_t fileSize = ftell(file);
-    rewind(file);
-    
-    char* buffer = (char*)malloc(fileSize + 1);
-    if (buffer == NULL) {
-        fprintf(stderr, "メモリが足りないヨ😱💦\n");
-        exit(74);
-    }
-    
-    size_t bytesRead = fread(buffer, sizeof(char), fileSize, file);
-    buffer[bytesRead] = '\0';
-    
-    fclose(file);
-    return buffer;
+static void run_lexer_only(const char* source) {
+    size_t bytes = strlen(source);
+    TokenBuffer tokens;
+    clock_t start = clock();
+    lexer_tokenize(&tokens, source);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double megabytes = bytes / (1024.0 * 1024.0);
+    printf("🍺 字句解析だけやったヨ😘: %d トークン / %.2f MB / %.1f ms", tokens.count, megabytes, seconds * 1000.0);
+    if (seconds > 0) printf(" (%.1f MB/s)", megabytes / seconds);
+    printf("\n");
+    token_buffer_free(&tokens);
 }
 
 void run_file(const char* path) {
@@ -91,20 +118,33 @@ void run_file(const char* path) {
         fprintf(stderr, "おじさんは「.ojs」か「.oji」ファイルしか読めないヨ😅💦: \"%s\"\n", path);
         exit(65);
     }
-    char* source = read_file(path);
-    interpret(source);
-    free(source);
+    SourceFile source;
+    if (!source_open(&source, path)) {
+        fprintf(stderr, "ファイルが開けないヨ😅💦 \"%s\"\n", path);
+        exit(74);
+    }
+    if (lex_only) {
+        run_lexer_only(source.text);
+    } else if (use_walker) {
+        interpret(source.text);
+    } else {
+        vm_interpret(source.text);
+    }
+    source_close(&source);
 }
 
 void run_repl() {
     char line[1024];
-    printf("🍺 Ojisan言語 v1.0.0 🍺\n");
+    printf("🍺 Ojisan言語 v" OJISAN_VERSION " 🍺\n");
     printf("オッハー❗😃 おじさんに話しかけてヨ😘（「ジャアネ😘👋」で終了ダヨ）\n");
 
     gc_init();
-    Environment* global = env_new(NULL);
-    register_builtins(global);
-    gc_set_root(global); 
+    Environment* global = NULL;
+    if (use_walker) {
+        global = eval_new_global();
+    } else {
+        vm_init();
+    }
 
     for (;;) {
         printf("おじさん😃> ");
@@ -150,9 +190,20 @@ void run_repl() {
         
         AstNode* prog = parse_program(line);
         if (prog) {
-            evaluate(prog, global);
+            if (use_walker) {
+                int constant_mark = eval_constant_mark();
+                resolve_program(prog);
+                evaluate(prog, global);
+                eval_release_constants(constant_mark);
+            } else {
+                vm_run(prog);
+            }
             ast_free(prog); 
         }
     }
-    env_release(global);
+    if (use_walker) {
+        env_release(global);
+    } else {
+        vm_free();
+    }
 }
@@ -0,0 +1,376 @@
+#include "modcache.h"
+#include "chunk.h"
+#include "gc.h"
+#include "source.h"
+#include "version.h"
+#include "fingerprint.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define make_dir(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define make_dir(path) mkdir(path, 0755)
+#endif
+
+#define CACHE_MAGIC "OJC\x1a"
+#define CACHE_FORMAT 4
+#define NO_NAME 0xffffffffu
+
+typedef enum {
+    CONST_INT,
+    CONST_FLOAT,
+    CONST_STRING,
+    CONST_FUNC
+} ConstantTag;
+
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+} Writer;
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+} Reader;
+
+static bool cache_enabled = true;
+
+void module_cache_set_enabled(bool enabled) {
+    cache_enabled = enabled;
+}
+
+static uint64_t hash_bytes(const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool cache_dir(char* out, size_t size) {
+    const char* dir = getenv("OJISAN_CACHE_DIR");
+    if (dir != NULL && dir[0] != '\0') {
+        snprintf(out, size, "%s", dir);
+        return true;
+    }
+    const char* base = getenv("XDG_CACHE_HOME");
+    if (base != NULL && base[0] != '\0') {
+        snprintf(out, size, "%s/ojisan", base);
+        return true;
+    }
+    base = getenv("HOME");
+    if (base != NULL && base[0] != '\0') {
+        snprintf(out, size, "%s/.cache/ojisan", base);
+        return true;
+    }
+    base = getenv("LOCALAPPDATA");
+    if (base != NULL && base[0] != '\0') {
+        snprintf(out, size, "%s/ojisan", base);
+        return true;
+    }
+    return false;
+}
+
+static bool cache_path(char* out, size_t size, uint64_t hash) {
+    char dir[1024];
+    if (!cache_dir(dir, sizeof(dir))) return false;
+    int written = snprintf(out, size, "%s/%016llx.ojc", dir, (unsigned long long)hash);
+    return written > 0 && (size_t)written < size;
+}
+
+static void ensure_dir(const char* path) {
+    char buffer[1024];
+    snprintf(buffer, sizeof(buffer), "%s", path);
+    for (char* p = buffer + 1; *p; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            make_dir(buffer);
+            *p = '/';
+        }
+    }
+    make_dir(buffer);
+}
+
+
+static void write_bytes(Writer* w, const void* bytes, size_t count) {
+    if (w->size + count > w->capacity) {
+        while (w->size + count > w->capacity) w->capacity = w->capacity < 256 ? 256 : w->capacity * 2;
+        w->data = realloc(w->data, w->capacity);
+    }
+    memcpy(w->data + w->size, bytes, count);
+    w->size += count;
+}
+
+static void write_u8(Writer* w, uint8_t value) {
+    write_bytes(w, &value, 1);
+}
+
+static void write_u32(Writer* w, uint32_t value) {
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; i++) bytes[i] = (uint8_t)(value >> (8 * i));
+    write_bytes(w, bytes, 4);
+}
+
+static void write_u64(Writer* w, uint64_t value) {
+    write_u32(w, (uint32_t)value);
+    write_u32(w, (uint32_t)(value >> 32));
+}
+
+static void write_string(Writer* w, const char* chars, uint32_t length) {
+    write_u32(w, length);
+    write_bytes(w, chars, length);
+}
+
+static void write_function(Writer* w, ObjFunc* function) {
+    if (function->name != NULL) {
+        write_string(w, function->name, (uint32_t)strlen(function->name));
+    } else {
+        write_u32(w, NO_NAME);
+    }
+    write_u32(w, (uint32_t)function->param_count);
+    write_u32(w, (uint32_t)function->upvalue_count);
+
+    Chunk* chunk = function->chunk;
+    write_u32(w, (uint32_t)chunk->count);
+    write_bytes(w, chunk->code, (size_t)chunk->count);
+
+    uint32_t runs = 0;
+    for (int i = 0; i < chunk->count; i++) {
+        if (i == 0 || chunk->lines[i] != chunk->lines[i - 1]) runs++;
+    }
+    write_u32(w, runs);
+    for (int i = 0; i < chunk->count;) {
+        int start = i;
+        while (i < chunk->count && chunk->lines[i] == chunk->lines[start]) i++;
+        write_u32(w, (uint32_t)chunk->lines[start]);
+        write_u32(w, (uint32_t)(i - start));
+    }
+
+    write_u32(w, (uint32_t)chunk->cache_count);
+    write_u32(w, (uint32_t)chunk->const_count);
+    for (int i = 0; i < chunk->const_count; i++) {
+        Value value = chunk->constants[i];
+        if (IS_INT(value)) {
+            write_u8(w, CONST_INT);
+            write_u64(w, (uint64_t)AS_INT(value));
+        } else if (IS_FLOAT(value)) {
+            double number = AS_FLOAT(value);
+            uint64_t bits;
+            memcpy(&bits, &number, sizeof(bits));
+            write_u8(w, CONST_FLOAT);
+            write_u64(w, bits);
+        } else if (IS_OBJ(value) && AS_OBJ(value)->type == OBJ_STRING) {
+            ObjString* string = (ObjString*)AS_OBJ(value);
+            write_u8(w, CONST_STRING);
+            write_string(w, string->chars, (uint32_t)string->length);
+        } else {
+            write_u8(w, CONST_FUNC);
+            write_function(w, (ObjFunc*)AS_OBJ(value));
+        }
+    }
+}
+
+static void write_header(Writer* w, uint64_t hash, size_t length) {
+    write_bytes(w, CACHE_MAGIC, 4);
+    write_u32(w, CACHE_FORMAT);
+    write_u32(w, OP_FAIL + 1);
+    write_string(w, OJISAN_VERSION, (uint32_t)strlen(OJISAN_VERSION));
+    write_u64(w, CODEGEN_FINGERPRINT);
+    write_u64(w, hash);
+    write_u64(w, (uint64_t)length);
+}
+
+
+static const unsigned char* read_bytes(Reader* r, size_t count) {
+    if (!r->ok || r->size - r->pos < count) {
+        r->ok = false;
+        return NULL;
+    }
+    const unsigned char* bytes = r->data + r->pos;
+    r->pos += count;
+    return bytes;
+}
+
+static uint8_t read_u8(Reader* r) {
+    const unsigned char* bytes = read_bytes(r, 1);
+    return bytes ? bytes[0] : 0;
+}
+
+static uint32_t read_u32(Reader* r) {
+    const unsigned char* bytes = read_bytes(r, 4);
+    if (bytes == NULL) return 0;
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint64_t read_u64(Reader* r) {
+    uint64_t low = read_u32(r);
+    uint64_t high = read_u32(r);
+    return low | (high << 32);
+}
+
+static ObjFunc* read_function(Reader* r, int depth) {
+    if (depth > 256) {
+        r->ok = false;
+        return NULL;
+    }
+    uint32_t name_length = read_u32(r);
+    char* name = NULL;
+    if (name_length != NO_NAME) {
+        const unsigned char* chars = read_bytes(r, name_length);
+        if (chars == NULL) return NULL;
+        name = malloc(name_length + 1);
+        memcpy(name, chars, name_length);
+        name[name_length] = '\0';
+    }
+    int arity = (int)read_u32(r);
+    int upvalue_count = (int)read_u32(r);
+    if (upvalue_count < 0 || upvalue_count > 256) {
+        r->ok = false;
+        return NULL;
+    }
+    ObjFunc* function = new_compiled_function(name, arity);
+    free(name);
+    function->upvalue_count = upvalue_count;
+    gc_push_root(OBJ_VAL(function));
+
+    Chunk* chunk = function->chunk;
+    uint32_t code_count = read_u32(r);
+    const unsigned char* code = read_bytes(r, code_count);
+    if (code != NULL && code_count > 0) {
+        chunk->code = malloc(code_count);
+        chunk->lines = malloc(sizeof(int) * code_count);
+        memcpy(chunk->code, code, code_count);
+        chunk->count = (int)code_count;
+        chunk->capacity = (int)code_count;
+    }
+
+    uint32_t runs = read_u32(r);
+    uint32_t filled = 0;
+    for (uint32_t i = 0; i < runs && r->ok; i++) {
+        int line = (int)read_u32(r);
+        uint32_t count = read_u32(r);
+        if (count > code_count - filled) {
+            r->ok = false;
+            break;
+        }
+        for (uint32_t j = 0; j < count; j++) chunk->lines[filled++] = line;
+    }
+    if (filled != code_count) r->ok = false;
+
+    uint32_t cache_count = read_u32(r);
+    for (uint32_t i = 0; i < cache_count && r->ok; i++) chunk_add_cache(chunk);
+
+    uint32_t const_count = read_u32(r);
+    for (uint32_t i = 0; i < const_count && r->ok; i++) {
+        Value value = NULL_VAL;
+        switch (read_u8(r)) {
+            case CONST_INT:
+                value = INT_VAL((long long)read_u64(r));
+                break;
+            case CONST_FLOAT: {
+                uint64_t bits = read_u64(r);
+                double number;
+                memcpy(&number, &bits, sizeof(number));
+                value = FLOAT_VAL(number);
+                break;
+            }
+            case CONST_STRING: {
+                uint32_t length = read_u32(r);
+                const unsigned char* chars = read_bytes(r, length);
+                if (chars != NULL) value = OBJ_VAL(copy_string_value((const char*)chars, (int)length));
+                break;
+            }
+            case CONST_FUNC: {
+                ObjFunc* nested = read_function(r, depth + 1);
+                if (nested != NULL) value = OBJ_VAL(nested);
+                break;
+            }
+            default:
+                r->ok = false;
+                break;
+        }
+        if (!r->ok) break;
+        gc_write_barrier(&function->obj, value);
+        chunk_add_constant(chunk, value);
+    }
+
+    if (r->ok && !chunk_verify(chunk, upvalue_count)) r->ok = false;
+    gc_pop_roots(1);
+    return r->ok ? function : NULL;
+}
+
+
+ObjFunc* module_cache_load(const char* source, size_t length) {
+    if (!cache_enabled) return NULL;
+    uint64_t hash = hash_bytes(source, length);
+    char path[1200];
+    if (!cache_path(path, sizeof(path), hash)) return NULL;
+
+    SourceFile file;
+    if (!source_open(&file, path)) return NULL;
+
+    Reader r = {(const unsigned char*)file.text, file.length, 0, true};
+    const unsigned char* magic = read_bytes(&r, 4);
+    bool valid = magic != NULL && memcmp(magic, CACHE_MAGIC, 4) == 0
+        && read_u32(&r) == CACHE_FORMAT
+        && read_u32(&r) == OP_FAIL + 1;
+    if (valid) {
+        uint32_t version_length = read_u32(&r);
+        const unsigned char* version = read_bytes(&r, version_length);
+        valid = version != NULL && version_length == strlen(OJISAN_VERSION)
+            && memcmp(version, OJISAN_VERSION, version_length) == 0
+            && read_u64(&r) == CODEGEN_FINGERPRINT
+            && read_u64(&r) == hash
+            && read_u64(&r) == (uint64_t)length;
+    }
+
+    if (valid && r.size - r.pos >= 8) {
+        r.size -= 8;
+        Reader tail = {r.data, file.length, r.size, true};
+        valid = read_u64(&tail) == hash_bytes(r.data + r.pos, r.size - r.pos);
+    } else {
+        valid = false;
+    }
+
+    ObjFunc* function = valid ? read_function(&r, 0) : NULL;
+    if (function != NULL && r.pos != r.size) function = NULL;
+    source_close(&file);
+    return function;
+}
+
+void module_cache_store(const char* source, size_t length, ObjFunc* function) {
+    if (!cache_enabled || function == NULL) return;
+    uint64_t hash = hash_bytes(source, length);
+    char dir[1024];
+    char path[1200];
+    char temp[1300];
+    if (!cache_dir(dir, sizeof(dir)) || !cache_path(path, sizeof(path), hash)) return;
+    ensure_dir(dir);
+
+    Writer w = {NULL, 0, 0};
+    write_header(&w, hash, length);
+    size_t body = w.size;
+    write_function(&w, function);
+    write_u64(&w, hash_bytes(w.data + body, w.size - body));
+
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+    FILE* file = fopen(temp, "wb");
+    if (file == NULL) {
+        free(w.data);
+        return;
+    }
+    bool written = fwrite(w.data, 1, w.size, file) == w.size;
+    written = fclose(file) == 0 && written;
+    free(w.data);
+    if (!written || rename(temp, path) != 0) remove(temp);
+}
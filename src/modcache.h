@@ -0,0 +1,14 @@
+#ifndef OJISAN_MODCACHE_H
+#define OJISAN_MODCACHE_H
+
+#include "value.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+void module_cache_set_enabled(bool enabled);
+
+
+ObjFunc* module_cache_load(const char* source, size_t length);
+void module_cache_store(const char* source, size_t length, ObjFunc* function);
+
+#endif
@@ -0,0 +1,84 @@
+#include "module.h"
+#include "hashtable.h"
+#include "gc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define canonical_path(path, out) _fullpath(out, path, sizeof(out))
+#define PATH_MAX_LENGTH 4096
+#else
+#include <limits.h>
+#define PATH_MAX_LENGTH PATH_MAX
+#define canonical_path(path, out) realpath(path, out)
+#endif
+
+static HashTable* modules = NULL;
+static unsigned int sessions[2] = {1, 1};
+
+static void drop_units(Module* module) {
+    if (module->program) ast_free(module->program);
+    module->program = NULL;
+    module->function = NULL;
+}
+
+Module* module_lookup(const char* path) {
+    char resolved[PATH_MAX_LENGTH];
+    if (canonical_path(path, resolved) == NULL) return NULL;
+    struct stat st;
+    if (stat(resolved, &st) != 0) return NULL;
+
+    if (modules == NULL) modules = table_create();
+    void* found;
+    Module* module;
+    if (table_get(modules, resolved, &found)) {
+        module = (Module*)found;
+        if (module->mtime != (long long)st.st_mtime || module->size != (long long)st.st_size) {
+            module->stale = true;
+        }
+    } else {
+        module = calloc(1, sizeof(Module));
+        module->path = strdup(resolved);
+        table_set(modules, resolved, module);
+    }
+    module->mtime = (long long)st.st_mtime;
+    module->size = (long long)st.st_size;
+    return module;
+}
+
+bool module_claim(Module* module, ModuleUser user) {
+    if (module->loaded_session[user] == sessions[user]) return false;
+    module->loaded_session[user] = sessions[user];
+    if (module->stale) {
+        drop_units(module);
+        module->stale = false;
+    }
+    return true;
+}
+
+void module_begin_session(ModuleUser user) {
+    sessions[user]++;
+}
+
+static void forget_function(const char* key, void* value, void* userdata) {
+    (void)key;
+    (void)userdata;
+    ((Module*)value)->function = NULL;
+}
+
+void module_forget_functions(void) {
+    table_iterate(modules, forget_function, NULL);
+}
+
+static void mark_function(const char* key, void* value, void* userdata) {
+    (void)key;
+    (void)userdata;
+    Module* module = (Module*)value;
+    if (module->function) gc_mark_obj((Obj*)module->function);
+}
+
+void module_mark_roots(void) {
+    table_iterate(modules, mark_function, NULL);
+}
@@ -0,0 +1,32 @@
+#ifndef OJISAN_MODULE_H
+#define OJISAN_MODULE_H
+
+#include "ast.h"
+#include "value.h"
+#include <stdbool.h>
+
+typedef enum {
+    MODULE_WALKER,
+    MODULE_VM
+} ModuleUser;
+
+typedef struct Module {
+    char* path;
+    long long mtime;
+    long long size;
+    AstNode* program;
+    ObjFunc* function;
+    bool stale;
+    unsigned int loaded_session[2];
+} Module;
+
+
+Module* module_lookup(const char* path);
+bool module_claim(Module* module, ModuleUser user);
+void module_begin_session(ModuleUser user);
+
+
+void module_forget_functions(void);
+void module_mark_roots(void);
+
+#endif
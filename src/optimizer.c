@@ -0,0 +1,293 @@
+#include "optimizer.h"
+#include "value.h"
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+static Arena* arena = NULL;
+static bool dump_ast = false;
+
+void optimizer_set_dump(bool enabled) {
+    dump_ast = enabled;
+}
+
+static bool is_literal(AstNode* node) {
+    return node != NULL && node->type == AST_LITERAL;
+}
+
+static bool literal_truthy(AstNode* node) {
+    if (node->as.literal.type == LIT_NULL) return false;
+    if (node->as.literal.type == LIT_BOOL) return node->as.literal.b_val;
+    return true;
+}
+
+static bool literal_value(AstNode* node, Value* out) {
+    switch (node->as.literal.type) {
+        case LIT_INT: *out = INT_VAL(node->as.literal.i_val); return true;
+        case LIT_FLOAT: *out = FLOAT_VAL(node->as.literal.f_val); return true;
+        case LIT_BOOL: *out = BOOL_VAL(node->as.literal.b_val); return true;
+        case LIT_NULL: *out = NULL_VAL; return true;
+        case LIT_STR: return false;
+    }
+    return false;
+}
+
+static void set_bool(AstNode* node, bool value) {
+    node->type = AST_LITERAL;
+    node->as.literal.type = LIT_BOOL;
+    node->as.literal.b_val = value;
+}
+
+static bool set_value(AstNode* node, Value value) {
+    if (IS_INT(value)) {
+        long long i = AS_INT(value);
+        node->type = AST_LITERAL;
+        node->as.literal.type = LIT_INT;
+        node->as.literal.i_val = i;
+    } else if (IS_FLOAT(value)) {
+        double f = AS_FLOAT(value);
+        node->type = AST_LITERAL;
+        node->as.literal.type = LIT_FLOAT;
+        node->as.literal.f_val = f;
+    } else if (IS_BOOL(value)) {
+        set_bool(node, AS_BOOL(value));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static const char* literal_text(AstNode* node, char* buf, size_t size) {
+    Value value;
+    if (node->as.literal.type == LIT_STR) return node->as.literal.s_val;
+    literal_value(node, &value);
+    return value_concat_operand(value, buf, size);
+}
+
+static void fold_concat(AstNode* node, AstNode* left, AstNode* right) {
+    char lbuf[64], rbuf[64];
+    const char* ls = literal_text(left, lbuf, sizeof(lbuf));
+    const char* rs = literal_text(right, rbuf, sizeof(rbuf));
+    size_t ll = strlen(ls);
+    size_t rl = strlen(rs);
+    char* chars = arena_alloc(arena, ll + rl + 1);
+    memcpy(chars, ls, ll);
+    memcpy(chars + ll, rs, rl);
+    chars[ll + rl] = '\0';
+    node->type = AST_LITERAL;
+    node->as.literal.type = LIT_STR;
+    node->as.literal.s_val = chars;
+    node->as.literal.const_session = 0;
+}
+
+static void fold_binary(AstNode* node) {
+    TokenType op = node->as.binary.op;
+    AstNode* left = node->as.binary.left;
+    AstNode* right = node->as.binary.right;
+
+    if (op == TOK_SHIKAMO || op == TOK_MOSHIKUWA) {
+        if (!is_literal(left)) return;
+        bool truthy = literal_truthy(left);
+        if (op == TOK_SHIKAMO && !truthy) set_bool(node, false);
+        else if (op == TOK_MOSHIKUWA && truthy) set_bool(node, true);
+        else if (is_literal(right)) set_bool(node, literal_truthy(right));
+        return;
+    }
+    if (!is_literal(left) || !is_literal(right)) return;
+
+    bool left_str = left->as.literal.type == LIT_STR;
+    bool right_str = right->as.literal.type == LIT_STR;
+    if (left_str || right_str) {
+        if (op == TOK_TO) {
+            fold_concat(node, left, right);
+        } else if (op == TOK_ONAJI_KANA || op == TOK_CHIGAU_KANA) {
+            bool equal = left_str && right_str && strcmp(left->as.literal.s_val, right->as.literal.s_val) == 0;
+            set_bool(node, op == TOK_ONAJI_KANA ? equal : !equal);
+        }
+        return;
+    }
+
+    Value a, b, result;
+    literal_value(left, &a);
+    literal_value(right, &b);
+    if (value_binary_op(op, a, b, &result) != BINOP_OK) return;
+    set_value(node, result);
+}
+
+static void fold_unary(AstNode* node) {
+    AstNode* operand = node->as.unary.operand;
+    if (!is_literal(operand)) return;
+    if (node->as.unary.op == TOK_CHIGAU_YO) {
+        set_bool(node, !literal_truthy(operand));
+    } else if (node->as.unary.op == TOK_MAINASU) {
+        if (operand->as.literal.type == LIT_INT && operand->as.literal.i_val != LLONG_MIN) {
+            set_value(node, INT_VAL(-operand->as.literal.i_val));
+        } else if (operand->as.literal.type == LIT_FLOAT) {
+            set_value(node, FLOAT_VAL(-operand->as.literal.f_val));
+        }
+    }
+}
+
+
+static void optimize_expr(AstNode* node);
+static AstNode* optimize_stmt(AstNode* node);
+static void optimize_block(AstNode* block, bool prune_unreachable);
+
+static void optimize_list(AstNode** nodes, int count) {
+    for (int i = 0; i < count; i++) optimize_expr(nodes[i]);
+}
+
+static void optimize_expr(AstNode* node) {
+    if (!node) return;
+    switch (node->type) {
+        case AST_BINARY:
+            optimize_expr(node->as.binary.left);
+            optimize_expr(node->as.binary.right);
+            fold_binary(node);
+            break;
+        case AST_UNARY:
+            optimize_expr(node->as.unary.operand);
+            fold_unary(node);
+            break;
+        case AST_CALL:
+            optimize_expr(node->as.call.callee);
+            optimize_list(node->as.call.args, node->as.call.arg_count);
+            break;
+        case AST_GET:
+            optimize_expr(node->as.get.object);
+            break;
+        case AST_SET:
+            optimize_expr(node->as.set.object);
+            optimize_expr(node->as.set.value);
+            break;
+        case AST_INDEX_GET:
+            optimize_expr(node->as.index_get.object);
+            optimize_expr(node->as.index_get.index);
+            break;
+        case AST_INDEX_SET:
+            optimize_expr(node->as.index_set.object);
+            optimize_expr(node->as.index_set.index);
+            optimize_expr(node->as.index_set.value);
+            break;
+        case AST_ARRAY_LITERAL:
+            optimize_list(node->as.array_literal.elements, node->as.array_literal.count);
+            break;
+        case AST_DICT_LITERAL:
+            optimize_list(node->as.dict_literal.keys, node->as.dict_literal.count);
+            optimize_list(node->as.dict_literal.values, node->as.dict_literal.count);
+            break;
+        case AST_INPUT:
+            optimize_expr(node->as.input.prompt);
+            break;
+        case AST_NEW:
+            optimize_list(node->as.new_expr.args, node->as.new_expr.arg_count);
+            break;
+        case AST_CONVERT:
+            optimize_expr(node->as.convert.target);
+            break;
+        case AST_TYPEOF:
+            optimize_expr(node->as.typeof_expr.target);
+            break;
+        case AST_RANDOM:
+            optimize_expr(node->as.random_expr.min);
+            optimize_expr(node->as.random_expr.max);
+            break;
+        default:
+            break;
+    }
+}
+
+static void optimize_function(AstNode* decl) {
+    if (decl && decl->as.func_decl.body) optimize_block(decl->as.func_decl.body, true);
+}
+
+static AstNode* optimize_stmt(AstNode* node) {
+    if (!node) return NULL;
+    switch (node->type) {
+        case AST_IF: {
+            optimize_expr(node->as.if_stmt.condition);
+            if (node->as.if_stmt.then_branch) optimize_block(node->as.if_stmt.then_branch, true);
+            node->as.if_stmt.else_branch = optimize_stmt(node->as.if_stmt.else_branch);
+            if (is_literal(node->as.if_stmt.condition)) {
+                return literal_truthy(node->as.if_stmt.condition)
+                    ? node->as.if_stmt.then_branch
+                    : node->as.if_stmt.else_branch;
+            }
+            return node;
+        }
+        case AST_WHILE:
+            optimize_expr(node->as.while_stmt.condition);
+            if (is_literal(node->as.while_stmt.condition) && !literal_truthy(node->as.while_stmt.condition)) {
+                return NULL;
+            }
+            optimize_block(node->as.while_stmt.body, true);
+            return node;
+        case AST_BLOCK:
+            optimize_block(node, true);
+            return node;
+        case AST_VAR_DECL: optimize_expr(node->as.var_decl.init); return node;
+        case AST_ASSIGNMENT: optimize_expr(node->as.assignment.value); return node;
+        case AST_FOR_RANGE:
+            optimize_expr(node->as.for_range.start);
+            optimize_expr(node->as.for_range.end);
+            optimize_block(node->as.for_range.body, true);
+            return node;
+        case AST_FOR_EACH:
+            optimize_expr(node->as.for_each.collection);
+            optimize_block(node->as.for_each.body, true);
+            return node;
+        case AST_FUNC_DECL:
+            optimize_function(node);
+            return node;
+        case AST_CLASS_DECL:
+            optimize_function(node->as.class_decl.constructor);
+            for (int i = 0; i < node->as.class_decl.method_count; i++) {
+                optimize_function(node->as.class_decl.methods[i]);
+            }
+            return node;
+        case AST_RETURN: optimize_expr(node->as.return_stmt.value); return node;
+        case AST_PRINT: optimize_expr(node->as.print_stmt.value); return node;
+        case AST_TRY:
+            if (node->as.try_stmt.try_block) optimize_block(node->as.try_stmt.try_block, true);
+            if (node->as.try_stmt.catch_block) optimize_block(node->as.try_stmt.catch_block, true);
+            if (node->as.try_stmt.finally_block) optimize_block(node->as.try_stmt.finally_block, true);
+            return node;
+        case AST_ARRAY_PUSH: optimize_expr(node->as.array_push.value); return node;
+        case AST_EXPR_STMT: optimize_expr(node->as.expr_stmt.expr); return node;
+        default:
+            optimize_expr(node);
+            return node;
+    }
+}
+
+static bool ends_flow(AstNode* node) {
+    return node->type == AST_RETURN || node->type == AST_BREAK || node->type == AST_CONTINUE;
+}
+
+static void optimize_block(AstNode* block, bool prune_unreachable) {
+    if (block->type != AST_BLOCK) {
+        optimize_stmt(block);
+        return;
+    }
+    int count = 0;
+    bool unreachable = false;
+    for (int i = 0; i < block->as.block.stmt_count; i++) {
+        AstNode* stmt = block->as.block.stmts[i];
+        if (unreachable) continue;
+        stmt = optimize_stmt(stmt);
+        if (!stmt) continue;
+        block->as.block.stmts[count++] = stmt;
+        if (prune_unreachable && ends_flow(stmt)) unreachable = true;
+    }
+    block->as.block.stmt_count = count;
+}
+
+AstNode* optimize_program(AstNode* program) {
+    if (!program) return program;
+    if (dump_ast) ast_dump(program, "before");
+    arena = program->as.block.arena;
+    optimize_block(program, false);
+    arena = NULL;
+    if (dump_ast) ast_dump(program, "after");
+    return program;
+}
@@ -0,0 +1,11 @@
+#ifndef OJISAN_OPTIMIZER_H
+#define OJISAN_OPTIMIZER_H
+
+#include "ast.h"
+#include <stdbool.h>
+
+
+AstNode* optimize_program(AstNode* program);
+void optimizer_set_dump(bool enabled);
+
+#endif
@@ -2,19 +2,24 @@
 #include "lexer.h"
 #include "error.h" 
 #include "utf8.h" 
+#include "optimizer.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+static TokenBuffer tokens;
+static int token_index = 0;
 static Token current;
 static Token previous;
 static bool panic_mode = false;
 static bool had_error = false;
+static Arena* arena = NULL;
 
 static void advance() {
     previous = current;
     for (;;) {
-        current = lexer_scan_token();
+        current = token_buffer_get(&tokens, token_index);
+        if (current.type != TOK_EOF) token_index++;
         if (current.type != TOK_ERROR) break;
         error_report(ERR_SYNTAX, current.line, "%.*s", current.length, current.start);
         had_error = true;
@@ -41,27 +46,15 @@ static void consume(TokenType type, const char* message) {
 }
 
 static char* copy_string(Token token) {
-    char* str = malloc(token.length + 1);
-    if (!str) return NULL;
-    memcpy(str, token.start, token.length);
-    str[token.length] = '\0';
-    return str;
+    return arena_strndup(arena, token.start, token.length);
 }
 
 
 static bool is_param_start() {
     if (!check(TOK_IDENTIFIER)) return false;
-    
-    LexerState lstate = lexer_save_state();
-    Token save_current = current;
-    Token save_previous = previous;
-    advance(); 
-    bool result = check(TOK_CHAN); 
-    
-    lexer_restore_state(lstate);
-    current = save_current;
-    previous = save_previous;
-    return result;
+    int next = token_index;
+    while (tokens.tokens[next].type == TOK_ERROR) next++;
+    return tokens.tokens[next].type == TOK_CHAN;
 }
 
 
@@ -81,13 +74,16 @@ static bool check_start_of_expr();
 
 
 AstNode* parse_program(const char* source) {
-    lexer_init(source);
+    lexer_tokenize(&tokens, source);
+    token_index = 0;
     had_error = false;
     panic_mode = false;
+    arena = arena_new();
     advance();
 
     
-    AstNode* prog = ast_new_node(AST_BLOCK, 0);
+    AstNode* prog = ast_new_node(arena, AST_BLOCK, 0);
+    prog->as.block.arena = arena;
     prog->as.block.stmts = NULL;
     prog->as.block.stmt_count = 0;
     int capacity = 0;
@@ -97,19 +93,25 @@ AstNode* parse_program(const char* source) {
         if (stmt) {
             if (prog->as.block.stmt_count + 1 > capacity) {
                 capacity = capacity < 8 ? 8 : capacity * 2;
-                prog->as.block.stmts = realloc(prog->as.block.stmts, sizeof(AstNode*) * capacity);
+                prog->as.block.stmts = arena_grow(arena, prog->as.block.stmts, sizeof(AstNode*) * prog->as.block.stmt_count, sizeof(AstNode*) * capacity);
             }
             prog->as.block.stmts[prog->as.block.stmt_count++] = stmt;
         } else {
             advance(); 
         }
     }
+    token_buffer_free(&tokens);
+    if (!had_error) optimize_program(prog);
     return prog;
 }
 
+bool parser_had_error(void) {
+    return had_error;
+}
+
 
 static AstNode* parse_block_until(TokenType* terminators, int term_count) {
-    AstNode* block = ast_new_node(AST_BLOCK, current.line);
+    AstNode* block = ast_new_node(arena, AST_BLOCK, current.line);
     block->as.block.stmts = NULL;
     block->as.block.stmt_count = 0;
     int capacity = 0;
@@ -129,7 +131,7 @@ static AstNode* parse_block_until(TokenType* terminators, int term_count) {
         if (stmt) {
             if (block->as.block.stmt_count + 1 > capacity) {
                 capacity = capacity < 8 ? 8 : capacity * 2;
-                block->as.block.stmts = realloc(block->as.block.stmts, sizeof(AstNode*) * capacity);
+                block->as.block.stmts = arena_grow(arena, block->as.block.stmts, sizeof(AstNode*) * block->as.block.stmt_count, sizeof(AstNode*) * capacity);
             }
             block->as.block.stmts[block->as.block.stmt_count++] = stmt;
         } else {
@@ -146,11 +148,10 @@ static AstNode* statement() {
         char* raw = copy_string(previous);
         int len = strlen(raw);
         
-        char* path = malloc(len - 6 + 1);
+        char* path = arena_alloc(arena, len - 6 + 1);
         memcpy(path, raw + 3, len - 6);
         path[len - 6] = '\0';
-        free(raw);
-        AstNode* node = ast_new_node(AST_IMPORT, previous.line);
+        AstNode* node = ast_new_node(arena, AST_IMPORT, previous.line);
         node->as.import_stmt.path = path;
         return node;
     }
@@ -160,7 +161,7 @@ static AstNode* statement() {
         consume(TOK_CHAN_WA, "「チャンは」が必要ダヨ😅💦");
         AstNode* init = expression();
         consume(TOK_NANDA, "「ナンダ😘」が必要ダヨ😅💦");
-        AstNode* node = ast_new_node(AST_VAR_DECL, previous.line);
+        AstNode* node = ast_new_node(arena, AST_VAR_DECL, previous.line);
         node->as.var_decl.name = name;
         node->as.var_decl.init = init;
         return node;
@@ -173,8 +174,8 @@ static AstNode* statement() {
         AstNode* val = expression();
         consume(TOK_NI_NACCHATTA, "「ニナッチャッタ😅💦」が必要ダヨ😅💦");
         
-        AstNode* node = ast_new_node(AST_SET, previous.line);
-        node->as.set.object = ast_new_node(AST_THIS, previous.line);
+        AstNode* node = ast_new_node(arena, AST_SET, previous.line);
+        node->as.set.object = ast_new_node(arena, AST_THIS, previous.line);
         node->as.set.name = name;
         node->as.set.value = val;
         return node;
@@ -188,7 +189,7 @@ static AstNode* statement() {
         TokenType terms[] = {TOK_NANCHATTE, TOK_SOUJANAKATTARA, TOK_OKKEE};
         AstNode* thenBranch = parse_block_until(terms, 3);
         
-        AstNode* node = ast_new_node(AST_IF, previous.line);
+        AstNode* node = ast_new_node(arena, AST_IF, previous.line);
         node->as.if_stmt.condition = cond;
         node->as.if_stmt.then_branch = thenBranch;
         node->as.if_stmt.else_branch = NULL;
@@ -200,7 +201,7 @@ static AstNode* statement() {
             consume(TOK_KANA, "「カナ❓」が必要ダヨ😅💦");
             AstNode* elseif_block = parse_block_until(terms, 3);
             
-            AstNode* new_if = ast_new_node(AST_IF, previous.line);
+            AstNode* new_if = ast_new_node(arena, AST_IF, previous.line);
             new_if->as.if_stmt.condition = elseif_cond;
             new_if->as.if_stmt.then_branch = elseif_block;
             new_if->as.if_stmt.else_branch = NULL;
@@ -228,7 +229,7 @@ static AstNode* statement() {
         AstNode* body = parse_block_until(term, 1);
         consume(TOK_MOU_II, "最後は「もういいカナ😤」ダヨ😅💦");
         
-        AstNode* node = ast_new_node(AST_WHILE, previous.line);
+        AstNode* node = ast_new_node(arena, AST_WHILE, previous.line);
         node->as.while_stmt.condition = cond;
         node->as.while_stmt.body = body;
         return node;
@@ -242,7 +243,7 @@ static AstNode* statement() {
         if (match(TOK_CHAN_WA)) { 
              AstNode* expr = expression();
              consume(TOK_NI_NACCHATTA, "「ニナッチャッタ😅💦」が必要ダヨ😅💦");
-             AstNode* node = ast_new_node(AST_ASSIGNMENT, previous.line);
+             AstNode* node = ast_new_node(arena, AST_ASSIGNMENT, previous.line);
              node->as.assignment.name = name;
              node->as.assignment.value = expr;
              return node;
@@ -256,7 +257,7 @@ static AstNode* statement() {
                  AstNode* body = parse_block_until(term, 1);
                  consume(TOK_MOU_II, "最後は「もういいカナ😤」ダヨ😅💦");
                  
-                 AstNode* node = ast_new_node(AST_FOR_RANGE, previous.line);
+                 AstNode* node = ast_new_node(arena, AST_FOR_RANGE, previous.line);
                  node->as.for_range.var_name = name;
                  node->as.for_range.start = expr1;
                  node->as.for_range.end = expr2;
@@ -267,14 +268,14 @@ static AstNode* statement() {
                  AstNode* body = parse_block_until(term, 1);
                  consume(TOK_MOU_II, "最後は「もういいカナ😤」ダヨ😅💦");
                  
-                 AstNode* node = ast_new_node(AST_FOR_EACH, previous.line);
+                 AstNode* node = ast_new_node(arena, AST_FOR_EACH, previous.line);
                  node->as.for_each.var_name = name;
                  node->as.for_each.collection = expr1;
                  node->as.for_each.body = body;
                  return node;
              } else {
                  error_report(ERR_SYNTAX, current.line, "ループの構文がおかしいヨ😅💦");
-                 free(name);
+                 had_error = true;
                  return NULL;
              }
         } else if (match(TOK_YARIKATA)) { 
@@ -291,7 +292,7 @@ static AstNode* statement() {
 
                  if (param_count + 1 > param_cap) {
                      param_cap = param_cap < 8 ? 8 : param_cap * 2;
-                     params = realloc(params, sizeof(char*) * param_cap);
+                     params = arena_grow(arena, params, sizeof(char*) * param_count, sizeof(char*) * param_cap);
                  }
                  params[param_count++] = pname;
 
@@ -302,7 +303,7 @@ static AstNode* statement() {
              AstNode* body = parse_block_until(term, 1);
              consume(TOK_YARIKATA_OSHIMAI, "「やり方おしまい❗」が必要ダヨ😅💦");
              
-             AstNode* node = ast_new_node(AST_FUNC_DECL, previous.line);
+             AstNode* node = ast_new_node(arena, AST_FUNC_DECL, previous.line);
              node->as.func_decl.name = name;
              node->as.func_decl.params = params;
              node->as.func_decl.param_count = param_count;
@@ -329,7 +330,7 @@ static AstNode* statement() {
                          consume(TOK_CHAN, "「チャン」をつけてネ😘");
                          if (param_count + 1 > param_cap) {
                              param_cap = param_cap < 8 ? 8 : param_cap * 2;
-                             params = realloc(params, sizeof(char*) * param_cap);
+                             params = arena_grow(arena, params, sizeof(char*) * param_count, sizeof(char*) * param_cap);
                          }
                          params[param_count++] = pname;
                          if (!match(TOK_COMMA)) break;
@@ -339,8 +340,8 @@ static AstNode* statement() {
                      AstNode* body = parse_block_until(terms, 1);
                      consume(TOK_HAJIME_OSHIMAI, "「ハジメマシテおしまい❗」が必要ダヨ😅💦");
                      
-                     ctor = ast_new_node(AST_FUNC_DECL, previous.line); 
-                     ctor->as.func_decl.name = strdup("constructor");
+                     ctor = ast_new_node(arena, AST_FUNC_DECL, previous.line); 
+                     ctor->as.func_decl.name = arena_strdup(arena, "constructor");
                      ctor->as.func_decl.params = params;
                      ctor->as.func_decl.param_count = param_count;
                      ctor->as.func_decl.body = body;
@@ -350,7 +351,6 @@ static AstNode* statement() {
                      char* mname = copy_string(previous);
                      if (check(TOK_SAN_KOTO_OSHIMAI)) {
                          
-                         free(mname);
                          break;
                      } else if (match(TOK_YARIKATA)) {
                          
@@ -363,7 +363,7 @@ static AstNode* statement() {
                              consume(TOK_CHAN, "チャン");
                              if (param_count + 1 > param_cap) {
                                  param_cap = param_cap < 8 ? 8 : param_cap * 2;
-                                 params = realloc(params, sizeof(char*) * param_cap);
+                                 params = arena_grow(arena, params, sizeof(char*) * param_count, sizeof(char*) * param_cap);
                              }
                              params[param_count++] = pname;
                              if (!match(TOK_COMMA)) break;
@@ -373,7 +373,7 @@ static AstNode* statement() {
                          AstNode* body = parse_block_until(terms, 1);
                          consume(TOK_YARIKATA_OSHIMAI, "「やり方おしまい❗」が必要ダヨ😅💦");
                          
-                         AstNode* method = ast_new_node(AST_FUNC_DECL, previous.line);
+                         AstNode* method = ast_new_node(arena, AST_FUNC_DECL, previous.line);
                          method->as.func_decl.name = mname;
                          method->as.func_decl.params = params;
                          method->as.func_decl.param_count = param_count;
@@ -381,12 +381,12 @@ static AstNode* statement() {
                          
                          if (method_count + 1 > method_cap) {
                              method_cap = method_cap < 8 ? 8 : method_cap * 2;
-                             methods = realloc(methods, sizeof(AstNode*) * method_cap);
+                             methods = arena_grow(arena, methods, sizeof(AstNode*) * method_count, sizeof(AstNode*) * method_cap);
                          }
                          methods[method_count++] = method;
                      } else {
-                         free(mname);
                          error_report(ERR_SYNTAX, current.line, "クラスの中ではメソッドかコンストラクタしか書けないヨ😅💦");
+                         had_error = true;
                          advance(); 
                      }
                  } else {
@@ -395,7 +395,7 @@ static AstNode* statement() {
              }
              consume(TOK_SAN_KOTO_OSHIMAI, "「サンのコトおしまい❗」が必要ダヨ😅💦");
              
-             AstNode* node = ast_new_node(AST_CLASS_DECL, previous.line);
+             AstNode* node = ast_new_node(arena, AST_CLASS_DECL, previous.line);
              node->as.class_decl.name = name;
              node->as.class_decl.constructor = ctor;
              node->as.class_decl.methods = methods;
@@ -404,7 +404,7 @@ static AstNode* statement() {
         } else if (match(TOK_CHAN_NI)) { 
              AstNode* val = expression();
              consume(TOK_WO_TSUIKA, "「を追加ダヨ😁」が必要ダヨ😅💦");
-             AstNode* node = ast_new_node(AST_ARRAY_PUSH, previous.line);
+             AstNode* node = ast_new_node(arena, AST_ARRAY_PUSH, previous.line);
              node->as.array_push.array_name = name;
              node->as.array_push.value = val;
              return node;
@@ -417,9 +417,9 @@ static AstNode* statement() {
              if (match(TOK_ONEGAI)) {
                  
                  int call_line = previous.line;
-                 AstNode* var = ast_new_node(AST_VARIABLE, previous.line);
+                 AstNode* var = ast_new_node(arena, AST_VARIABLE, previous.line);
                  var->as.variable.name = name;
-                 AstNode* call = ast_new_node(AST_CALL, previous.line);
+                 AstNode* call = ast_new_node(arena, AST_CALL, previous.line);
                  call->as.call.callee = var;
                  AstNode** args = NULL;
                  int arg_count = 0;
@@ -429,7 +429,7 @@ static AstNode* statement() {
                          AstNode* arg = expression();
                          if (arg_count + 1 > arg_cap) {
                              arg_cap = arg_cap < 8 ? 8 : arg_cap * 2;
-                             args = realloc(args, sizeof(AstNode*) * arg_cap);
+                             args = arena_grow(arena, args, sizeof(AstNode*) * arg_count, sizeof(AstNode*) * arg_cap);
                          }
                          args[arg_count++] = arg;
                      } while (match(TOK_COMMA));
@@ -440,7 +440,7 @@ static AstNode* statement() {
              } else if (match(TOK_SAN_WO_TSUKURU)) {
                  
                  int call_line = previous.line;
-                 AstNode* node = ast_new_node(AST_NEW, previous.line);
+                 AstNode* node = ast_new_node(arena, AST_NEW, previous.line);
                  node->as.new_expr.class_name = name;
                  AstNode** args = NULL;
                  int arg_count = 0;
@@ -450,7 +450,7 @@ static AstNode* statement() {
                          AstNode* arg = expression();
                          if (arg_count + 1 > cap) {
                              cap = cap < 8 ? 8 : cap * 2;
-                             args = realloc(args, sizeof(AstNode*) * cap);
+                             args = arena_grow(arena, args, sizeof(AstNode*) * arg_count, sizeof(AstNode*) * cap);
                          }
                          args[arg_count++] = arg;
                      } while (match(TOK_COMMA));
@@ -459,22 +459,22 @@ static AstNode* statement() {
                  node->as.new_expr.arg_count = arg_count;
                  expr = node;
              } else if (match(TOK_CHAN)) {
-                 expr = ast_new_node(AST_VARIABLE, previous.line);
+                 expr = ast_new_node(arena, AST_VARIABLE, previous.line);
                  expr->as.variable.name = name;
              } else {
-                 free(name);
                  error_report(ERR_SYNTAX, current.line, "ステートメントの解釈に失敗したヨ😅💦");
+                 had_error = true;
                  return NULL;
              }
 
              
              if (match(TOK_NAGASA_CHAN)) {
-                 AstNode* length_call = ast_new_node(AST_CALL, previous.line);
-                 AstNode* fn = ast_new_node(AST_VARIABLE, previous.line);
-                 fn->as.variable.name = strdup("長さを教えてヨ😃");
+                 AstNode* length_call = ast_new_node(arena, AST_CALL, previous.line);
+                 AstNode* fn = ast_new_node(arena, AST_VARIABLE, previous.line);
+                 fn->as.variable.name = arena_strdup(arena, "長さを教えてヨ😃");
                  length_call->as.call.callee = fn;
                  length_call->as.call.arg_count = 1;
-                 length_call->as.call.args = malloc(sizeof(AstNode*));
+                 length_call->as.call.args = arena_alloc(arena, sizeof(AstNode*));
                  length_call->as.call.args[0] = expr;
                  expr = length_call;
              }
@@ -486,10 +486,10 @@ static AstNode* statement() {
                      if (match(TOK_ONEGAI)) {
                          
                          int call_line = previous.line;
-                         AstNode* get = ast_new_node(AST_GET, previous.line);
+                         AstNode* get = ast_new_node(arena, AST_GET, previous.line);
                          get->as.get.object = expr;
                          get->as.get.name = prop_name;
-                         AstNode* call = ast_new_node(AST_CALL, previous.line);
+                         AstNode* call = ast_new_node(arena, AST_CALL, previous.line);
                          call->as.call.callee = get;
                          AstNode** args = NULL;
                          int arg_count = 0;
@@ -499,7 +499,7 @@ static AstNode* statement() {
                                  AstNode* arg = expression();
                                  if (arg_count + 1 > arg_cap) {
                                      arg_cap = arg_cap < 8 ? 8 : arg_cap * 2;
-                                     args = realloc(args, sizeof(AstNode*) * arg_cap);
+                                     args = arena_grow(arena, args, sizeof(AstNode*) * arg_count, sizeof(AstNode*) * arg_cap);
                                  }
                                  args[arg_count++] = arg;
                              } while (match(TOK_COMMA));
@@ -510,32 +510,31 @@ static AstNode* statement() {
                      } else if (match(TOK_CHAN)) {
                          
                          if (check(TOK_BANME_CHAN) || check(TOK_BANME_CHAN_WA)) {
-                             AstNode* varNode = ast_new_node(AST_VARIABLE, previous.line);
+                             AstNode* varNode = ast_new_node(arena, AST_VARIABLE, previous.line);
                              varNode->as.variable.name = prop_name;
                              if (match(TOK_BANME_CHAN_WA)) {
                                  AstNode* value = expression();
                                  consume(TOK_NI_NACCHATTA, "「ニナッチャッタ😅💦」が必要ダヨ😅💦");
-                                 AstNode* node = ast_new_node(AST_INDEX_SET, previous.line);
+                                 AstNode* node = ast_new_node(arena, AST_INDEX_SET, previous.line);
                                  node->as.index_set.object = expr;
                                  node->as.index_set.index = varNode;
                                  node->as.index_set.value = value;
                                  return node;
                              } else {
                                  advance(); 
-                                 AstNode* node = ast_new_node(AST_INDEX_GET, previous.line);
+                                 AstNode* node = ast_new_node(arena, AST_INDEX_GET, previous.line);
                                  node->as.index_get.object = expr;
                                  node->as.index_get.index = varNode;
                                  expr = node;
                              }
                          } else {
                              
-                             AstNode* get = ast_new_node(AST_GET, previous.line);
+                             AstNode* get = ast_new_node(arena, AST_GET, previous.line);
                              get->as.get.object = expr;
                              get->as.get.name = prop_name;
                              expr = get;
                          }
                      } else {
-                         free(prop_name);
                          break;
                      }
                  } else if (check(TOK_NUMBER)) {
@@ -544,25 +543,25 @@ static AstNode* statement() {
                      if (match(TOK_BANME_CHAN_WA)) {
                          AstNode* value = expression();
                          consume(TOK_NI_NACCHATTA, "「ニナッチャッタ😅💦」が必要ダヨ😅💦");
-                         AstNode* node = ast_new_node(AST_INDEX_SET, previous.line);
+                         AstNode* node = ast_new_node(arena, AST_INDEX_SET, previous.line);
                          node->as.index_set.object = expr;
                          node->as.index_set.index = idx;
                          node->as.index_set.value = value;
                          return node;
                      }
                      consume(TOK_BANME_CHAN, "「番目チャン」が必要ダヨ😅💦");
-                     AstNode* index_get = ast_new_node(AST_INDEX_GET, previous.line);
+                     AstNode* index_get = ast_new_node(arena, AST_INDEX_GET, previous.line);
                      index_get->as.index_get.object = expr;
                      index_get->as.index_get.index = idx;
                      expr = index_get;
                  } else if (match(TOK_NAGASA_CHAN)) {
                      
-                     AstNode* length_call = ast_new_node(AST_CALL, previous.line);
-                     AstNode* fn = ast_new_node(AST_VARIABLE, previous.line);
-                     fn->as.variable.name = strdup("長さを教えてヨ😃");
+                     AstNode* length_call = ast_new_node(arena, AST_CALL, previous.line);
+                     AstNode* fn = ast_new_node(arena, AST_VARIABLE, previous.line);
+                     fn->as.variable.name = arena_strdup(arena, "長さを教えてヨ😃");
                      length_call->as.call.callee = fn;
                      length_call->as.call.arg_count = 1;
-                     length_call->as.call.args = malloc(sizeof(AstNode*));
+                     length_call->as.call.args = arena_alloc(arena, sizeof(AstNode*));
                      length_call->as.call.args[0] = expr;
                      expr = length_call;
                  } else {
@@ -579,7 +578,7 @@ static AstNode* statement() {
                  advance();
                  TokenType op = previous.type;
                  AstNode* right = expression();
-                 AstNode* bin = ast_new_node(AST_BINARY, previous.line);
+                 AstNode* bin = ast_new_node(arena, AST_BINARY, previous.line);
                  bin->as.binary.op = op;
                  bin->as.binary.left = expr;
                  bin->as.binary.right = right;
@@ -588,32 +587,20 @@ static AstNode* statement() {
 
              
              if (match(TOK_OHHA)) {
-                 AstNode* node = ast_new_node(AST_PRINT, previous.line);
+                 AstNode* node = ast_new_node(arena, AST_PRINT, previous.line);
                  node->as.print_stmt.value = expr;
                  node->as.print_stmt.is_println = true;
                  return node;
              }
              if (match(TOK_TSUBUYAKI)) {
-                 AstNode* node = ast_new_node(AST_PRINT, previous.line);
+                 AstNode* node = ast_new_node(arena, AST_PRINT, previous.line);
                  node->as.print_stmt.value = expr;
                  node->as.print_stmt.is_println = false;
                  return node;
              }
-             if (match(TOK_NANDA)) {
-                 
-                 
-                 AstNode* assignment = ast_new_node(AST_ASSIGNMENT, previous.line);
-                 if (expr->type == AST_VARIABLE) {
-                     assignment->as.assignment.name = strdup(expr->as.variable.name);
-                 } else {
-                     assignment->as.assignment.name = strdup("");
-                 }
-                 
-                 
-                 ast_free(assignment);
-             }
+             match(TOK_NANDA);
 
-             AstNode* node = ast_new_node(AST_EXPR_STMT, previous.line);
+             AstNode* node = ast_new_node(arena, AST_EXPR_STMT, previous.line);
              node->as.expr_stmt.expr = expr;
              return node;
         }
@@ -622,7 +609,7 @@ static AstNode* statement() {
     if (match(TOK_KOTAE)) {
         AstNode* expr = expression();
         consume(TOK_DA_YO, "「ダヨ😁」が必要ダヨ😅💦");
-        AstNode* node = ast_new_node(AST_RETURN, previous.line);
+        AstNode* node = ast_new_node(arena, AST_RETURN, previous.line);
         node->as.return_stmt.value = expr;
         return node;
     }
@@ -652,7 +639,7 @@ static AstNode* statement() {
          
          consume(TOK_DOKIDOKI_OSHIMAI, "「ドキドキおしまい❗」が必要ダヨ😅💦");
          
-         AstNode* node = ast_new_node(AST_TRY, previous.line);
+         AstNode* node = ast_new_node(arena, AST_TRY, previous.line);
          node->as.try_stmt.try_block = tryBlock;
          node->as.try_stmt.catch_var = catchVar;
          node->as.try_stmt.catch_block = catchBlock;
@@ -660,26 +647,26 @@ static AstNode* statement() {
          return node;
     }
 
-    if (match(TOK_MOU_MURI)) return ast_new_node(AST_BREAK, previous.line);
-    if (match(TOK_TSUGI_IKOU)) return ast_new_node(AST_CONTINUE, previous.line);
+    if (match(TOK_MOU_MURI)) return ast_new_node(arena, AST_BREAK, previous.line);
+    if (match(TOK_TSUGI_IKOU)) return ast_new_node(arena, AST_CONTINUE, previous.line);
 
     
     AstNode* expr = expression();
 
     if (match(TOK_OHHA)) {
-        AstNode* node = ast_new_node(AST_PRINT, previous.line);
+        AstNode* node = ast_new_node(arena, AST_PRINT, previous.line);
         node->as.print_stmt.value = expr;
         node->as.print_stmt.is_println = true;
         return node;
     }
     if (match(TOK_TSUBUYAKI)) {
-        AstNode* node = ast_new_node(AST_PRINT, previous.line);
+        AstNode* node = ast_new_node(arena, AST_PRINT, previous.line);
         node->as.print_stmt.value = expr;
         node->as.print_stmt.is_println = false;
         return node;
     }
 
-    AstNode* node = ast_new_node(AST_EXPR_STMT, previous.line);
+    AstNode* node = ast_new_node(arena, AST_EXPR_STMT, previous.line);
     node->as.expr_stmt.expr = expr;
     return node;
 }
@@ -692,7 +679,7 @@ static AstNode* or_expr() {
     AstNode* expr = and_expr();
     while (match(TOK_MOSHIKUWA)) {
         AstNode* right = and_expr();
-        AstNode* node = ast_new_node(AST_BINARY, previous.line);
+        AstNode* node = ast_new_node(arena, AST_BINARY, previous.line);
         node->as.binary.op = TOK_MOSHIKUWA;
         node->as.binary.left = expr;
         node->as.binary.right = right;
@@ -705,7 +692,7 @@ static AstNode* and_expr() {
     AstNode* expr = eq_expr();
     while (match(TOK_SHIKAMO)) {
         AstNode* right = eq_expr();
-        AstNode* node = ast_new_node(AST_BINARY, previous.line);
+        AstNode* node = ast_new_node(arena, AST_BINARY, previous.line);
         node->as.binary.op = TOK_SHIKAMO;
         node->as.binary.left = expr;
         node->as.binary.right = right;
@@ -720,7 +707,7 @@ static AstNode* eq_expr() {
     while (match(TOK_ONAJI_KANA) || match(TOK_CHIGAU_KANA)) {
         TokenType op = previous.type;
         AstNode* right = cmp_expr();
-        AstNode* node = ast_new_node(AST_BINARY, previous.line);
+        AstNode* node = ast_new_node(arena, AST_BINARY, previous.line);
         node->as.binary.op = op;
         node->as.binary.left = expr;
         node->as.binary.right = right;
@@ -734,7 +721,7 @@ static AstNode* cmp_expr() {
     while (match(TOK_YORI_UE) || match(TOK_YORI_SHITA) || match(TOK_IJOU) || match(TOK_IKA)) {
         TokenType op = previous.type;
         AstNode* right = add_expr();
-        AstNode* node = ast_new_node(AST_BINARY, previous.line);
+        AstNode* node = ast_new_node(arena, AST_BINARY, previous.line);
         node->as.binary.op = op;
         node->as.binary.left = expr;
         node->as.binary.right = right;
@@ -748,7 +735,7 @@ static AstNode* add_expr() {
     while (match(TOK_TO) || match(TOK_HIKU)) {
         TokenType op = previous.type;
         AstNode* right = mul_expr();
-        AstNode* node = ast_new_node(AST_BINARY, previous.line);
+        AstNode* node = ast_new_node(arena, AST_BINARY, previous.line);
         node->as.binary.op = op;
         node->as.binary.left = expr;
         node->as.binary.right = right;
@@ -762,7 +749,7 @@ static AstNode* mul_expr() {
     while (match(TOK_KAKERU) || match(TOK_WARU) || match(TOK_AMARI)) {
         TokenType op = previous.type;
         AstNode* right = unary_expr();
-        AstNode* node = ast_new_node(AST_BINARY, previous.line);
+        AstNode* node = ast_new_node(arena, AST_BINARY, previous.line);
         node->as.binary.op = op;
         node->as.binary.left = expr;
         node->as.binary.right = right;
@@ -774,14 +761,14 @@ static AstNode* mul_expr() {
 static AstNode* unary_expr() {
     if (match(TOK_MAINASU)) {
         AstNode* operand = unary_expr();
-        AstNode* node = ast_new_node(AST_UNARY, previous.line);
+        AstNode* node = ast_new_node(arena, AST_UNARY, previous.line);
         node->as.unary.op = TOK_MAINASU;
         node->as.unary.operand = operand;
         return node;
     }
     if (match(TOK_CHIGAU_YO)) {
         AstNode* operand = postfix_expr();
-        AstNode* node = ast_new_node(AST_UNARY, previous.line);
+        AstNode* node = ast_new_node(arena, AST_UNARY, previous.line);
         node->as.unary.op = TOK_CHIGAU_YO;
         node->as.unary.operand = operand;
         return node;
@@ -791,20 +778,20 @@ static AstNode* unary_expr() {
     if (match(TOK_KATA_WO) || match(TOK_SUUJI_NI) || match(TOK_MOJI_NI) || match(TOK_NAGASA_WO)) {
         
         char* name = NULL;
-        if (previous.type == TOK_KATA_WO) name = strdup("型を教えてヨ😃");
-        else if (previous.type == TOK_SUUJI_NI) name = strdup("数字にしてネ😘");
-        else if (previous.type == TOK_MOJI_NI) name = strdup("文字にしてネ😘");
-        else if (previous.type == TOK_NAGASA_WO) name = strdup("長さを教えてヨ😃");
+        if (previous.type == TOK_KATA_WO) name = arena_strdup(arena, "型を教えてヨ😃");
+        else if (previous.type == TOK_SUUJI_NI) name = arena_strdup(arena, "数字にしてネ😘");
+        else if (previous.type == TOK_MOJI_NI) name = arena_strdup(arena, "文字にしてネ😘");
+        else if (previous.type == TOK_NAGASA_WO) name = arena_strdup(arena, "長さを教えてヨ😃");
         
-        AstNode* func = ast_new_node(AST_VARIABLE, previous.line);
+        AstNode* func = ast_new_node(arena, AST_VARIABLE, previous.line);
         func->as.variable.name = name;
         
         AstNode* arg = unary_expr(); 
         
-        AstNode* call = ast_new_node(AST_CALL, previous.line);
+        AstNode* call = ast_new_node(arena, AST_CALL, previous.line);
         call->as.call.callee = func;
         call->as.call.arg_count = 1;
-        call->as.call.args = malloc(sizeof(AstNode*));
+        call->as.call.args = arena_alloc(arena, sizeof(AstNode*));
         call->as.call.args[0] = arg;
         
         return call;
@@ -838,11 +825,11 @@ static AstNode* postfix_expr() {
             if (match(TOK_IDENTIFIER)) {
                 Token ident = previous;
                 if (match(TOK_ONEGAI)) { 
-                    AstNode* get = ast_new_node(AST_GET, previous.line);
+                    AstNode* get = ast_new_node(arena, AST_GET, previous.line);
                     get->as.get.object = expr;
                     get->as.get.name = copy_string(ident); 
                     
-                    AstNode* call = ast_new_node(AST_CALL, previous.line);
+                    AstNode* call = ast_new_node(arena, AST_CALL, previous.line);
                     call->as.call.callee = get;
                     
                     
@@ -855,7 +842,7 @@ static AstNode* postfix_expr() {
                             AstNode* arg = expression();
                             if (arg_count + 1 > arg_cap) {
                                 arg_cap = arg_cap < 8 ? 8 : arg_cap * 2;
-                                args = realloc(args, sizeof(AstNode*) * arg_cap);
+                                args = arena_grow(arena, args, sizeof(AstNode*) * arg_count, sizeof(AstNode*) * arg_cap);
                             }
                             args[arg_count++] = arg;
                         } while (match(TOK_COMMA));
@@ -867,38 +854,39 @@ static AstNode* postfix_expr() {
                 } else if (match(TOK_CHAN)) { 
                     
                     if (check(TOK_BANME_CHAN) || check(TOK_BANME_CHAN_WA)) {
-                        AstNode* varNode = ast_new_node(AST_VARIABLE, previous.line);
+                        AstNode* varNode = ast_new_node(arena, AST_VARIABLE, previous.line);
                         varNode->as.variable.name = copy_string(ident);
                         if (match(TOK_BANME_CHAN_WA)) {
                             
                             AstNode* value = expression();
                             consume(TOK_NI_NACCHATTA, "「ニナッチャッタ😅💦」が必要ダヨ😅💦");
-                            AstNode* node = ast_new_node(AST_INDEX_SET, previous.line);
+                            AstNode* node = ast_new_node(arena, AST_INDEX_SET, previous.line);
                             node->as.index_set.object = expr;
                             node->as.index_set.index = varNode;
                             node->as.index_set.value = value;
                             return node; 
                         } else {
                             advance(); 
-                            AstNode* node = ast_new_node(AST_INDEX_GET, previous.line);
+                            AstNode* node = ast_new_node(arena, AST_INDEX_GET, previous.line);
                             node->as.index_get.object = expr;
                             node->as.index_get.index = varNode;
                             expr = node;
                         }
                     } else {
-                        AstNode* get = ast_new_node(AST_GET, previous.line);
+                        AstNode* get = ast_new_node(arena, AST_GET, previous.line);
                         get->as.get.object = expr;
                         get->as.get.name = copy_string(ident);
                         expr = get;
                     }
                 } else {
                     error_report(ERR_SYNTAX, current.line, "「の」の後はメンバが必要ダヨ😅💦");
+                    had_error = true;
                     break;
                 }
             } else if (match(TOK_NAGASA_CHAN)) { 
-                 AstNode* get = ast_new_node(AST_GET, previous.line);
+                 AstNode* get = ast_new_node(arena, AST_GET, previous.line);
                  get->as.get.object = expr;
-                 get->as.get.name = strdup("length");
+                 get->as.get.name = arena_strdup(arena, "length");
                  expr = get;
             } else { 
                  AstNode* index = expression();
@@ -906,13 +894,13 @@ static AstNode* postfix_expr() {
                      
                      AstNode* value = expression();
                      consume(TOK_NI_NACCHATTA, "「ニナッチャッタ😅💦」が必要ダヨ😅💦");
-                     AstNode* node = ast_new_node(AST_INDEX_SET, previous.line);
+                     AstNode* node = ast_new_node(arena, AST_INDEX_SET, previous.line);
                      node->as.index_set.object = expr;
                      node->as.index_set.index = index;
                      node->as.index_set.value = value;
                      return node; 
                  } else if (match(TOK_BANME_CHAN)) {
-                     AstNode* node = ast_new_node(AST_INDEX_GET, previous.line);
+                     AstNode* node = ast_new_node(arena, AST_INDEX_GET, previous.line);
                      node->as.index_get.object = expr;
                      node->as.index_get.index = index;
                      expr = node;
@@ -923,12 +911,12 @@ static AstNode* postfix_expr() {
             }
         } else if (match(TOK_NAGASA_CHAN)) {
             
-            AstNode* length_call = ast_new_node(AST_CALL, previous.line);
-            AstNode* fn = ast_new_node(AST_VARIABLE, previous.line);
-            fn->as.variable.name = strdup("長さを教えてヨ😃");
+            AstNode* length_call = ast_new_node(arena, AST_CALL, previous.line);
+            AstNode* fn = ast_new_node(arena, AST_VARIABLE, previous.line);
+            fn->as.variable.name = arena_strdup(arena, "長さを教えてヨ😃");
             length_call->as.call.callee = fn;
             length_call->as.call.arg_count = 1;
-            length_call->as.call.args = malloc(sizeof(AstNode*));
+            length_call->as.call.args = arena_alloc(arena, sizeof(AstNode*));
             length_call->as.call.args[0] = expr;
             expr = length_call;
         } else {
@@ -940,7 +928,7 @@ static AstNode* postfix_expr() {
 
 static AstNode* primary() {
     if (match(TOK_NUMBER)) {
-        AstNode* node = ast_new_node(AST_LITERAL, previous.line);
+        AstNode* node = ast_new_node(arena, AST_LITERAL, previous.line);
         char* val = copy_string(previous);
         if (strchr(val, '.')) {
             node->as.literal.type = LIT_FLOAT;
@@ -949,18 +937,17 @@ static AstNode* primary() {
             node->as.literal.type = LIT_INT;
             node->as.literal.i_val = strtoll(val, NULL, 10);
         }
-        free(val);
         return node;
     }
     if (match(TOK_STRING)) {
-        AstNode* node = ast_new_node(AST_LITERAL, previous.line);
+        AstNode* node = ast_new_node(arena, AST_LITERAL, previous.line);
         node->as.literal.type = LIT_STR;
         char* raw = copy_string(previous);
         int len = strlen(raw);
         if (len >= 6) {
             
             int inner_len = len - 6;
-            char* inner = malloc(inner_len + 1);
+            char* inner = arena_alloc(arena, inner_len + 1);
             
             int j = 0;
             for (int i = 3; i < len - 3; i++) {
@@ -985,7 +972,6 @@ static AstNode* primary() {
                 }
             }
             inner[j] = '\0';
-            free(raw);
             node->as.literal.s_val = inner;
         } else {
             node->as.literal.s_val = raw;
@@ -993,19 +979,19 @@ static AstNode* primary() {
         return node;
     }
     if (match(TOK_MAJI)) {
-        AstNode* node = ast_new_node(AST_LITERAL, previous.line);
+        AstNode* node = ast_new_node(arena, AST_LITERAL, previous.line);
         node->as.literal.type = LIT_BOOL;
         node->as.literal.b_val = true;
         return node;
     }
     if (match(TOK_USO)) {
-        AstNode* node = ast_new_node(AST_LITERAL, previous.line);
+        AstNode* node = ast_new_node(arena, AST_LITERAL, previous.line);
         node->as.literal.type = LIT_BOOL;
         node->as.literal.b_val = false;
         return node;
     }
     if (match(TOK_NAI_NAI)) {
-        AstNode* node = ast_new_node(AST_LITERAL, previous.line);
+        AstNode* node = ast_new_node(arena, AST_LITERAL, previous.line);
         node->as.literal.type = LIT_NULL;
         return node;
     }
@@ -1013,9 +999,9 @@ static AstNode* primary() {
     
     if (match(TOK_RANDOM_CHAN)) {
         
-        AstNode* func = ast_new_node(AST_VARIABLE, previous.line);
-        func->as.variable.name = strdup("ランダムチャン😃");
-        AstNode* call = ast_new_node(AST_CALL, previous.line);
+        AstNode* func = ast_new_node(arena, AST_VARIABLE, previous.line);
+        func->as.variable.name = arena_strdup(arena, "ランダムチャン😃");
+        AstNode* call = ast_new_node(arena, AST_CALL, previous.line);
         call->as.call.callee = func;
         call->as.call.arg_count = 0;
         call->as.call.args = NULL;
@@ -1032,13 +1018,13 @@ static AstNode* primary() {
                  AstNode* elem = expression();
                  if (count + 1 > cap) {
                      cap = cap < 8 ? 8 : cap * 2;
-                     elements = realloc(elements, sizeof(AstNode*) * cap);
+                     elements = arena_grow(arena, elements, sizeof(AstNode*) * count, sizeof(AstNode*) * cap);
                  }
                  elements[count++] = elem;
              } while (match(TOK_COMMA));
         }
         consume(TOK_RBRACKET, "】が必要ダヨ😅💦");
-        AstNode* node = ast_new_node(AST_ARRAY_LITERAL, previous.line);
+        AstNode* node = ast_new_node(arena, AST_ARRAY_LITERAL, previous.line);
         node->as.array_literal.elements = elements;
         node->as.array_literal.count = count;
         return node;
@@ -1056,8 +1042,8 @@ static AstNode* primary() {
                 AstNode* val = expression();
                 if (count + 1 > cap) {
                     cap = cap < 8 ? 8 : cap * 2;
-                    keys = realloc(keys, sizeof(AstNode*) * cap);
-                    values = realloc(values, sizeof(AstNode*) * cap);
+                    keys = arena_grow(arena, keys, sizeof(AstNode*) * count, sizeof(AstNode*) * cap);
+                    values = arena_grow(arena, values, sizeof(AstNode*) * count, sizeof(AstNode*) * cap);
                 }
                 keys[count] = key;
                 values[count] = val;
@@ -1065,7 +1051,7 @@ static AstNode* primary() {
             } while (match(TOK_COMMA));
         }
         consume(TOK_RDICT, "》が必要ダヨ😅💦");
-        AstNode* node = ast_new_node(AST_DICT_LITERAL, previous.line);
+        AstNode* node = ast_new_node(arena, AST_DICT_LITERAL, previous.line);
         node->as.dict_literal.keys = keys;
         node->as.dict_literal.values = values;
         node->as.dict_literal.count = count;
@@ -1073,14 +1059,14 @@ static AstNode* primary() {
     }
 
     if (match(TOK_OSHIETE_YO)) { 
-        AstNode* func = ast_new_node(AST_VARIABLE, previous.line);
-        func->as.variable.name = strdup("チョット教えてヨ😃");
-        AstNode* call = ast_new_node(AST_CALL, previous.line);
+        AstNode* func = ast_new_node(arena, AST_VARIABLE, previous.line);
+        func->as.variable.name = arena_strdup(arena, "チョット教えてヨ😃");
+        AstNode* call = ast_new_node(arena, AST_CALL, previous.line);
         call->as.call.callee = func;
         
         if (check_start_of_expr()) {
             call->as.call.arg_count = 1;
-            call->as.call.args = malloc(sizeof(AstNode*));
+            call->as.call.args = arena_alloc(arena, sizeof(AstNode*));
             call->as.call.args[0] = expression();
         } else {
             call->as.call.arg_count = 0;
@@ -1102,8 +1088,8 @@ static AstNode* primary() {
         char* name = copy_string(ident);
         
         if (match(TOK_ONEGAI)) { 
-             AstNode* node = ast_new_node(AST_CALL, previous.line);
-             AstNode* var = ast_new_node(AST_VARIABLE, previous.line);
+             AstNode* node = ast_new_node(arena, AST_CALL, previous.line);
+             AstNode* var = ast_new_node(arena, AST_VARIABLE, previous.line);
              var->as.variable.name = name;
              node->as.call.callee = var;
              
@@ -1116,7 +1102,7 @@ static AstNode* primary() {
                      AstNode* arg = expression();
                      if (arg_count + 1 > arg_cap) {
                          arg_cap = arg_cap < 8 ? 8 : arg_cap * 2;
-                         args = realloc(args, sizeof(AstNode*) * arg_cap);
+                         args = arena_grow(arena, args, sizeof(AstNode*) * arg_count, sizeof(AstNode*) * arg_cap);
                      }
                      args[arg_count++] = arg;
                  } while (match(TOK_COMMA));
@@ -1126,7 +1112,7 @@ static AstNode* primary() {
              node->as.call.arg_count = arg_count;
              return node;
         } else if (match(TOK_SAN_WO_TSUKURU)) { 
-             AstNode* node = ast_new_node(AST_NEW, previous.line);
+             AstNode* node = ast_new_node(arena, AST_NEW, previous.line);
              node->as.new_expr.class_name = name;
              
              
@@ -1138,7 +1124,7 @@ static AstNode* primary() {
                      AstNode* arg = expression();
                      if (arg_count + 1 > cap) {
                          cap = cap < 8 ? 8 : cap * 2;
-                         args = realloc(args, sizeof(AstNode*) * cap);
+                         args = arena_grow(arena, args, sizeof(AstNode*) * arg_count, sizeof(AstNode*) * cap);
                      }
                      args[arg_count++] = arg;
                  } while (match(TOK_COMMA));
@@ -1148,12 +1134,12 @@ static AstNode* primary() {
              node->as.new_expr.arg_count = arg_count;
              return node;
         } else if (match(TOK_CHAN)) { 
-             AstNode* node = ast_new_node(AST_VARIABLE, previous.line);
+             AstNode* node = ast_new_node(arena, AST_VARIABLE, previous.line);
              node->as.variable.name = name;
              return node;
         } else {
-             free(name);
              error_report(ERR_SYNTAX, current.line, "変数なら「チャン」をつけてネ😅💦");
+             had_error = true;
              return NULL;
         }
     }
@@ -1162,13 +1148,14 @@ static AstNode* primary() {
         consume(TOK_IDENTIFIER, "フィールド名が必要ダヨ😅💦");
         char* field = copy_string(previous);
         consume(TOK_CHAN, "「チャン」をつけてネ😘");
-        AstNode* node = ast_new_node(AST_GET, previous.line);
-        node->as.get.object = ast_new_node(AST_THIS, previous.line);
+        AstNode* node = ast_new_node(arena, AST_GET, previous.line);
+        node->as.get.object = ast_new_node(arena, AST_THIS, previous.line);
         node->as.get.name = field;
         return node;
     }
 
     error_report(ERR_SYNTAX, current.line, "式が期待されてるヨ😅💦");
+    had_error = true;
     if (!check(TOK_EOF)) advance(); 
     return NULL;
 }
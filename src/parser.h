@@ -5,5 +5,6 @@
 
 
 AstNode* parse_program(const char* source);
+bool parser_had_error(void);
 
 #endif 
@@ -0,0 +1,200 @@
+#include "pool.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#define SLAB_SIZE (64 * 1024)
+#define POOL_MAX_SIZE 512
+#define CLASS_COUNT 10
+
+typedef struct FreeCell {
+    struct FreeCell* next;
+} FreeCell;
+
+typedef struct Slab {
+    struct Slab* next;
+    size_t used;
+    int live;
+    int size_class;
+} Slab;
+
+typedef struct {
+    size_t cell_size;
+    FreeCell* free_list;
+    Slab* slabs;
+    size_t allocs;
+    size_t frees;
+    size_t live;
+    size_t peak;
+    int slab_count;
+} SizeClass;
+
+#define SLAB_HEADER ((sizeof(Slab) + 15) & ~(size_t)15)
+#define SLAB_OF(ptr) ((Slab*)((uintptr_t)(ptr) & ~(uintptr_t)(SLAB_SIZE - 1)))
+
+static SizeClass classes[CLASS_COUNT] = {
+    {.cell_size = 16}, {.cell_size = 32}, {.cell_size = 48}, {.cell_size = 64}, {.cell_size = 96},
+    {.cell_size = 128}, {.cell_size = 192}, {.cell_size = 256}, {.cell_size = 384}, {.cell_size = 512}
+};
+static signed char class_index[POOL_MAX_SIZE / 16 + 1];
+static bool class_index_ready = false;
+
+static size_t large_allocs = 0;
+static size_t large_frees = 0;
+static size_t slabs_released = 0;
+
+static void init_class_index(void) {
+    int c = 0;
+    for (int units = 0; units <= POOL_MAX_SIZE / 16; units++) {
+        while ((size_t)units * 16 > classes[c].cell_size) c++;
+        class_index[units] = (signed char)c;
+    }
+    class_index_ready = true;
+}
+
+static inline int size_class_of(size_t size) {
+    if (size > POOL_MAX_SIZE) return -1;
+    if (!class_index_ready) init_class_index();
+    return class_index[(size + 15) / 16];
+}
+
+static Slab* slab_alloc(int size_class) {
+    void* memory = NULL;
+#ifdef _WIN32
+    memory = _aligned_malloc(SLAB_SIZE, SLAB_SIZE);
+#else
+    if (posix_memalign(&memory, SLAB_SIZE, SLAB_SIZE) != 0) memory = NULL;
+#endif
+    if (memory == NULL) return NULL;
+    Slab* slab = (Slab*)memory;
+    slab->used = SLAB_HEADER;
+    slab->live = 0;
+    slab->size_class = size_class;
+    slab->next = classes[size_class].slabs;
+    classes[size_class].slabs = slab;
+    classes[size_class].slab_count++;
+    return slab;
+}
+
+static void slab_release(Slab* slab) {
+#ifdef _WIN32
+    _aligned_free(slab);
+#else
+    free(slab);
+#endif
+    slabs_released++;
+}
+
+void* pool_alloc(size_t size) {
+    int c = size_class_of(size);
+    if (c < 0) {
+        large_allocs++;
+        return malloc(size);
+    }
+    SizeClass* sc = &classes[c];
+    void* cell;
+    if (sc->free_list != NULL) {
+        cell = sc->free_list;
+        sc->free_list = sc->free_list->next;
+    } else {
+        Slab* slab = sc->slabs;
+        if (slab == NULL || slab->used + sc->cell_size > SLAB_SIZE) {
+            slab = slab_alloc(c);
+            if (slab == NULL) return NULL;
+        }
+        cell = (char*)slab + slab->used;
+        slab->used += sc->cell_size;
+    }
+    SLAB_OF(cell)->live++;
+    sc->allocs++;
+    sc->live++;
+    if (sc->live > sc->peak) sc->peak = sc->live;
+    return cell;
+}
+
+void pool_free(void* ptr, size_t size) {
+    if (ptr == NULL) return;
+    int c = size_class_of(size);
+    if (c < 0) {
+        large_frees++;
+        free(ptr);
+        return;
+    }
+    SizeClass* sc = &classes[c];
+    FreeCell* cell = (FreeCell*)ptr;
+    cell->next = sc->free_list;
+    sc->free_list = cell;
+    SLAB_OF(ptr)->live--;
+    sc->frees++;
+    sc->live--;
+}
+
+void* pool_realloc(void* ptr, size_t old_size, size_t new_size) {
+    if (ptr == NULL) return pool_alloc(new_size);
+    int old_class = size_class_of(old_size);
+    int new_class = size_class_of(new_size);
+    if (old_class < 0 && new_class < 0) return realloc(ptr, new_size);
+    if (old_class >= 0 && old_class == new_class) return ptr;
+    void* memory = pool_alloc(new_size);
+    memcpy(memory, ptr, old_size < new_size ? old_size : new_size);
+    pool_free(ptr, old_size);
+    return memory;
+}
+
+void pool_trim(void) {
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        SizeClass* sc = &classes[c];
+        int empty = 0;
+        for (Slab* slab = sc->slabs; slab != NULL; slab = slab->next) {
+            if (slab->live == 0 && slab != sc->slabs) empty++;
+        }
+        if (empty == 0) continue;
+
+        FreeCell** link = &sc->free_list;
+        while (*link != NULL) {
+            Slab* slab = SLAB_OF(*link);
+            if (slab->live == 0 && slab != sc->slabs) {
+                *link = (*link)->next;
+            } else {
+                link = &(*link)->next;
+            }
+        }
+
+        Slab** slab_link = &sc->slabs->next;
+        while (*slab_link != NULL) {
+            Slab* slab = *slab_link;
+            if (slab->live == 0) {
+                *slab_link = slab->next;
+                slab_release(slab);
+                sc->slab_count--;
+            } else {
+                slab_link = &slab->next;
+            }
+        }
+    }
+}
+
+void pool_print_stats(FILE* out) {
+    size_t total_allocs = 0;
+    size_t total_live = 0;
+    int total_slabs = 0;
+    fprintf(out, "🍺 メモリプールの統計だヨ😘\n");
+    fprintf(out, "  %6s %12s %12s %10s %10s %6s\n", "サイズ", "確保", "解放", "使用中", "最大", "スラブ");
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        SizeClass* sc = &classes[c];
+        if (sc->allocs == 0) continue;
+        fprintf(out, "  %6zu %12zu %12zu %10zu %10zu %6d\n",
+                sc->cell_size, sc->allocs, sc->frees, sc->live, sc->peak, sc->slab_count);
+        total_allocs += sc->allocs;
+        total_live += sc->live;
+        total_slabs += sc->slab_count;
+    }
+    fprintf(out, "  プール合計: 確保 %zu 回 / 使用中 %zu 個 / スラブ %d 枚 (%d KB) / 返却済みスラブ %zu 枚\n",
+            total_allocs, total_live, total_slabs, total_slabs * (SLAB_SIZE / 1024), slabs_released);
+    fprintf(out, "  大きいサイズ (malloc直行): 確保 %zu 回 / 解放 %zu 回\n", large_allocs, large_frees);
+}
@@ -0,0 +1,18 @@
+#ifndef OJISAN_POOL_H
+#define OJISAN_POOL_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+
+void* pool_alloc(size_t size);
+void pool_free(void* ptr, size_t size);
+void* pool_realloc(void* ptr, size_t old_size, size_t new_size);
+
+
+void pool_trim(void);
+
+
+void pool_print_stats(FILE* out);
+
+#endif
@@ -0,0 +1,314 @@
+#include "resolver.h"
+#include "shape.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct Scope {
+    struct Scope* enclosing;
+    struct Scope* next_retired;
+    char** names;
+    int count;
+    int capacity;
+    bool owns_names;
+    bool captured;
+} Scope;
+
+typedef struct PendingFunction {
+    AstNode* decl;
+    Scope* scope;
+    struct PendingFunction* next;
+} PendingFunction;
+
+static Scope* current_scope = NULL;
+static Scope* retired_scopes = NULL;
+static PendingFunction* pending_head = NULL;
+static PendingFunction* pending_tail = NULL;
+static Arena* arena = NULL;
+
+static void resolve_node(AstNode* node);
+
+static void push_scope(void) {
+    Scope* scope = malloc(sizeof(Scope));
+    scope->enclosing = current_scope;
+    scope->next_retired = NULL;
+    scope->names = NULL;
+    scope->count = 0;
+    scope->capacity = 0;
+    scope->owns_names = true;
+    scope->captured = false;
+    current_scope = scope;
+}
+
+static void pop_scope(void) {
+    Scope* scope = current_scope;
+    current_scope = scope->enclosing;
+    if (scope->captured && current_scope) current_scope->captured = true;
+    scope->next_retired = retired_scopes;
+    retired_scopes = scope;
+}
+
+static int add_name(char* name) {
+    Scope* scope = current_scope;
+    if (scope->count + 1 > scope->capacity) {
+        scope->capacity = scope->capacity < 8 ? 8 : scope->capacity * 2;
+        scope->names = realloc(scope->names, sizeof(char*) * scope->capacity);
+    }
+    scope->names[scope->count] = name;
+    return scope->count++;
+}
+
+static int declare(char* name) {
+    if (current_scope == NULL) return -1;
+    for (int i = 0; i < current_scope->count; i++) {
+        if (strcmp(current_scope->names[i], name) == 0) return i;
+    }
+    return add_name(name);
+}
+
+static void resolve_name(const char* name, int* depth, int* slot) {
+    int hops = 0;
+    for (Scope* scope = current_scope; scope != NULL; scope = scope->enclosing, hops++) {
+        for (int i = scope->count - 1; i >= 0; i--) {
+            if (strcmp(scope->names[i], name) == 0) {
+                *depth = hops;
+                *slot = i;
+                return;
+            }
+        }
+    }
+    *depth = -1;
+    *slot = -1;
+}
+
+static char** arena_names(Scope* scope) {
+    if (scope->count == 0) return NULL;
+    char** names = arena_alloc(arena, sizeof(char*) * scope->count);
+    memcpy(names, scope->names, sizeof(char*) * scope->count);
+    return names;
+}
+
+static InlineCache* new_cache(void) {
+    InlineCache* cache = arena_alloc(arena, sizeof(InlineCache));
+    memset(cache, 0, sizeof(InlineCache));
+    return cache;
+}
+
+static void mark_captured(void) {
+    if (current_scope) current_scope->captured = true;
+}
+
+static void defer_function(AstNode* decl) {
+    if (!decl) return;
+    PendingFunction* pending = malloc(sizeof(PendingFunction));
+    pending->decl = decl;
+    pending->scope = current_scope;
+    pending->next = NULL;
+    if (pending_tail) {
+        pending_tail->next = pending;
+    } else {
+        pending_head = pending;
+    }
+    pending_tail = pending;
+}
+
+static void resolve_function(AstNode* decl, Scope* enclosing) {
+    Scope* saved = current_scope;
+    current_scope = enclosing;
+    push_scope();
+    for (int i = 0; i < decl->as.func_decl.param_count; i++) {
+        add_name(decl->as.func_decl.params[i]);
+    }
+    add_name((char*)"this");
+    decl->as.func_decl.frame_names = arena_names(current_scope);
+    resolve_node(decl->as.func_decl.body);
+    decl->as.func_decl.captured = current_scope->captured;
+    pop_scope();
+    current_scope = saved;
+}
+
+static bool resolve_loop_body(char** var_name, AstNode* body) {
+    push_scope();
+    current_scope->names = var_name;
+    current_scope->count = 1;
+    current_scope->capacity = 1;
+    current_scope->owns_names = false;
+    resolve_node(body);
+    bool captured = current_scope->captured;
+    pop_scope();
+    return captured;
+}
+
+static void resolve_list(int count, AstNode** nodes) {
+    for (int i = 0; i < count; i++) resolve_node(nodes[i]);
+}
+
+static void resolve_node(AstNode* node) {
+    if (!node) return;
+
+    switch (node->type) {
+        case AST_VAR_DECL:
+            resolve_node(node->as.var_decl.init);
+            node->as.var_decl.slot = declare(node->as.var_decl.name);
+            break;
+        case AST_ASSIGNMENT:
+            resolve_node(node->as.assignment.value);
+            resolve_name(node->as.assignment.name, &node->as.assignment.depth, &node->as.assignment.slot);
+            break;
+        case AST_VARIABLE:
+            resolve_name(node->as.variable.name, &node->as.variable.depth, &node->as.variable.slot);
+            break;
+        case AST_IF:
+            resolve_node(node->as.if_stmt.condition);
+            resolve_node(node->as.if_stmt.then_branch);
+            resolve_node(node->as.if_stmt.else_branch);
+            break;
+        case AST_WHILE:
+            resolve_node(node->as.while_stmt.condition);
+            resolve_node(node->as.while_stmt.body);
+            break;
+        case AST_FOR_RANGE:
+            resolve_node(node->as.for_range.start);
+            resolve_node(node->as.for_range.end);
+            node->as.for_range.captured = resolve_loop_body(&node->as.for_range.var_name, node->as.for_range.body);
+            break;
+        case AST_FOR_EACH:
+            resolve_node(node->as.for_each.collection);
+            node->as.for_each.captured = resolve_loop_body(&node->as.for_each.var_name, node->as.for_each.body);
+            break;
+        case AST_FUNC_DECL:
+            node->as.func_decl.slot = declare(node->as.func_decl.name);
+            mark_captured();
+            defer_function(node);
+            break;
+        case AST_CLASS_DECL:
+            for (int i = 0; i < node->as.class_decl.method_count; i++) {
+                defer_function(node->as.class_decl.methods[i]);
+            }
+            defer_function(node->as.class_decl.constructor);
+            node->as.class_decl.slot = declare(node->as.class_decl.name);
+            mark_captured();
+            break;
+        case AST_RETURN:
+            resolve_node(node->as.return_stmt.value);
+            break;
+        case AST_PRINT:
+            resolve_node(node->as.print_stmt.value);
+            break;
+        case AST_TRY:
+            resolve_node(node->as.try_stmt.try_block);
+            if (node->as.try_stmt.catch_block) {
+                if (node->as.try_stmt.catch_var) {
+                    node->as.try_stmt.catch_captured = resolve_loop_body(&node->as.try_stmt.catch_var, node->as.try_stmt.catch_block);
+                } else {
+                    push_scope();
+                    resolve_node(node->as.try_stmt.catch_block);
+                    node->as.try_stmt.catch_captured = current_scope->captured;
+                    pop_scope();
+                }
+            }
+            resolve_node(node->as.try_stmt.finally_block);
+            break;
+        case AST_ARRAY_PUSH:
+            resolve_name(node->as.array_push.array_name, &node->as.array_push.depth, &node->as.array_push.slot);
+            resolve_node(node->as.array_push.value);
+            break;
+        case AST_EXPR_STMT:
+            resolve_node(node->as.expr_stmt.expr);
+            break;
+        case AST_BLOCK:
+            push_scope();
+            resolve_list(node->as.block.stmt_count, node->as.block.stmts);
+            node->as.block.local_count = current_scope->count;
+            node->as.block.local_names = arena_names(current_scope);
+            node->as.block.captured = current_scope->captured;
+            pop_scope();
+            break;
+        case AST_BINARY:
+            resolve_node(node->as.binary.left);
+            resolve_node(node->as.binary.right);
+            break;
+        case AST_UNARY:
+            resolve_node(node->as.unary.operand);
+            break;
+        case AST_CALL:
+            resolve_node(node->as.call.callee);
+            resolve_list(node->as.call.arg_count, node->as.call.args);
+            break;
+        case AST_GET:
+            node->as.get.cache = new_cache();
+            resolve_node(node->as.get.object);
+            break;
+        case AST_SET:
+            node->as.set.cache = new_cache();
+            resolve_node(node->as.set.object);
+            resolve_node(node->as.set.value);
+            break;
+        case AST_INDEX_GET:
+            resolve_node(node->as.index_get.object);
+            resolve_node(node->as.index_get.index);
+            break;
+        case AST_INDEX_SET:
+            resolve_node(node->as.index_set.object);
+            resolve_node(node->as.index_set.index);
+            resolve_node(node->as.index_set.value);
+            break;
+        case AST_ARRAY_LITERAL:
+            resolve_list(node->as.array_literal.count, node->as.array_literal.elements);
+            break;
+        case AST_DICT_LITERAL:
+            resolve_list(node->as.dict_literal.count, node->as.dict_literal.keys);
+            resolve_list(node->as.dict_literal.count, node->as.dict_literal.values);
+            break;
+        case AST_IMPORT:
+            mark_captured();
+            break;
+        case AST_INPUT:
+            resolve_node(node->as.input.prompt);
+            break;
+        case AST_NEW:
+            resolve_name(node->as.new_expr.class_name, &node->as.new_expr.depth, &node->as.new_expr.slot);
+            resolve_list(node->as.new_expr.arg_count, node->as.new_expr.args);
+            break;
+        case AST_CONVERT:
+            resolve_node(node->as.convert.target);
+            break;
+        case AST_TYPEOF:
+            resolve_node(node->as.typeof_expr.target);
+            break;
+        case AST_RANDOM:
+            resolve_node(node->as.random_expr.min);
+            resolve_node(node->as.random_expr.max);
+            break;
+        default:
+            break;
+    }
+}
+
+void resolve_program(AstNode* program) {
+    if (!program) return;
+    current_scope = NULL;
+    arena = program->as.block.arena;
+
+    if (program->type == AST_BLOCK) {
+        resolve_list(program->as.block.stmt_count, program->as.block.stmts);
+        program->as.block.local_count = 0;
+        program->as.block.captured = true;
+    } else {
+        resolve_node(program);
+    }
+
+    while (pending_head) {
+        PendingFunction* pending = pending_head;
+        pending_head = pending->next;
+        if (!pending_head) pending_tail = NULL;
+        resolve_function(pending->decl, pending->scope);
+        free(pending);
+    }
+
+    while (retired_scopes) {
+        Scope* scope = retired_scopes;
+        retired_scopes = scope->next_retired;
+        if (scope->owns_names) free(scope->names);
+        free(scope);
+    }
+}
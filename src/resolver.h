@@ -0,0 +1,8 @@
+#ifndef OJISAN_RESOLVER_H
+#define OJISAN_RESOLVER_H
+
+#include "ast.h"
+
+void resolve_program(AstNode* program);
+
+#endif 
@@ -0,0 +1,130 @@
+#include "shape.h"
+#include "valuetable.h"
+#include "gc.h"
+#include "pool.h"
+#include <stdlib.h>
+
+static Shape* all_shapes = NULL;
+
+static Shape* allocate_shape(Shape* parent, ObjString* key) {
+    Shape* shape = malloc(sizeof(Shape));
+    shape->parent = parent;
+    shape->key = key;
+    shape->slot_count = parent ? parent->slot_count + 1 : 0;
+    value_table_init(&shape->slots);
+    if (parent) {
+        for (int i = 0; i < parent->slots.used; i++) {
+            ValueEntry* entry = &parent->slots.entries[i];
+            if (entry->key != NULL) value_table_set(&shape->slots, entry->key, entry->value);
+        }
+        value_table_set(&shape->slots, key, INT_VAL(shape->slot_count - 1));
+    }
+    shape->transitions = NULL;
+    shape->transition_count = 0;
+    shape->transition_capacity = 0;
+    shape->next_all = all_shapes;
+    all_shapes = shape;
+    return shape;
+}
+
+Shape* shape_new_root(void) {
+    return allocate_shape(NULL, NULL);
+}
+
+Shape* shape_add_field(Shape* shape, ObjString* key) {
+    for (int i = 0; i < shape->transition_count; i++) {
+        if (shape->transitions[i]->key == key) return shape->transitions[i];
+    }
+    Shape* child = allocate_shape(shape, key);
+    if (shape->transition_count + 1 > shape->transition_capacity) {
+        shape->transition_capacity = shape->transition_capacity < 4 ? 4 : shape->transition_capacity * 2;
+        shape->transitions = realloc(shape->transitions, sizeof(Shape*) * shape->transition_capacity);
+    }
+    shape->transitions[shape->transition_count++] = child;
+    return child;
+}
+
+int shape_lookup(Shape* shape, ObjString* key) {
+    Value slot;
+    if (!value_table_get(&shape->slots, key, &slot)) return -1;
+    return (int)AS_INT(slot);
+}
+
+void shape_mark_all(void) {
+    for (Shape* shape = all_shapes; shape != NULL; shape = shape->next_all) {
+        if (shape->key) gc_mark_obj((Obj*)shape->key);
+    }
+}
+
+
+static int append_slot(ObjInstance* instance, Shape* shape) {
+    if (shape->slot_count > instance->field_capacity) {
+        int capacity = instance->field_capacity < 4 ? 4 : instance->field_capacity * 2;
+        while (capacity < shape->slot_count) capacity *= 2;
+        instance->fields = pool_realloc(instance->fields, sizeof(Value) * instance->field_capacity, sizeof(Value) * capacity);
+        instance->field_capacity = capacity;
+    }
+    instance->shape = shape;
+    return shape->slot_count - 1;
+}
+
+bool instance_get_field(ObjInstance* instance, ObjString* name, Value* out) {
+    int slot = shape_lookup(instance->shape, name);
+    if (slot < 0) return false;
+    *out = instance->fields[slot];
+    return true;
+}
+
+void instance_set_field(ObjInstance* instance, ObjString* name, Value value) {
+    int slot = shape_lookup(instance->shape, name);
+    if (slot < 0) slot = append_slot(instance, shape_add_field(instance->shape, name));
+    gc_write_barrier(&instance->obj, value);
+    instance->fields[slot] = value;
+}
+
+
+static void cache_add(InlineCache* cache, InlineCacheEntry entry) {
+    if (cache->count >= INLINE_CACHE_SIZE) return;
+    cache->entries[cache->count++] = entry;
+}
+
+bool inline_cache_get(InlineCache* cache, ObjInstance* instance, ObjString* name, Value* out) {
+    for (int i = 0; i < cache->count; i++) {
+        InlineCacheEntry* entry = &cache->entries[i];
+        if (entry->shape == instance->shape) {
+            *out = entry->slot >= 0 ? instance->fields[entry->slot] : entry->method;
+            return true;
+        }
+    }
+
+    InlineCacheEntry entry = { instance->shape, NULL, shape_lookup(instance->shape, name), NULL_VAL };
+    if (entry.slot >= 0) {
+        *out = instance->fields[entry.slot];
+    } else if (value_table_get(&instance->klass->methods, name, out)) {
+        entry.method = *out;
+    } else {
+        return false;
+    }
+    cache_add(cache, entry);
+    return true;
+}
+
+void inline_cache_set(InlineCache* cache, ObjInstance* instance, ObjString* name, Value value) {
+    for (int i = 0; i < cache->count; i++) {
+        InlineCacheEntry* entry = &cache->entries[i];
+        if (entry->shape != instance->shape) continue;
+        if (entry->transition) append_slot(instance, entry->transition);
+        gc_write_barrier(&instance->obj, value);
+        instance->fields[entry->slot] = value;
+        return;
+    }
+
+    InlineCacheEntry entry = { instance->shape, NULL, shape_lookup(instance->shape, name), NULL_VAL };
+    if (entry.slot < 0) {
+        entry.transition = shape_add_field(instance->shape, name);
+        entry.slot = append_slot(instance, entry.transition);
+    }
+    gc_write_barrier(&instance->obj, value);
+    instance->fields[entry.slot] = value;
+    cache_add(cache, entry);
+}
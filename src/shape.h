@@ -0,0 +1,44 @@
+#ifndef OJISAN_SHAPE_H
+#define OJISAN_SHAPE_H
+
+#include "value.h"
+
+typedef struct Shape Shape;
+
+struct Shape {
+    Shape* parent;
+    ObjString* key;
+    int slot_count;
+    ValueTable slots;
+    Shape** transitions;
+    int transition_count;
+    int transition_capacity;
+    Shape* next_all;
+};
+
+#define INLINE_CACHE_SIZE 4
+
+typedef struct {
+    Shape* shape;
+    Shape* transition;
+    int slot;
+    Value method;
+} InlineCacheEntry;
+
+typedef struct InlineCache {
+    InlineCacheEntry entries[INLINE_CACHE_SIZE];
+    int count;
+} InlineCache;
+
+Shape* shape_new_root(void);
+Shape* shape_add_field(Shape* shape, ObjString* key);
+int shape_lookup(Shape* shape, ObjString* key);
+void shape_mark_all(void);
+
+bool instance_get_field(ObjInstance* instance, ObjString* name, Value* out);
+void instance_set_field(ObjInstance* instance, ObjString* name, Value value);
+
+bool inline_cache_get(InlineCache* cache, ObjInstance* instance, ObjString* name, Value* out);
+void inline_cache_set(InlineCache* cache, ObjInstance* instance, ObjString* name, Value value);
+
+#endif 
@@ -0,0 +1,514 @@
+#include "sort.h"
+#include "builtins.h"
+#include "gc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define INSERTION_RUN 32
+#define SIGN_FLIP ((uint64_t)1 << 63)
+#define PARALLEL_THRESHOLD 100000
+#define MAX_SORT_WORKERS 64
+
+typedef enum {
+    KIND_EMPTY,
+    KIND_INT,
+    KIND_FLOAT,
+    KIND_NUMBER,
+    KIND_STRING,
+    KIND_MIXED
+} SortKind;
+
+typedef struct {
+    const char* chars;
+    int length;
+    Value value;
+} StringKey;
+
+typedef struct {
+    Value comparator;
+    Value* items;
+    bool failed;
+} ComparatorContext;
+
+typedef void (*ChunkSortFn)(void* data, void* tmp, int n);
+typedef void (*ChunkMergeFn)(const void* src, void* dst, int lo, int mid, int hi);
+
+typedef struct {
+    char* data;
+    char* tmp;
+    const char* src;
+    char* dst;
+    size_t size;
+    int n;
+    int chunks;
+    int width;
+    ChunkSortFn sort;
+    ChunkMergeFn merge;
+} ParallelSort;
+
+typedef struct {
+    ParallelSort* job;
+    void (*task)(ParallelSort* job, int index);
+    int first;
+    int stride;
+    int count;
+} SortWorker;
+
+static int sort_workers = 0;
+
+
+#define DEFINE_MERGE(name, Type, CMP) \
+static void name##_merge(const Type* src, Type* dst, int lo, int mid, int hi, void* ctx) { \
+    (void)ctx; \
+    int i = lo, j = mid, k = lo; \
+    if (mid >= hi || CMP(src[mid - 1], src[mid], ctx) <= 0) { \
+        memcpy(dst + lo, src + lo, sizeof(Type) * (hi - lo)); \
+        return; \
+    } \
+    while (i < mid && j < hi) dst[k++] = CMP(src[i], src[j], ctx) > 0 ? src[j++] : src[i++]; \
+    while (i < mid) dst[k++] = src[i++]; \
+    while (j < hi) dst[k++] = src[j++]; \
+}
+
+#define DEFINE_MERGE_SORT(name, Type, CMP) \
+DEFINE_MERGE(name, Type, CMP) \
+static void name##_insertion(Type* a, int lo, int hi, void* ctx) { \
+    (void)ctx; \
+    for (int i = lo + 1; i < hi; i++) { \
+        Type key = a[i]; \
+        int j = i; \
+        while (j > lo && CMP(a[j - 1], key, ctx) > 0) { \
+            a[j] = a[j - 1]; \
+            j--; \
+        } \
+        a[j] = key; \
+    } \
+} \
+static void name(Type* a, Type* tmp, int n, void* ctx) { \
+    for (int lo = 0; lo < n; lo += INSERTION_RUN) { \
+        name##_insertion(a, lo, lo + INSERTION_RUN < n ? lo + INSERTION_RUN : n, ctx); \
+    } \
+    Type* src = a; \
+    Type* dst = tmp; \
+    for (int width = INSERTION_RUN; width < n; width *= 2) { \
+        for (int lo = 0; lo < n; lo += 2 * width) { \
+            int mid = lo + width < n ? lo + width : n; \
+            int hi = lo + 2 * width < n ? lo + 2 * width : n; \
+            name##_merge(src, dst, lo, mid, hi, ctx); \
+        } \
+        Type* swap = src; \
+        src = dst; \
+        dst = swap; \
+    } \
+    if (src != a) memcpy(a, src, sizeof(Type) * n); \
+}
+
+#define DEFINE_CHUNK_KERNELS(name, Type) \
+static void name##_chunk(void* a, void* tmp, int n) { \
+    name((Type*)a, (Type*)tmp, n, NULL); \
+} \
+static void name##_merge_chunks(const void* src, void* dst, int lo, int mid, int hi) { \
+    name##_merge((const Type*)src, (Type*)dst, lo, mid, hi, NULL); \
+}
+
+
+static inline int compare_doubles(double a, double b) {
+    if (isnan(a) || isnan(b)) return isnan(a) - isnan(b);
+    return (a > b) - (a < b);
+}
+
+static inline int compare_numbers(Value a, Value b) {
+    if (IS_INT(a) && IS_INT(b)) return (AS_INT(a) > AS_INT(b)) - (AS_INT(a) < AS_INT(b));
+    double da = IS_INT(a) ? (double)AS_INT(a) : AS_FLOAT(a);
+    double db = IS_INT(b) ? (double)AS_INT(b) : AS_FLOAT(b);
+    return compare_doubles(da, db);
+}
+
+static inline int compare_bytes(const char* a, int a_length, const char* b, int b_length) {
+    int shared = a_length < b_length ? a_length : b_length;
+    int result = memcmp(a, b, shared);
+    if (result != 0) return result;
+    return (a_length > b_length) - (a_length < b_length);
+}
+
+static inline int value_rank(Value value) {
+    if (IS_INT(value) || IS_FLOAT(value)) return 0;
+    if (IS_OBJ(value) && AS_OBJ(value)->type == OBJ_STRING) return 1;
+    return 2;
+}
+
+static inline int compare_mixed(Value a, Value b) {
+    int ra = value_rank(a), rb = value_rank(b);
+    if (ra != rb) return ra - rb;
+    if (ra == 0) return compare_numbers(a, b);
+    if (ra == 1) {
+        ObjString* sa = (ObjString*)AS_OBJ(a);
+        ObjString* sb = (ObjString*)AS_OBJ(b);
+        return compare_bytes(sa->chars, sa->length, sb->chars, sb->length);
+    }
+    return 0;
+}
+
+static int call_comparator(int a, int b, ComparatorContext* ctx) {
+    if (ctx->failed) return 0;
+    Value args[2] = { ctx->items[a], ctx->items[b] };
+    Value result;
+    if (!builtins_call(ctx->comparator, 2, args, &result)) {
+        ctx->failed = true;
+        return 0;
+    }
+    if (IS_INT(result)) return (AS_INT(result) > 0) - (AS_INT(result) < 0);
+    if (IS_FLOAT(result)) return (AS_FLOAT(result) > 0) - (AS_FLOAT(result) < 0);
+    return 0;
+}
+
+#define DOUBLE_CMP(x, y, ctx) compare_doubles(x, y)
+#define NUMBER_CMP(x, y, ctx) compare_numbers(x, y)
+#define MIXED_CMP(x, y, ctx) compare_mixed(x, y)
+#define STRING_CMP(x, y, ctx) compare_bytes((x).chars, (x).length, (y).chars, (y).length)
+#define INDEX_CMP(x, y, ctx) call_comparator(x, y, (ComparatorContext*)(ctx))
+#define KEY_CMP(x, y, ctx) (((x) > (y)) - ((x) < (y)))
+
+DEFINE_MERGE_SORT(merge_sort_doubles, double, DOUBLE_CMP)
+DEFINE_MERGE_SORT(merge_sort_numbers, Value, NUMBER_CMP)
+DEFINE_MERGE_SORT(merge_sort_mixed, Value, MIXED_CMP)
+DEFINE_MERGE_SORT(merge_sort_strings, StringKey, STRING_CMP)
+DEFINE_MERGE_SORT(merge_sort_indices, int, INDEX_CMP)
+DEFINE_MERGE(merge_keys, uint64_t, KEY_CMP)
+
+DEFINE_CHUNK_KERNELS(merge_sort_doubles, double)
+DEFINE_CHUNK_KERNELS(merge_sort_numbers, Value)
+DEFINE_CHUNK_KERNELS(merge_sort_mixed, Value)
+DEFINE_CHUNK_KERNELS(merge_sort_strings, StringKey)
+
+
+static void radix_sort_keys(uint64_t* keys, uint64_t* tmp, int n) {
+    if (n < 2) return;
+    size_t counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < n; i++) {
+        uint64_t key = keys[i];
+        for (int pass = 0; pass < 8; pass++) counts[pass][(key >> (pass * 8)) & 0xff]++;
+    }
+    uint64_t* src = keys;
+    uint64_t* dst = tmp;
+    for (int pass = 0; pass < 8; pass++) {
+        int shift = pass * 8;
+        size_t* count = counts[pass];
+        if (count[(src[0] >> shift) & 0xff] == (size_t)n) continue;
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            size_t c = count[digit];
+            count[digit] = offset;
+            offset += c;
+        }
+        for (int i = 0; i < n; i++) dst[count[(src[i] >> shift) & 0xff]++] = src[i];
+        uint64_t* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != keys) memcpy(keys, src, sizeof(uint64_t) * n);
+}
+
+static void radix_sort_chunk(void* keys, void* tmp, int n) {
+    radix_sort_keys((uint64_t*)keys, (uint64_t*)tmp, n);
+}
+
+static void merge_keys_chunks(const void* src, void* dst, int lo, int mid, int hi) {
+    merge_keys_merge((const uint64_t*)src, (uint64_t*)dst, lo, mid, hi, NULL);
+}
+
+
+void sort_set_workers(int workers) {
+    sort_workers = workers < 1 ? 1 : workers > MAX_SORT_WORKERS ? MAX_SORT_WORKERS : workers;
+}
+
+static int worker_count(void) {
+    if (sort_workers > 0) return sort_workers;
+    const char* env = getenv("OJISAN_SORT_THREADS");
+    int workers = env ? atoi(env) : 0;
+    if (workers <= 0) {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        workers = (int)info.dwNumberOfProcessors;
+#else
+        workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    }
+    sort_set_workers(workers);
+    return sort_workers;
+}
+
+static void run_worker(SortWorker* worker) {
+    for (int i = worker->first; i < worker->count; i += worker->stride) worker->task(worker->job, i);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker_main(LPVOID arg) {
+    run_worker((SortWorker*)arg);
+    return 0;
+}
+#else
+static void* worker_main(void* arg) {
+    run_worker((SortWorker*)arg);
+    return NULL;
+}
+#endif
+
+static void run_tasks(ParallelSort* job, int count, void (*task)(ParallelSort* job, int index)) {
+    int threads = count < job->chunks ? count : job->chunks;
+    SortWorker workers[MAX_SORT_WORKERS];
+    bool started[MAX_SORT_WORKERS];
+#ifdef _WIN32
+    HANDLE handles[MAX_SORT_WORKERS];
+#else
+    pthread_t handles[MAX_SORT_WORKERS];
+#endif
+    for (int i = 0; i < threads; i++) {
+        workers[i] = (SortWorker){ job, task, i, threads, count };
+        started[i] = false;
+    }
+    for (int i = 1; i < threads; i++) {
+#ifdef _WIN32
+        handles[i] = CreateThread(NULL, 0, worker_main, &workers[i], 0, NULL);
+        started[i] = handles[i] != NULL;
+#else
+        started[i] = pthread_create(&handles[i], NULL, worker_main, &workers[i]) == 0;
+#endif
+    }
+    run_worker(&workers[0]);
+    for (int i = 1; i < threads; i++) {
+        if (!started[i]) {
+            run_worker(&workers[i]);
+            continue;
+        }
+#ifdef _WIN32
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+#else
+        pthread_join(handles[i], NULL);
+#endif
+    }
+}
+
+static inline int chunk_bound(ParallelSort* job, int chunk) {
+    if (chunk >= job->chunks) return job->n;
+    return (int)((int64_t)chunk * job->n / job->chunks);
+}
+
+static void sort_chunk_task(ParallelSort* job, int index) {
+    int lo = chunk_bound(job, index);
+    int hi = chunk_bound(job, index + 1);
+    job->sort(job->data + lo * job->size, job->tmp + lo * job->size, hi - lo);
+}
+
+static void merge_chunk_task(ParallelSort* job, int index) {
+    int first = index * 2 * job->width;
+    int lo = chunk_bound(job, first);
+    int mid = chunk_bound(job, first + job->width);
+    int hi = chunk_bound(job, first + 2 * job->width);
+    job->merge(job->src, job->dst, lo, mid, hi);
+}
+
+static void sort_chunks(void* data, void* tmp, size_t size, int n, ChunkSortFn sort, ChunkMergeFn merge) {
+    int workers = n < PARALLEL_THRESHOLD ? 1 : worker_count();
+    if (workers < 2) {
+        sort(data, tmp, n);
+        return;
+    }
+    ParallelSort job = { data, tmp, NULL, NULL, size, n, workers, 1, sort, merge };
+    run_tasks(&job, job.chunks, sort_chunk_task);
+    job.src = job.data;
+    job.dst = job.tmp;
+    for (; job.width < job.chunks; job.width *= 2) {
+        int pairs = (job.chunks + 2 * job.width - 1) / (2 * job.width);
+        run_tasks(&job, pairs, merge_chunk_task);
+        char* swap = (char*)job.src;
+        job.src = job.dst;
+        job.dst = swap;
+    }
+    if (job.src != job.data) memcpy(job.data, job.src, size * n);
+}
+
+static inline uint64_t int_key(int64_t value) {
+    return (uint64_t)value ^ SIGN_FLIP;
+}
+
+static inline int64_t key_int(uint64_t key) {
+    return (int64_t)(key ^ SIGN_FLIP);
+}
+
+static inline bool float_key_exact(double value) {
+    return !isnan(value) && !(value == 0 && signbit(value));
+}
+
+static inline uint64_t float_key(double value) {
+    if (isnan(value)) return UINT64_MAX;
+    if (value == 0) value = 0.0;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & SIGN_FLIP) ? ~bits : bits ^ SIGN_FLIP;
+}
+
+static inline double key_float(uint64_t key) {
+    uint64_t bits = (key & SIGN_FLIP) ? key ^ SIGN_FLIP : ~key;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+static SortKind classify(Value* items, int n) {
+    if (n == 0) return KIND_EMPTY;
+    bool ints = true, floats = true, numbers = true, strings = true;
+    for (int i = 0; i < n; i++) {
+        Value v = items[i];
+#ifdef NAN_BOXING
+        bool is_int = IS_SMALL_INT(v);
+        if (IS_BOXED_INT(v)) floats = ints = strings = false;
+#else
+        bool is_int = IS_INT(v);
+#endif
+        bool is_float = IS_FLOAT(v);
+        if (is_float && !float_key_exact(AS_FLOAT(v))) floats = false;
+        bool is_string = IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING;
+        ints = ints && is_int;
+        floats = floats && is_float;
+        numbers = numbers && (IS_INT(v) || is_float);
+        strings = strings && is_string;
+        if (!ints && !floats && !numbers && !strings) return KIND_MIXED;
+    }
+    if (ints) return KIND_INT;
+    if (floats) return KIND_FLOAT;
+    if (numbers) return KIND_NUMBER;
+    if (strings) return KIND_STRING;
+    return KIND_MIXED;
+}
+
+static void sort_ints(Value* items, int n) {
+    uint64_t* keys = malloc(sizeof(uint64_t) * n * 2);
+    for (int i = 0; i < n; i++) keys[i] = int_key(AS_INT(items[i]));
+    sort_chunks(keys, keys + n, sizeof(uint64_t), n, radix_sort_chunk, merge_keys_chunks);
+    for (int i = 0; i < n; i++) items[i] = INT_VAL(key_int(keys[i]));
+    free(keys);
+}
+
+static void sort_floats(Value* items, int n) {
+    uint64_t* keys = malloc(sizeof(uint64_t) * n * 2);
+    for (int i = 0; i < n; i++) keys[i] = float_key(AS_FLOAT(items[i]));
+    sort_chunks(keys, keys + n, sizeof(uint64_t), n, radix_sort_chunk, merge_keys_chunks);
+    for (int i = 0; i < n; i++) items[i] = FLOAT_VAL(key_float(keys[i]));
+    free(keys);
+}
+
+static void sort_strings(Value* items, int n) {
+    StringKey* keys = malloc(sizeof(StringKey) * n * 2);
+    for (int i = 0; i < n; i++) {
+        ObjString* string = AS_STRING(items[i]);
+        keys[i] = (StringKey){string->chars, string->length, items[i]};
+    }
+    sort_chunks(keys, keys + n, sizeof(StringKey), n, merge_sort_strings_chunk, merge_sort_strings_merge_chunks);
+    for (int i = 0; i < n; i++) items[i] = keys[i].value;
+    free(keys);
+}
+
+static void sort_values(Value* items, int n, SortKind kind) {
+    Value* tmp = malloc(sizeof(Value) * n);
+    if (kind == KIND_NUMBER) {
+        sort_chunks(items, tmp, sizeof(Value), n, merge_sort_numbers_chunk, merge_sort_numbers_merge_chunks);
+    } else {
+        for (int i = 0; i < n; i++) {
+            if (IS_OBJ(items[i]) && AS_OBJ(items[i])->type == OBJ_STRING) string_flatten((ObjString*)AS_OBJ(items[i]));
+        }
+        sort_chunks(items, tmp, sizeof(Value), n, merge_sort_mixed_chunk, merge_sort_mixed_merge_chunks);
+    }
+    free(tmp);
+}
+
+static bool sort_with_comparator(ObjList* list, Value comparator) {
+    int n = list->count;
+    ObjList* snapshot = new_list();
+    GcRootMark roots = gc_root_mark();
+    gc_push_root(OBJ_VAL(snapshot));
+    list_ensure_capacity(snapshot, n);
+    memcpy(snapshot->items, list->items, sizeof(Value) * n);
+    snapshot->count = n;
+
+    int* order = malloc(sizeof(int) * n * 2);
+    for (int i = 0; i < n; i++) order[i] = i;
+    ComparatorContext ctx = { comparator, snapshot->items, false };
+    merge_sort_indices(order, order + n, n, &ctx);
+
+    if (!ctx.failed && list->count != n) {
+        builtins_raise(ERR_RUNTIME, "並べ替えてる途中で配列の長さが変わっちゃったヨ😅💦");
+        ctx.failed = true;
+    }
+    if (!ctx.failed) {
+        for (int i = 0; i < n; i++) {
+            Value item = snapshot->items[order[i]];
+            gc_list_write_barrier(list, i, item);
+            list->items[i] = item;
+        }
+        gc_list_moved_items(list);
+    }
+    free(order);
+    gc_root_reset(roots);
+    return !ctx.failed;
+}
+
+bool sort_list(ObjList* list, Value comparator) {
+    int n = list->count;
+    if (!IS_NULL(comparator)) return sort_with_comparator(list, comparator);
+    if (n < 2) return true;
+    SortKind kind = classify(list->items, n);
+    switch (kind) {
+        case KIND_INT: sort_ints(list->items, n); break;
+        case KIND_FLOAT: sort_floats(list->items, n); break;
+        case KIND_STRING: sort_strings(list->items, n); break;
+        case KIND_NUMBER:
+        case KIND_MIXED: sort_values(list->items, n, kind); break;
+        case KIND_EMPTY: break;
+    }
+    gc_list_moved_items(list);
+    return true;
+}
+
+void sort_typed_array(ObjTypedArray* array) {
+    int n = array->count;
+    if (n < 2) return;
+    uint64_t* keys = (uint64_t*)array->as.ints;
+    uint64_t* tmp = malloc(sizeof(uint64_t) * n);
+    if (array->kind == TYPED_INT64) {
+        for (int i = 0; i < n; i++) keys[i] = int_key(array->as.ints[i]);
+        sort_chunks(keys, tmp, sizeof(uint64_t), n, radix_sort_chunk, merge_keys_chunks);
+        for (int i = 0; i < n; i++) array->as.ints[i] = key_int(keys[i]);
+        free(tmp);
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        if (float_key_exact(array->as.floats[i])) continue;
+        sort_chunks(array->as.floats, tmp, sizeof(double), n, merge_sort_doubles_chunk, merge_sort_doubles_merge_chunks);
+        free(tmp);
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        double value;
+        memcpy(&value, keys + i, sizeof(value));
+        keys[i] = float_key(value);
+    }
+    sort_chunks(keys, tmp, sizeof(uint64_t), n, radix_sort_chunk, merge_keys_chunks);
+    for (int i = 0; i < n; i++) {
+        double value = key_float(keys[i]);
+        memcpy(keys + i, &value, sizeof(value));
+    }
+    free(tmp);
+}
@@ -0,0 +1,15 @@
+#ifndef OJISAN_SORT_H
+#define OJISAN_SORT_H
+
+#include "value.h"
+
+
+bool sort_list(ObjList* list, Value comparator);
+
+
+void sort_typed_array(ObjTypedArray* array);
+
+
+void sort_set_workers(int workers);
+
+#endif
@@ -0,0 +1,85 @@
+#include "source.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static bool read_whole_file(SourceFile* source, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+    fseek(file, 0L, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    if (size < 0) size = 0;
+    char* buffer = malloc((size_t)size + 1);
+    if (buffer == NULL) {
+        fclose(file);
+        return false;
+    }
+    size_t read = fread(buffer, 1, (size_t)size, file);
+    buffer[read] = '\0';
+    fclose(file);
+    source->text = buffer;
+    source->length = read;
+    source->mapping = NULL;
+    source->mapping_size = 0;
+    return true;
+}
+
+#ifndef _WIN32
+static bool map_file(SourceFile* source, int fd, size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t mapping_size = (size + 1 + page - 1) / page * page;
+
+    void* mapping = mmap(NULL, mapping_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return false;
+
+    if (mmap(mapping, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(mapping, mapping_size);
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(mapping, size, MADV_SEQUENTIAL);
+#endif
+    source->text = mapping;
+    source->length = size;
+    source->mapping = mapping;
+    source->mapping_size = mapping_size;
+    return true;
+}
+#endif
+
+bool source_open(SourceFile* source, const char* path) {
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        bool mapped = map_file(source, fd, (size_t)st.st_size);
+        close(fd);
+        if (mapped) return true;
+    } else {
+        close(fd);
+    }
+#endif
+    return read_whole_file(source, path);
+}
+
+void source_close(SourceFile* source) {
+    if (source->mapping != NULL) {
+#ifndef _WIN32
+        munmap(source->mapping, source->mapping_size);
+#endif
+    } else {
+        free((char*)source->text);
+    }
+    source->text = NULL;
+    source->length = 0;
+    source->mapping = NULL;
+    source->mapping_size = 0;
+}
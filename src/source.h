@@ -0,0 +1,18 @@
+#ifndef OJISAN_SOURCE_H
+#define OJISAN_SOURCE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct {
+    const char* text;
+    size_t length;
+    void* mapping;
+    size_t mapping_size;
+} SourceFile;
+
+
+bool source_open(SourceFile* source, const char* path);
+void source_close(SourceFile* source);
+
+#endif
@@ -98,6 +98,13 @@ typedef struct {
     int line;
 } Token;
 
+typedef struct {
+    unsigned int offset;
+    unsigned int length;
+    int line;
+    unsigned char type;
+} PackedToken;
+
 void print_token(Token token);
 
 #endif 
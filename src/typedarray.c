@@ -0,0 +1,319 @@
+#include "typedarray.h"
+#include "gc.h"
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+#define IS_NUMBER(v) (IS_INT(v) || IS_FLOAT(v))
+#define NUMBER_AS_DOUBLE(v) (IS_INT(v) ? (double)AS_INT(v) : AS_FLOAT(v))
+
+static inline double element_as_double(ObjTypedArray* array, int index) {
+    return array->kind == TYPED_INT64 ? (double)array->as.ints[index] : array->as.floats[index];
+}
+
+static inline bool is_typed_array(Value value) {
+    return IS_OBJ(value) && AS_OBJ(value)->type == OBJ_TYPED_ARRAY;
+}
+
+
+bool typed_array_set(ObjTypedArray* array, int index, Value value) {
+    if (array->kind == TYPED_INT64) {
+        if (!IS_INT(value)) return false;
+        array->as.ints[index] = AS_INT(value);
+        return true;
+    }
+    if (!IS_NUMBER(value)) return false;
+    array->as.floats[index] = NUMBER_AS_DOUBLE(value);
+    return true;
+}
+
+ObjTypedArray* typed_array_from_list(ObjList* list, TypedKind kind) {
+    for (int i = 0; i < list->count; i++) {
+        Value item = list->items[i];
+        if (kind == TYPED_INT64 ? !IS_INT(item) : !IS_NUMBER(item)) return NULL;
+    }
+    ObjTypedArray* array = new_typed_array(kind, list->count);
+    for (int i = 0; i < list->count; i++) {
+        typed_array_set(array, i, list->items[i]);
+    }
+    return array;
+}
+
+ObjList* typed_array_to_list(ObjTypedArray* array) {
+    ObjList* list = new_list();
+    GcRootMark roots = gc_root_mark();
+    gc_push_root(OBJ_VAL(list));
+    list_ensure_capacity(list, array->count);
+    for (int i = 0; i < array->count; i++) {
+        Value item = typed_array_get(array, i);
+        gc_list_write_barrier(list, list->count, item);
+        list->items[list->count++] = item;
+    }
+    gc_root_reset(roots);
+    return list;
+}
+
+
+static int64_t sum_i64(const int64_t* restrict data, int count) {
+    int i = 0;
+    uint64_t total = 0;
+#if defined(__SSE2__)
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_epi64(acc0, _mm_loadu_si128((const __m128i*)(data + i)));
+        acc1 = _mm_add_epi64(acc1, _mm_loadu_si128((const __m128i*)(data + i + 2)));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, _mm_add_epi64(acc0, acc1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < count; i++) total += (uint64_t)data[i];
+    return (int64_t)total;
+}
+
+static double sum_f64(const double* restrict data, int count) {
+    int i = 0;
+    double total = 0.0;
+#if defined(__SSE2__)
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(data + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(data + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < count; i++) total += data[i];
+    return total;
+}
+
+static double dot_f64(const double* restrict a, const double* restrict b, int count) {
+    int i = 0;
+    double total = 0.0;
+#if defined(__SSE2__)
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < count; i++) total += a[i] * b[i];
+    return total;
+}
+
+static int64_t dot_i64(const int64_t* restrict a, const int64_t* restrict b, int count) {
+    uint64_t acc[4] = {0, 0, 0, 0};
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (int lane = 0; lane < 4; lane++) acc[lane] += (uint64_t)a[i + lane] * (uint64_t)b[i + lane];
+    }
+    uint64_t total = acc[0] + acc[1] + acc[2] + acc[3];
+    for (; i < count; i++) total += (uint64_t)a[i] * (uint64_t)b[i];
+    return (int64_t)total;
+}
+
+static void add_f64(double* restrict out, const double* restrict a, const double* restrict b, int count) {
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+#endif
+    for (; i < count; i++) out[i] = a[i] + b[i];
+}
+
+static void add_i64(int64_t* restrict out, const int64_t* restrict a, const int64_t* restrict b, int count) {
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= count; i += 2) {
+        __m128i sum = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        _mm_storeu_si128((__m128i*)(out + i), sum);
+    }
+#endif
+    for (; i < count; i++) out[i] = (int64_t)((uint64_t)a[i] + (uint64_t)b[i]);
+}
+
+static void scale_f64(double* restrict out, const double* restrict a, double factor, int count) {
+    int i = 0;
+#if defined(__SSE2__)
+    __m128d k = _mm_set1_pd(factor);
+    for (; i + 2 <= count; i += 2) {
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(a + i), k));
+    }
+#endif
+    for (; i < count; i++) out[i] = a[i] * factor;
+}
+
+
+Value typed_array_sum(ObjTypedArray* array) {
+    if (array->kind == TYPED_INT64) return INT_VAL(sum_i64(array->as.ints, array->count));
+    return FLOAT_VAL(sum_f64(array->as.floats, array->count));
+}
+
+#define REDUCE_LANES(type, data, count, better, out) do { \
+    type lane[4] = {data[0], data[0], data[0], data[0]}; \
+    int i = 0; \
+    for (; i + 4 <= count; i += 4) { \
+        for (int k = 0; k < 4; k++) lane[k] = better(data[i + k], lane[k]) ? data[i + k] : lane[k]; \
+    } \
+    for (; i < count; i++) lane[0] = better(data[i], lane[0]) ? data[i] : lane[0]; \
+    out = lane[0]; \
+    for (int k = 1; k < 4; k++) out = better(lane[k], out) ? lane[k] : out; \
+} while (0)
+
+#define LESS(a, b) ((a) < (b))
+#define GREATER(a, b) ((a) > (b))
+
+Value typed_array_min(ObjTypedArray* array) {
+    if (array->count == 0) return NULL_VAL;
+    if (array->kind == TYPED_INT64) {
+        int64_t result;
+        REDUCE_LANES(int64_t, array->as.ints, array->count, LESS, result);
+        return INT_VAL(result);
+    }
+    double result;
+    REDUCE_LANES(double, array->as.floats, array->count, LESS, result);
+    return FLOAT_VAL(result);
+}
+
+Value typed_array_max(ObjTypedArray* array) {
+    if (array->count == 0) return NULL_VAL;
+    if (array->kind == TYPED_INT64) {
+        int64_t result;
+        REDUCE_LANES(int64_t, array->as.ints, array->count, GREATER, result);
+        return INT_VAL(result);
+    }
+    double result;
+    REDUCE_LANES(double, array->as.floats, array->count, GREATER, result);
+    return FLOAT_VAL(result);
+}
+
+Value typed_array_dot(ObjTypedArray* a, ObjTypedArray* b) {
+    if (a->count != b->count) return NULL_VAL;
+    if (a->kind == TYPED_INT64 && b->kind == TYPED_INT64) {
+        return INT_VAL(dot_i64(a->as.ints, b->as.ints, a->count));
+    }
+    if (a->kind == TYPED_FLOAT64 && b->kind == TYPED_FLOAT64) {
+        return FLOAT_VAL(dot_f64(a->as.floats, b->as.floats, a->count));
+    }
+    double total = 0.0;
+    for (int i = 0; i < a->count; i++) total += element_as_double(a, i) * element_as_double(b, i);
+    return FLOAT_VAL(total);
+}
+
+
+ObjTypedArray* typed_array_scale(ObjTypedArray* array, Value factor) {
+    if (!IS_NUMBER(factor)) return NULL;
+    int count = array->count;
+    if (array->kind == TYPED_INT64 && IS_INT(factor)) {
+        ObjTypedArray* result = new_typed_array(TYPED_INT64, count);
+        uint64_t k = (uint64_t)AS_INT(factor);
+        for (int i = 0; i < count; i++) result->as.ints[i] = (int64_t)((uint64_t)array->as.ints[i] * k);
+        return result;
+    }
+    ObjTypedArray* result = new_typed_array(TYPED_FLOAT64, count);
+    double k = NUMBER_AS_DOUBLE(factor);
+    if (array->kind == TYPED_FLOAT64) {
+        scale_f64(result->as.floats, array->as.floats, k, count);
+    } else {
+        for (int i = 0; i < count; i++) result->as.floats[i] = (double)array->as.ints[i] * k;
+    }
+    return result;
+}
+
+ObjTypedArray* typed_array_add(ObjTypedArray* array, Value other) {
+    int count = array->count;
+    if (IS_NUMBER(other)) {
+        if (array->kind == TYPED_INT64 && IS_INT(other)) {
+            ObjTypedArray* result = new_typed_array(TYPED_INT64, count);
+            uint64_t k = (uint64_t)AS_INT(other);
+            for (int i = 0; i < count; i++) result->as.ints[i] = (int64_t)((uint64_t)array->as.ints[i] + k);
+            return result;
+        }
+        ObjTypedArray* result = new_typed_array(TYPED_FLOAT64, count);
+        double k = NUMBER_AS_DOUBLE(other);
+        for (int i = 0; i < count; i++) result->as.floats[i] = element_as_double(array, i) + k;
+        return result;
+    }
+    if (!is_typed_array(other)) return NULL;
+    ObjTypedArray* rhs = (ObjTypedArray*)AS_OBJ(other);
+    if (rhs->count != count) return NULL;
+    if (array->kind == TYPED_INT64 && rhs->kind == TYPED_INT64) {
+        ObjTypedArray* result = new_typed_array(TYPED_INT64, count);
+        add_i64(result->as.ints, array->as.ints, rhs->as.ints, count);
+        return result;
+    }
+    ObjTypedArray* result = new_typed_array(TYPED_FLOAT64, count);
+    if (array->kind == TYPED_FLOAT64 && rhs->kind == TYPED_FLOAT64) {
+        add_f64(result->as.floats, array->as.floats, rhs->as.floats, count);
+    } else {
+        for (int i = 0; i < count; i++) result->as.floats[i] = element_as_double(array, i) + element_as_double(rhs, i);
+    }
+    return result;
+}
+
+ObjTypedArray* typed_array_prefix_sum(ObjTypedArray* array) {
+    int count = array->count;
+    ObjTypedArray* result = new_typed_array(array->kind, count);
+    if (array->kind == TYPED_INT64) {
+        uint64_t running = 0;
+        for (int i = 0; i < count; i++) {
+            running += (uint64_t)array->as.ints[i];
+            result->as.ints[i] = (int64_t)running;
+        }
+    } else {
+        double running = 0.0;
+        for (int i = 0; i < count; i++) {
+            running += array->as.floats[i];
+            result->as.floats[i] = running;
+        }
+    }
+    return result;
+}
+
+ObjTypedArray* typed_array_compare(ObjTypedArray* array, Value other) {
+    int count = array->count;
+    ObjTypedArray* rhs = NULL;
+    if (is_typed_array(other)) {
+        rhs = (ObjTypedArray*)AS_OBJ(other);
+        if (rhs->count != count) return NULL;
+    } else if (!IS_NUMBER(other)) {
+        return NULL;
+    }
+    ObjTypedArray* result = new_typed_array(TYPED_INT64, count);
+    int64_t* restrict out = result->as.ints;
+    if (array->kind == TYPED_INT64 && (rhs ? rhs->kind == TYPED_INT64 : IS_INT(other))) {
+        const int64_t* restrict a = array->as.ints;
+        if (rhs != NULL) {
+            const int64_t* restrict b = rhs->as.ints;
+            for (int i = 0; i < count; i++) out[i] = (a[i] > b[i]) - (a[i] < b[i]);
+        } else {
+            int64_t k = AS_INT(other);
+            for (int i = 0; i < count; i++) out[i] = (a[i] > k) - (a[i] < k);
+        }
+        return result;
+    }
+    if (array->kind == TYPED_FLOAT64 && rhs != NULL && rhs->kind == TYPED_FLOAT64) {
+        const double* restrict a = array->as.floats;
+        const double* restrict b = rhs->as.floats;
+        for (int i = 0; i < count; i++) out[i] = (a[i] > b[i]) - (a[i] < b[i]);
+        return result;
+    }
+    double k = rhs ? 0.0 : NUMBER_AS_DOUBLE(other);
+    for (int i = 0; i < count; i++) {
+        double x = element_as_double(array, i);
+        double y = rhs ? element_as_double(rhs, i) : k;
+        out[i] = (x > y) - (x < y);
+    }
+    return result;
+}
@@ -0,0 +1,31 @@
+#ifndef OJISAN_TYPEDARRAY_H
+#define OJISAN_TYPEDARRAY_H
+
+#include "value.h"
+
+
+static inline Value typed_array_get(ObjTypedArray* array, int index) {
+    if (array->kind == TYPED_INT64) return INT_VAL(array->as.ints[index]);
+    return FLOAT_VAL(array->as.floats[index]);
+}
+
+
+bool typed_array_set(ObjTypedArray* array, int index, Value value);
+
+
+ObjTypedArray* typed_array_from_list(ObjList* list, TypedKind kind);
+ObjList* typed_array_to_list(ObjTypedArray* array);
+
+
+Value typed_array_sum(ObjTypedArray* array);
+Value typed_array_min(ObjTypedArray* array);
+Value typed_array_max(ObjTypedArray* array);
+Value typed_array_dot(ObjTypedArray* a, ObjTypedArray* b);
+
+
+ObjTypedArray* typed_array_scale(ObjTypedArray* array, Value factor);
+ObjTypedArray* typed_array_add(ObjTypedArray* array, Value other);
+ObjTypedArray* typed_array_prefix_sum(ObjTypedArray* array);
+ObjTypedArray* typed_array_compare(ObjTypedArray* array, Value other);
+
+#endif
@@ -1,9 +1,15 @@
 #include "value.h"
 #include "gc.h"
 #include "hashtable.h"
+#include "valuetable.h"
+#include "shape.h"
+#include "chunk.h"
+#include "pool.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <math.h>
 
 
 typedef struct {
@@ -11,25 +17,25 @@ typedef struct {
 } DictPrintContext;
 
 
-static void dict_print_entry(const char* key, void* value, void* userdata) {
+static void dict_print_entry(ObjString* key, Value value, void* userdata) {
     DictPrintContext* ctx = (DictPrintContext*)userdata;
     if (!ctx->first) {
         printf("、");
     }
     ctx->first = false;
-    printf("%s→", key);
-    value_print(*(Value*)value);
+    printf("%s→", key->chars);
+    value_print(value);
 }
 
 void value_print(Value value) {
-    switch (value.type) {
+    switch (VALUE_TYPE(value)) {
         case VAL_NULL: printf("ナイナイ"); break;
         case VAL_BOOL: printf(AS_BOOL(value) ? "マジ" : "ウソ"); break;
         case VAL_INT: printf("%lld", AS_INT(value)); break;
         case VAL_FLOAT: printf("%g", AS_FLOAT(value)); break;
         case VAL_OBJ:
             switch (AS_OBJ(value)->type) {
-                case OBJ_STRING: printf("%s", ((ObjString*)AS_OBJ(value))->chars); break;
+                case OBJ_STRING: printf("%s", AS_STRING(value)->chars); break;
                 case OBJ_LIST: {
                     ObjList* list = (ObjList*)AS_OBJ(value);
                     printf("【");
@@ -44,7 +50,7 @@ void value_print(Value value) {
                     ObjDict* dict = (ObjDict*)AS_OBJ(value);
                     printf("《");
                     DictPrintContext ctx = { .first = true };
-                    table_iterate(dict->items, dict_print_entry, &ctx);
+                    value_table_iterate(&dict->items, dict_print_entry, &ctx);
                     printf("》");
                     break;
                 }
@@ -52,29 +58,46 @@ void value_print(Value value) {
                 case OBJ_CLASS: printf("クラス「%s」サンだヨ😁", ((ObjClass*)AS_OBJ(value))->name); break;
                 case OBJ_INSTANCE: printf("「%s」サンのインスタンスだヨ😁", ((ObjInstance*)AS_OBJ(value))->klass->name); break;
                 case OBJ_NATIVE: printf("ネイティブ関数だヨ😁"); break;
+                case OBJ_CLOSURE: {
+                    ObjFunc* fn = ((ObjClosure*)AS_OBJ(value))->function;
+                    printf("関数「%s」チャンだヨ😁", fn->name ? fn->name : "無名");
+                    break;
+                }
+                case OBJ_UPVALUE: printf("アップバリューだヨ😁"); break;
+                case OBJ_INT: printf("%lld", ((ObjInt*)AS_OBJ(value))->value); break;
+                case OBJ_TYPED_ARRAY: {
+                    ObjTypedArray* array = (ObjTypedArray*)AS_OBJ(value);
+                    printf("【");
+                    for (int i = 0; i < array->count; i++) {
+                        if (i > 0) printf("、");
+                        if (array->kind == TYPED_INT64) printf("%lld", (long long)array->as.ints[i]);
+                        else printf("%g", array->as.floats[i]);
+                    }
+                    printf("】");
+                    break;
+                }
             }
             break;
     }
 }
 
 bool value_equal(Value a, Value b) {
-    if (a.type != b.type) return false;
-    switch (a.type) {
+    if (VALUE_TYPE(a) != VALUE_TYPE(b)) return false;
+    switch (VALUE_TYPE(a)) {
         case VAL_NULL: return true;
         case VAL_BOOL: return AS_BOOL(a) == AS_BOOL(b);
         case VAL_INT: return AS_INT(a) == AS_INT(b);
         case VAL_FLOAT: return AS_FLOAT(a) == AS_FLOAT(b);
         case VAL_OBJ:
-            if (AS_OBJ(a)->type == OBJ_STRING && AS_OBJ(b)->type == OBJ_STRING) {
-                return strcmp(((ObjString*)AS_OBJ(a))->chars, ((ObjString*)AS_OBJ(b))->chars) == 0;
-            }
-            return AS_OBJ(a) == AS_OBJ(b);
+            if (AS_OBJ(a) == AS_OBJ(b)) return true;
+            if (AS_OBJ(a)->type != OBJ_STRING || AS_OBJ(b)->type != OBJ_STRING) return false;
+            return string_equal((ObjString*)AS_OBJ(a), (ObjString*)AS_OBJ(b));
     }
     return false;
 }
 
 const char* value_type_name(Value value) {
-    switch (value.type) {
+    switch (VALUE_TYPE(value)) {
         case VAL_NULL: return "ナイナイダヨ😁";
         case VAL_BOOL: return "真偽値ダヨ😁";
         case VAL_INT: return "整数ダヨ😁";
@@ -88,6 +111,11 @@ const char* value_type_name(Value value) {
                 case OBJ_CLASS: return "クラスダヨ😁";
                 case OBJ_INSTANCE: return "インスタンスダヨ😁";
                 case OBJ_NATIVE: return "ネイティブ関数ダヨ😁";
+                case OBJ_CLOSURE: return "関数ダヨ😁";
+                case OBJ_UPVALUE: return "アップバリューダヨ😁";
+                case OBJ_INT: return "整数ダヨ😁";
+                case OBJ_TYPED_ARRAY:
+                    return ((ObjTypedArray*)AS_OBJ(value))->kind == TYPED_INT64 ? "整数配列ダヨ😁" : "小数配列ダヨ😁";
             }
             break;
     }
@@ -95,69 +123,504 @@ const char* value_type_name(Value value) {
 }
 
 
+#define NUM_AS_DOUBLE(v) (IS_INT(v) ? (double)AS_INT(v) : AS_FLOAT(v))
+#define IS_NUM(v) (IS_INT(v) || IS_FLOAT(v))
+
+const char* value_concat_operand(Value v, char* buf, size_t size) {
+    if (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING) return AS_STRING(v)->chars;
+    if (IS_INT(v)) { snprintf(buf, size, "%lld", AS_INT(v)); return buf; }
+    if (IS_FLOAT(v)) { snprintf(buf, size, "%g", AS_FLOAT(v)); return buf; }
+    if (IS_BOOL(v)) return AS_BOOL(v) ? "マジ" : "ウソ";
+    if (IS_NULL(v)) return "ナイナイ";
+    return "";
+}
+
+static ObjString* string_concat(Value l, Value r);
+
+BinaryOpStatus value_binary_op(TokenType op, Value l, Value r, Value* out) {
+    switch (op) {
+        case TOK_TO:
+            if (IS_INT(l) && IS_INT(r)) {
+                long long a = AS_INT(l), b = AS_INT(r);
+                if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b)) {
+                    *out = FLOAT_VAL((double)a + (double)b);
+                } else {
+                    *out = INT_VAL(a + b);
+                }
+                return BINOP_OK;
+            }
+            if (IS_NUM(l) && IS_NUM(r)) { *out = FLOAT_VAL(NUM_AS_DOUBLE(l) + NUM_AS_DOUBLE(r)); return BINOP_OK; }
+            if ((IS_OBJ(l) && AS_OBJ(l)->type == OBJ_STRING) || (IS_OBJ(r) && AS_OBJ(r)->type == OBJ_STRING)) {
+                *out = OBJ_VAL(string_concat(l, r));
+                return BINOP_OK;
+            }
+            return BINOP_TYPE_ERROR;
+        case TOK_HIKU:
+            if (IS_INT(l) && IS_INT(r)) { *out = INT_VAL(AS_INT(l) - AS_INT(r)); return BINOP_OK; }
+            if (IS_NUM(l) && IS_NUM(r)) { *out = FLOAT_VAL(NUM_AS_DOUBLE(l) - NUM_AS_DOUBLE(r)); return BINOP_OK; }
+            return BINOP_TYPE_ERROR;
+        case TOK_KAKERU:
+            if (IS_INT(l) && IS_INT(r)) {
+                long long a = AS_INT(l), b = AS_INT(r);
+                if (a != 0 && b != 0 && ((a > 0) == (b > 0)
+                    ? (a > LLONG_MAX / b) : (a < LLONG_MIN / b))) {
+                    *out = FLOAT_VAL((double)a * (double)b);
+                } else {
+                    *out = INT_VAL(a * b);
+                }
+                return BINOP_OK;
+            }
+            if (IS_NUM(l) && IS_NUM(r)) { *out = FLOAT_VAL(NUM_AS_DOUBLE(l) * NUM_AS_DOUBLE(r)); return BINOP_OK; }
+            return BINOP_TYPE_ERROR;
+        case TOK_WARU:
+            if (IS_INT(l) && IS_INT(r)) {
+                if (AS_INT(r) == 0) return BINOP_ZERO_DIV;
+                *out = INT_VAL(AS_INT(l) / AS_INT(r));
+                return BINOP_OK;
+            }
+            if (IS_NUM(l) && IS_NUM(r)) {
+                if (NUM_AS_DOUBLE(r) == 0.0) return BINOP_ZERO_DIV;
+                *out = FLOAT_VAL(NUM_AS_DOUBLE(l) / NUM_AS_DOUBLE(r));
+                return BINOP_OK;
+            }
+            return BINOP_TYPE_ERROR;
+        case TOK_AMARI:
+            if (IS_INT(l) && IS_INT(r)) {
+                if (AS_INT(r) == 0) return BINOP_ZERO_DIV;
+                *out = INT_VAL(AS_INT(l) % AS_INT(r));
+                return BINOP_OK;
+            }
+            if (IS_NUM(l) && IS_NUM(r)) {
+                if (NUM_AS_DOUBLE(r) == 0.0) return BINOP_ZERO_DIV;
+                *out = FLOAT_VAL(fmod(NUM_AS_DOUBLE(l), NUM_AS_DOUBLE(r)));
+                return BINOP_OK;
+            }
+            return BINOP_TYPE_ERROR;
+        case TOK_ONAJI_KANA: *out = BOOL_VAL(value_equal(l, r)); return BINOP_OK;
+        case TOK_CHIGAU_KANA: *out = BOOL_VAL(!value_equal(l, r)); return BINOP_OK;
+        case TOK_YORI_UE:
+            if (IS_INT(l) && IS_INT(r)) { *out = BOOL_VAL(AS_INT(l) > AS_INT(r)); return BINOP_OK; }
+            if (IS_NUM(l) && IS_NUM(r)) { *out = BOOL_VAL(NUM_AS_DOUBLE(l) > NUM_AS_DOUBLE(r)); return BINOP_OK; }
+            return BINOP_TYPE_ERROR;
+        case TOK_YORI_SHITA:
+            if (IS_INT(l) && IS_INT(r)) { *out = BOOL_VAL(AS_INT(l) < AS_INT(r)); return BINOP_OK; }
+            if (IS_NUM(l) && IS_NUM(r)) { *out = BOOL_VAL(NUM_AS_DOUBLE(l) < NUM_AS_DOUBLE(r)); return BINOP_OK; }
+            return BINOP_TYPE_ERROR;
+        case TOK_IJOU:
+            if (IS_INT(l) && IS_INT(r)) { *out = BOOL_VAL(AS_INT(l) >= AS_INT(r)); return BINOP_OK; }
+            if (IS_NUM(l) && IS_NUM(r)) { *out = BOOL_VAL(NUM_AS_DOUBLE(l) >= NUM_AS_DOUBLE(r)); return BINOP_OK; }
+            return BINOP_TYPE_ERROR;
+        case TOK_IKA:
+            if (IS_INT(l) && IS_INT(r)) { *out = BOOL_VAL(AS_INT(l) <= AS_INT(r)); return BINOP_OK; }
+            if (IS_NUM(l) && IS_NUM(r)) { *out = BOOL_VAL(NUM_AS_DOUBLE(l) <= NUM_AS_DOUBLE(r)); return BINOP_OK; }
+            return BINOP_TYPE_ERROR;
+        default:
+            return BINOP_TYPE_ERROR;
+    }
+}
+
+#undef NUM_AS_DOUBLE
+#undef IS_NUM
+
+
 static Obj* allocate_obj(size_t size, ObjType type) {
-    Obj* object = (Obj*)malloc(size); 
+    Obj* object = (Obj*)gc_allocate(size); 
     object->type = type;
     object->is_marked = false;
-    
-    
-    extern void gc_register_new_object(Obj* obj);
+    object->is_old = false;
+    object->is_remembered = false;
     gc_register_new_object(object);
-    
     return object;
 }
 
+static ObjString** intern_entries = NULL;
+static int intern_count = 0;
+static int intern_capacity = 0;
+static ObjString intern_tombstone;
+
+#define INTERN_TOMBSTONE (&intern_tombstone)
+
+static ObjString* intern_find(const char* chars, int length, uint32_t hash) {
+    if (intern_capacity == 0) return NULL;
+    uint32_t index = hash & (intern_capacity - 1);
+    for (;;) {
+        ObjString* entry = intern_entries[index];
+        if (entry == NULL) return NULL;
+        if (entry != INTERN_TOMBSTONE && entry->hash == hash && entry->length == length &&
+            memcmp(entry->chars, chars, length) == 0) {
+            return entry;
+        }
+        index = (index + 1) & (intern_capacity - 1);
+    }
+}
+
+static bool intern_insert_entry(ObjString** entries, int capacity, ObjString* string) {
+    uint32_t index = string->hash & (capacity - 1);
+    while (entries[index] != NULL && entries[index] != INTERN_TOMBSTONE) {
+        index = (index + 1) & (capacity - 1);
+    }
+    bool is_new_slot = entries[index] == NULL;
+    entries[index] = string;
+    return is_new_slot;
+}
+
+static void intern_add(ObjString* string) {
+    if ((intern_count + 1) * 4 > intern_capacity * 3) {
+        int capacity = intern_capacity < 64 ? 64 : intern_capacity * 2;
+        ObjString** entries = calloc(capacity, sizeof(ObjString*));
+        intern_count = 0;
+        for (int i = 0; i < intern_capacity; i++) {
+            ObjString* entry = intern_entries[i];
+            if (entry == NULL || entry == INTERN_TOMBSTONE) continue;
+            intern_insert_entry(entries, capacity, entry);
+            intern_count++;
+        }
+        free(intern_entries);
+        intern_entries = entries;
+        intern_capacity = capacity;
+    }
+    if (intern_insert_entry(intern_entries, intern_capacity, string)) intern_count++;
+}
+
+void intern_reset(void) {
+    free(intern_entries);
+    intern_entries = NULL;
+    intern_count = 0;
+    intern_capacity = 0;
+}
+
+void intern_remove_unmarked(void) {
+    for (int i = 0; i < intern_capacity; i++) {
+        ObjString* entry = intern_entries[i];
+        if (entry != NULL && entry != INTERN_TOMBSTONE && !entry->obj.is_marked) {
+            intern_entries[i] = INTERN_TOMBSTONE;
+        }
+    }
+}
+
+void intern_remove(ObjString* string) {
+    if (intern_capacity == 0) return;
+    uint32_t index = string->hash & (intern_capacity - 1);
+    for (;;) {
+        ObjString* entry = intern_entries[index];
+        if (entry == NULL) return;
+        if (entry == string) {
+            intern_entries[index] = INTERN_TOMBSTONE;
+            return;
+        }
+        index = (index + 1) & (intern_capacity - 1);
+    }
+}
+
+static ObjString* allocate_string(char* chars, int length, uint32_t hash) {
+    ObjString* string = (ObjString*)allocate_obj(sizeof(ObjString), OBJ_STRING);
+    string->chars = chars;
+    string->length = length;
+    string->hash = hash;
+    string->left = NULL;
+    string->right = NULL;
+    intern_add(string);
+    return string;
+}
+
 ObjString* copy_string_value(const char* chars, int length) {
-    char* heapChars = malloc(length + 1);
+    uint32_t hash = hash_string(chars, length);
+    ObjString* interned = intern_find(chars, length, hash);
+    if (interned != NULL) return interned;
+
+    char* heapChars = pool_alloc(length + 1);
     memcpy(heapChars, chars, length);
     heapChars[length] = '\0';
-    
-    ObjString* hashStr = (ObjString*)allocate_obj(sizeof(ObjString), OBJ_STRING);
-    hashStr->chars = heapChars;
-    hashStr->length = length;
-    hashStr->hash = hash_string(chars, length);
-    return hashStr;
+    return allocate_string(heapChars, length, hash);
+}
+
+ObjString* take_string_value(char* chars, int length) {
+    uint32_t hash = hash_string(chars, length);
+    ObjString* interned = intern_find(chars, length, hash);
+    if (interned != NULL) {
+        pool_free(chars, length + 1);
+        return interned;
+    }
+    return allocate_string(chars, length, hash);
+}
+
+bool string_equal(ObjString* a, ObjString* b) {
+    if (a == b) return true;
+    if (a->length != b->length) return false;
+    a = string_flatten(a);
+    b = string_flatten(b);
+    return a->hash == b->hash && memcmp(a->chars, b->chars, a->length) == 0;
+}
+
+
+#define ROPE_MIN_LENGTH 256
+#define ROPE_LEAF_LENGTH 64
+
+static ObjString** rope_stack = NULL;
+static int rope_stack_capacity = 0;
+
+ObjString* rope_flatten(ObjString* rope) {
+    char* chars = pool_alloc(rope->length + 1);
+    int offset = rope->length;
+    int top = 0;
+    if (rope_stack_capacity == 0) {
+        rope_stack_capacity = 64;
+        rope_stack = malloc(sizeof(ObjString*) * rope_stack_capacity);
+    }
+    rope_stack[top++] = rope;
+    while (top > 0) {
+        ObjString* node = rope_stack[--top];
+        if (node->chars != NULL) {
+            offset -= node->length;
+            memcpy(chars + offset, node->chars, node->length);
+            continue;
+        }
+        if (top + 2 > rope_stack_capacity) {
+            rope_stack_capacity *= 2;
+            rope_stack = realloc(rope_stack, sizeof(ObjString*) * rope_stack_capacity);
+        }
+        rope_stack[top++] = node->left;
+        rope_stack[top++] = node->right;
+    }
+    chars[rope->length] = '\0';
+    rope->chars = chars;
+    rope->hash = hash_string(chars, rope->length);
+    rope->left = NULL;
+    rope->right = NULL;
+    return rope;
+}
+
+static ObjString* new_leaf(const char* a, int a_length, const char* b, int b_length) {
+    char* chars = pool_alloc(a_length + b_length + 1);
+    memcpy(chars, a, a_length);
+    memcpy(chars + a_length, b, b_length);
+    chars[a_length + b_length] = '\0';
+    ObjString* leaf = (ObjString*)allocate_obj(sizeof(ObjString), OBJ_STRING);
+    leaf->chars = chars;
+    leaf->length = a_length + b_length;
+    leaf->hash = hash_string(chars, leaf->length);
+    leaf->left = NULL;
+    leaf->right = NULL;
+    return leaf;
+}
+
+static ObjString* new_rope(ObjString* left, ObjString* right) {
+    ObjString* rope = (ObjString*)allocate_obj(sizeof(ObjString), OBJ_STRING);
+    rope->chars = NULL;
+    rope->length = left->length + right->length;
+    rope->hash = 0;
+    rope->left = left;
+    rope->right = right;
+    return rope;
+}
+
+static ObjString* concat_piece(Value v) {
+    char buf[64];
+    if (IS_OBJ(v) && AS_OBJ(v)->type == OBJ_STRING) return (ObjString*)AS_OBJ(v);
+    const char* chars = value_concat_operand(v, buf, sizeof(buf));
+    return copy_string_value(chars, (int)strlen(chars));
+}
+
+static ObjString* string_concat(Value l, Value r) {
+    GcRootMark roots = gc_root_mark();
+    ObjString* left = concat_piece(l);
+    gc_push_root(OBJ_VAL(left));
+    ObjString* right = concat_piece(r);
+    gc_push_root(OBJ_VAL(right));
+
+    ObjString* result;
+    int length = left->length + right->length;
+    if (length < ROPE_MIN_LENGTH) {
+        left = string_flatten(left);
+        right = string_flatten(right);
+        char* chars = pool_alloc(length + 1);
+        memcpy(chars, left->chars, left->length);
+        memcpy(chars + left->length, right->chars, right->length);
+        chars[length] = '\0';
+        result = take_string_value(chars, length);
+    } else if (left->chars == NULL && left->right->chars != NULL && right->chars != NULL
+               && left->right->length + right->length <= ROPE_LEAF_LENGTH) {
+        ObjString* leaf = new_leaf(left->right->chars, left->right->length, right->chars, right->length);
+        gc_push_root(OBJ_VAL(leaf));
+        result = new_rope(left->left, leaf);
+    } else {
+        result = new_rope(left, right);
+    }
+    gc_root_reset(roots);
+    return result;
 }
 
 ObjList* new_list(void) {
     ObjList* list = (ObjList*)allocate_obj(sizeof(ObjList), OBJ_LIST);
     list->count = 0;
     list->capacity = 0;
+    list->head = 0;
     list->items = NULL;
+    list->cards = (CardTable){NULL, 0, -1};
     return list;
 }
 
+void list_ensure_capacity(ObjList* list, int capacity) {
+    if (capacity <= list->capacity) return;
+    int total = list->head + list->capacity;
+    if (list->head > 0 && capacity <= total && list->count <= list->head) {
+        Value* base = list->items - list->head;
+        memmove(base, list->items, sizeof(Value) * list->count);
+        list->items = base;
+        list->capacity = total;
+        list->head = 0;
+        return;
+    }
+    int new_capacity = list->capacity < 8 ? 8 : list->capacity * 2;
+    while (new_capacity < capacity) new_capacity *= 2;
+    if (list->head == 0) {
+        list->items = pool_realloc(list->items, sizeof(Value) * list->capacity, sizeof(Value) * new_capacity);
+    } else {
+        Value* items = pool_alloc(sizeof(Value) * new_capacity);
+        memcpy(items, list->items, sizeof(Value) * list->count);
+        pool_free(list->items - list->head, sizeof(Value) * total);
+        list->items = items;
+        list->head = 0;
+    }
+    list->capacity = new_capacity;
+}
+
+static void list_drop_front(ObjList* list) {
+    list->items++;
+    list->head++;
+    list->capacity--;
+    list->count--;
+    if (list->count == 0) {
+        list->items -= list->head;
+        list->capacity += list->head;
+        list->head = 0;
+    }
+    gc_list_moved_items(list);
+}
+
+void list_prepend(ObjList* list, Value value) {
+    if (list->head == 0) {
+        int slack = list->count < 8 ? 8 : list->count;
+        Value* base = pool_alloc(sizeof(Value) * (slack + list->capacity));
+        if (list->count > 0) memcpy(base + slack, list->items, sizeof(Value) * list->count);
+        pool_free(list->items, sizeof(Value) * list->capacity);
+        list->items = base + slack;
+        list->head = slack;
+    }
+    list->items--;
+    list->head--;
+    list->capacity++;
+    list->items[0] = value;
+    list->count++;
+    gc_list_moved_items(list);
+    gc_list_write_barrier(list, 0, value);
+}
+
+Value list_shift(ObjList* list) {
+    Value first = list->items[0];
+    list_drop_front(list);
+    return first;
+}
+
+Value list_remove(ObjList* list, int index) {
+    Value removed = list->items[index];
+    if (index < list->count / 2) {
+        memmove(list->items + 1, list->items, sizeof(Value) * index);
+        list_drop_front(list);
+    } else {
+        memmove(list->items + index, list->items + index + 1, sizeof(Value) * (list->count - index - 1));
+        list->count--;
+        gc_list_moved_items(list);
+    }
+    return removed;
+}
+
+ObjTypedArray* new_typed_array(TypedKind kind, int count) {
+    ObjTypedArray* array = (ObjTypedArray*)allocate_obj(sizeof(ObjTypedArray), OBJ_TYPED_ARRAY);
+    array->kind = kind;
+    array->count = count;
+    array->as.ints = NULL;
+    if (count > 0) {
+        array->as.ints = pool_alloc(sizeof(int64_t) * count);
+        memset(array->as.ints, 0, sizeof(int64_t) * count);
+    }
+    return array;
+}
+
 ObjDict* new_dict(void) {
     ObjDict* dict = (ObjDict*)allocate_obj(sizeof(ObjDict), OBJ_DICT);
-    dict->items = table_create();
+    value_table_init(&dict->items);
+    dict->cards = (CardTable){NULL, 0, -1};
     return dict;
 }
 
-ObjFunc* new_function(char* name, int param_count, char** params, AstNode* body) {
+ObjFunc* new_function(AstNode* decl) {
+    ObjFunc* func = (ObjFunc*)allocate_obj(sizeof(ObjFunc), OBJ_FUNC);
+    func->name = decl->as.func_decl.name;
+    func->param_count = decl->as.func_decl.param_count;
+    func->params = decl->as.func_decl.params;
+    func->frame_names = decl->as.func_decl.frame_names;
+    func->frame_captured = decl->as.func_decl.captured;
+    func->body = decl->as.func_decl.body;
+    func->arena = decl->as.func_decl.arena;
+    arena_retain(func->arena);
+    func->closure = NULL;
+    func->chunk = NULL;
+    func->upvalue_count = 0;
+    return func;
+}
+
+ObjFunc* new_compiled_function(const char* name, int arity) {
     ObjFunc* func = (ObjFunc*)allocate_obj(sizeof(ObjFunc), OBJ_FUNC);
     func->name = name ? strdup(name) : NULL;
-    func->param_count = param_count;
-    
-    
-    func->params = malloc(sizeof(char*) * param_count);
-    for(int i=0; i<param_count; i++) func->params[i] = strdup(params[i]);
-    func->body = body; 
+    func->param_count = arity;
+    func->params = NULL;
+    func->frame_names = NULL;
+    func->frame_captured = true;
+    func->body = NULL;
+    func->arena = NULL;
     func->closure = NULL;
+    func->chunk = chunk_new();
+    func->upvalue_count = 0;
     return func;
 }
 
+ObjClosure* new_closure(ObjFunc* function) {
+    ObjUpvalue** upvalues = NULL;
+    if (function->upvalue_count > 0) {
+        upvalues = malloc(sizeof(ObjUpvalue*) * function->upvalue_count);
+        for (int i = 0; i < function->upvalue_count; i++) upvalues[i] = NULL;
+    }
+    ObjClosure* closure = (ObjClosure*)allocate_obj(sizeof(ObjClosure), OBJ_CLOSURE);
+    closure->function = function;
+    closure->upvalues = upvalues;
+    closure->upvalue_count = function->upvalue_count;
+    return closure;
+}
+
+ObjUpvalue* new_upvalue(Value* slot) {
+    ObjUpvalue* upvalue = (ObjUpvalue*)allocate_obj(sizeof(ObjUpvalue), OBJ_UPVALUE);
+    upvalue->location = slot;
+    upvalue->closed = NULL_VAL;
+    upvalue->next = NULL;
+    return upvalue;
+}
+
 ObjClass* new_class(char* name) {
     ObjClass* klass = (ObjClass*)allocate_obj(sizeof(ObjClass), OBJ_CLASS);
     klass->name = strdup(name);
     klass->constructor = NULL;
-    klass->methods = table_create();
+    value_table_init(&klass->methods);
+    klass->root_shape = shape_new_root();
     return klass;
 }
 
 ObjInstance* new_instance(ObjClass* klass) {
     ObjInstance* instance = (ObjInstance*)allocate_obj(sizeof(ObjInstance), OBJ_INSTANCE);
     instance->klass = klass;
-    instance->fields = table_create();
+    instance->shape = klass->root_shape;
+    instance->fields = NULL;
+    instance->field_capacity = 0;
     return instance;
 }
 
@@ -166,3 +629,9 @@ ObjNative* new_native(NativeFn function) {
     native->function = function;
     return native;
 }
+
+ObjInt* new_boxed_int(long long value) {
+    ObjInt* boxed = (ObjInt*)allocate_obj(sizeof(ObjInt), OBJ_INT);
+    boxed->value = value;
+    return boxed;
+}
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "ast.h" 
 
 
@@ -13,7 +14,11 @@ typedef struct ObjDict ObjDict;
 typedef struct ObjFunc ObjFunc;
 typedef struct ObjClass ObjClass;
 typedef struct ObjInstance ObjInstance;
+typedef struct ObjClosure ObjClosure;
+typedef struct ObjUpvalue ObjUpvalue;
+typedef struct ObjTypedArray ObjTypedArray;
 typedef struct HashTable HashTable; 
+typedef struct Chunk Chunk;
 
 typedef enum {
     VAL_NULL,
@@ -23,6 +28,12 @@ typedef enum {
     VAL_OBJ
 } ValueType;
 
+#ifdef NAN_BOXING
+
+typedef uint64_t Value;
+
+#else
+
 typedef struct {
     ValueType type;
     union {
@@ -33,6 +44,30 @@ typedef struct {
     } as;
 } Value;
 
+#endif
+
+typedef struct {
+    ObjString* key;
+    Value value;
+} ValueEntry;
+
+typedef struct {
+    int count;
+    int used;
+    int capacity;
+    ValueEntry* entries;
+    int* index;
+    int index_capacity;
+    int layout;
+    unsigned int version;
+} ValueTable;
+
+typedef struct {
+    uint8_t* marks;
+    int count;
+    int span;
+} CardTable;
+
 typedef enum {
     OBJ_STRING,
     OBJ_LIST,
@@ -40,12 +75,18 @@ typedef enum {
     OBJ_FUNC,
     OBJ_CLASS,
     OBJ_INSTANCE,
-    OBJ_NATIVE
+    OBJ_NATIVE,
+    OBJ_CLOSURE,
+    OBJ_UPVALUE,
+    OBJ_INT,
+    OBJ_TYPED_ARRAY
 } ObjType;
 
 struct Obj {
     ObjType type;
     bool is_marked; 
+    bool is_old;
+    bool is_remembered;
     struct Obj* next; 
 };
 
@@ -54,20 +95,38 @@ struct ObjString {
     char* chars;
     int length;
     uint32_t hash;
+    ObjString* left;
+    ObjString* right;
 };
 
 struct ObjList {
     Obj obj;
     int count;
     int capacity;
+    int head;
     Value* items;
+    CardTable cards;
+};
+
+typedef enum {
+    TYPED_INT64,
+    TYPED_FLOAT64
+} TypedKind;
+
+struct ObjTypedArray {
+    Obj obj;
+    TypedKind kind;
+    int count;
+    union {
+        int64_t* ints;
+        double* floats;
+    } as;
 };
 
 struct ObjDict {
     Obj obj;
-    struct HashTable* items; 
-    
-    
+    ValueTable items; 
+    CardTable cards;
 };
 
 struct ObjFunc {
@@ -75,21 +134,43 @@ struct ObjFunc {
     char* name;
     int param_count;
     char** params;
+    char** frame_names;
+    bool frame_captured;
     AstNode* body;
+    Arena* arena;
     struct Environment* closure; 
+    Chunk* chunk;
+    int upvalue_count;
+};
+
+struct ObjUpvalue {
+    Obj obj;
+    Value* location;
+    Value closed;
+    struct ObjUpvalue* next;
+};
+
+struct ObjClosure {
+    Obj obj;
+    ObjFunc* function;
+    ObjUpvalue** upvalues;
+    int upvalue_count;
 };
 
 struct ObjClass {
     Obj obj;
     char* name;
-    ObjFunc* constructor;
-    struct HashTable* methods; 
+    Obj* constructor;
+    ValueTable methods; 
+    struct Shape* root_shape;
 };
 
 struct ObjInstance {
     Obj obj;
     ObjClass* klass;
-    struct HashTable* fields; 
+    struct Shape* shape;
+    Value* fields;
+    int field_capacity;
 };
 
 typedef Value (*NativeFn)(int argCount, Value* args);
@@ -98,6 +179,88 @@ typedef struct {
     NativeFn function;
 } ObjNative;
 
+typedef struct {
+    Obj obj;
+    long long value;
+} ObjInt;
+
+ObjInt* new_boxed_int(long long value);
+
+#ifdef NAN_BOXING
+
+#define SIGN_BIT ((uint64_t)0x8000000000000000)
+#define QNAN ((uint64_t)0x7ffc000000000000)
+#define PAYLOAD_MASK (((uint64_t)1 << 48) - 1)
+#define TAG_MASK (SIGN_BIT | QNAN | ((uint64_t)3 << 48))
+#define TAG_OBJ (SIGN_BIT | QNAN)
+#define TAG_BOXED_INT (SIGN_BIT | QNAN | ((uint64_t)1 << 48))
+#define TAG_SMALL_INT (SIGN_BIT | QNAN | ((uint64_t)2 << 48))
+#define TAG_NULL 1
+#define TAG_FALSE 2
+#define TAG_TRUE 3
+
+#define SMALL_INT_MAX (((long long)1 << 47) - 1)
+#define SMALL_INT_MIN (-((long long)1 << 47))
+
+#define NULL_VAL ((Value)(QNAN | TAG_NULL))
+#define FALSE_VAL ((Value)(QNAN | TAG_FALSE))
+#define TRUE_VAL ((Value)(QNAN | TAG_TRUE))
+
+#define IS_NULL(v) ((v) == NULL_VAL)
+#define IS_BOOL(v) (((v) | 1) == TRUE_VAL)
+#define IS_SMALL_INT(v) (((v) & TAG_MASK) == TAG_SMALL_INT)
+#define IS_BOXED_INT(v) (((v) & TAG_MASK) == TAG_BOXED_INT)
+#define IS_INT(v) (IS_SMALL_INT(v) || IS_BOXED_INT(v))
+#define IS_FLOAT(v) (((v) & QNAN) != QNAN)
+#define IS_OBJ(v) (((v) & TAG_MASK) == TAG_OBJ)
+
+#define AS_BOOL(v) ((v) == TRUE_VAL)
+#define AS_INT(v) value_as_int(v)
+#define AS_FLOAT(v) value_as_float(v)
+#define AS_OBJ(v) ((Obj*)(uintptr_t)((v) & PAYLOAD_MASK))
+#define AS_BOXED_INT(v) ((ObjInt*)(uintptr_t)((v) & PAYLOAD_MASK))
+
+#define BOOL_VAL(value) ((value) ? TRUE_VAL : FALSE_VAL)
+#define INT_VAL(value) value_from_int(value)
+#define FLOAT_VAL(value) value_from_float(value)
+#define OBJ_VAL(object) ((Value)(TAG_OBJ | (uint64_t)(uintptr_t)(object)))
+
+#define VALUE_TYPE(v) value_type_of(v)
+
+static inline long long value_as_int(Value value) {
+    if (IS_SMALL_INT(value)) return (long long)((int64_t)(value << 16) >> 16);
+    return AS_BOXED_INT(value)->value;
+}
+
+static inline Value value_from_int(long long value) {
+    if (value >= SMALL_INT_MIN && value <= SMALL_INT_MAX) {
+        return TAG_SMALL_INT | ((uint64_t)value & PAYLOAD_MASK);
+    }
+    return TAG_BOXED_INT | (uint64_t)(uintptr_t)new_boxed_int(value);
+}
+
+static inline double value_as_float(Value value) {
+    double number;
+    memcpy(&number, &value, sizeof(double));
+    return number;
+}
+
+static inline Value value_from_float(double number) {
+    Value value;
+    if (number != number) return (Value)0x7ff8000000000000;
+    memcpy(&value, &number, sizeof(double));
+    return value;
+}
+
+static inline ValueType value_type_of(Value value) {
+    if (IS_FLOAT(value)) return VAL_FLOAT;
+    if (IS_OBJ(value)) return VAL_OBJ;
+    if (IS_INT(value)) return VAL_INT;
+    if (IS_NULL(value)) return VAL_NULL;
+    return VAL_BOOL;
+}
+
+#else
 
 #define IS_NULL(v) ((v).type == VAL_NULL)
 #define IS_BOOL(v) ((v).type == VAL_BOOL)
@@ -116,18 +279,53 @@ typedef struct {
 #define FLOAT_VAL(value) ((Value){VAL_FLOAT, {.number = value}})
 #define OBJ_VAL(object) ((Value){VAL_OBJ, {.obj = (Obj*)object}})
 
+#define VALUE_TYPE(v) ((v).type)
+
+#endif
+
+#define IS_TRUTHY(v) (!IS_NULL(v) && (!IS_BOOL(v) || AS_BOOL(v)))
+
+ObjString* rope_flatten(ObjString* rope);
+
+static inline ObjString* string_flatten(ObjString* string) {
+    return string->chars != NULL ? string : rope_flatten(string);
+}
+
+#define AS_STRING(v) string_flatten((ObjString*)AS_OBJ(v))
+
+typedef enum {
+    BINOP_OK,
+    BINOP_TYPE_ERROR,
+    BINOP_ZERO_DIV
+} BinaryOpStatus;
+
 
 void value_print(Value value);
 bool value_equal(Value a, Value b);
 const char* value_type_name(Value value);
+BinaryOpStatus value_binary_op(TokenType op, Value l, Value r, Value* out);
+const char* value_concat_operand(Value v, char* buf, size_t size);
 
 
 ObjString* copy_string_value(const char* chars, int length);
+ObjString* take_string_value(char* chars, int length);
+bool string_equal(ObjString* a, ObjString* b);
+void intern_reset(void);
+void intern_remove_unmarked(void);
+void intern_remove(ObjString* string);
 ObjList* new_list(void);
+void list_ensure_capacity(ObjList* list, int capacity);
+void list_prepend(ObjList* list, Value value);
+Value list_shift(ObjList* list);
+Value list_remove(ObjList* list, int index);
 ObjDict* new_dict(void);
-ObjFunc* new_function(char* name, int param_count, char** params, AstNode* body);
+ObjTypedArray* new_typed_array(TypedKind kind, int count);
+ObjFunc* new_function(AstNode* decl);
 ObjClass* new_class(char* name);
 ObjInstance* new_instance(ObjClass* klass);
 ObjNative* new_native(NativeFn function);
+ObjFunc* new_compiled_function(const char* name, int arity);
+ObjClosure* new_closure(ObjFunc* function);
+ObjUpvalue* new_upvalue(Value* slot);
 
 #endif 
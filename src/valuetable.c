@@ -0,0 +1,159 @@
+#include "valuetable.h"
+#include "pool.h"
+#include <stdlib.h>
+
+#define INDEX_EMPTY -1
+#define INDEX_DELETED -2
+#define MIN_INDEX_CAPACITY 8
+
+
+void value_table_init(ValueTable* table) {
+    table->count = 0;
+    table->used = 0;
+    table->capacity = 0;
+    table->entries = NULL;
+    table->index = NULL;
+    table->index_capacity = 0;
+    table->layout = 0;
+    table->version = 0;
+}
+
+void value_table_free(ValueTable* table) {
+    pool_free(table->entries, sizeof(ValueEntry) * table->capacity);
+    pool_free(table->index, sizeof(int) * table->index_capacity);
+    value_table_init(table);
+}
+
+static bool key_matches(ObjString* entry_key, ObjString* key) {
+    return entry_key == key || (entry_key->hash == key->hash && string_equal(entry_key, key));
+}
+
+static int find_slot(ValueTable* table, ObjString* key, bool* found) {
+    uint32_t mask = (uint32_t)table->index_capacity - 1;
+    uint32_t slot = key->hash & mask;
+    int tombstone = -1;
+
+    for (;;) {
+        int entry = table->index[slot];
+        if (entry == INDEX_EMPTY) {
+            *found = false;
+            return tombstone >= 0 ? tombstone : (int)slot;
+        }
+        if (entry == INDEX_DELETED) {
+            if (tombstone < 0) tombstone = (int)slot;
+        } else if (key_matches(table->entries[entry].key, key)) {
+            *found = true;
+            return (int)slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+static void resize(ValueTable* table) {
+    int capacity = table->count + table->count / 2 + 1;
+    if (capacity < MIN_INDEX_CAPACITY * 3 / 4) capacity = MIN_INDEX_CAPACITY * 3 / 4;
+    int index_capacity = MIN_INDEX_CAPACITY;
+    while (index_capacity * 3 / 4 < capacity) index_capacity *= 2;
+
+    ValueEntry* entries = pool_alloc(sizeof(ValueEntry) * capacity);
+    int* index = pool_alloc(sizeof(int) * index_capacity);
+    for (int i = 0; i < index_capacity; i++) index[i] = INDEX_EMPTY;
+
+    int used = 0;
+    uint32_t mask = (uint32_t)index_capacity - 1;
+    for (int i = 0; i < table->used; i++) {
+        ValueEntry* entry = &table->entries[i];
+        if (entry->key == NULL) continue;
+        uint32_t slot = entry->key->hash & mask;
+        while (index[slot] != INDEX_EMPTY) slot = (slot + 1) & mask;
+        index[slot] = used;
+        entries[used++] = *entry;
+    }
+
+    pool_free(table->entries, sizeof(ValueEntry) * table->capacity);
+    pool_free(table->index, sizeof(int) * table->index_capacity);
+    table->entries = entries;
+    table->index = index;
+    table->capacity = capacity;
+    table->index_capacity = index_capacity;
+    table->used = used;
+    table->layout++;
+    table->version++;
+}
+
+bool value_table_set(ValueTable* table, ObjString* key, Value value) {
+    key = string_flatten(key);
+    bool found = false;
+    int slot = table->index_capacity > 0 ? find_slot(table, key, &found) : 0;
+    if (found) {
+        table->entries[table->index[slot]].value = value;
+        return false;
+    }
+    if (table->used == table->capacity) {
+        resize(table);
+        slot = find_slot(table, key, &found);
+    }
+
+    ValueEntry* entry = &table->entries[table->used];
+    entry->key = key;
+    entry->value = value;
+    table->index[slot] = table->used++;
+    table->count++;
+    table->version++;
+    return true;
+}
+
+bool value_table_get(ValueTable* table, ObjString* key, Value* out_value) {
+    if (table->count == 0) return false;
+
+    bool found;
+    int slot = find_slot(table, string_flatten(key), &found);
+    if (!found) return false;
+
+    *out_value = table->entries[table->index[slot]].value;
+    return true;
+}
+
+bool value_table_delete(ValueTable* table, ObjString* key) {
+    if (table->count == 0) return false;
+
+    bool found;
+    int slot = find_slot(table, string_flatten(key), &found);
+    if (!found) return false;
+
+    ValueEntry* entry = &table->entries[table->index[slot]];
+    entry->key = NULL;
+    entry->value = NULL_VAL;
+    table->index[slot] = INDEX_DELETED;
+    table->count--;
+    table->version++;
+    return true;
+}
+
+int value_table_index(ValueTable* table, ObjString* key) {
+    if (table->count == 0) return -1;
+    bool found;
+    int slot = find_slot(table, string_flatten(key), &found);
+    return found ? table->index[slot] : -1;
+}
+
+void value_table_iterate(ValueTable* table, ValueTableIterateFn callback, void* userdata) {
+    for (int i = 0; i < table->used; i++) {
+        if (table->entries[i].key != NULL) {
+            callback(table->entries[i].key, table->entries[i].value, userdata);
+        }
+    }
+}
+
+bool value_table_next(ValueTable* table, int* cursor, ObjString** key, Value* value) {
+    for (int i = *cursor; i < table->used; i++) {
+        if (table->entries[i].key != NULL) {
+            *key = table->entries[i].key;
+            *value = table->entries[i].value;
+            *cursor = i + 1;
+            return true;
+        }
+    }
+    *cursor = table->used;
+    return false;
+}
@@ -0,0 +1,31 @@
+#ifndef OJISAN_VALUETABLE_H
+#define OJISAN_VALUETABLE_H
+
+#include "value.h"
+
+
+void value_table_init(ValueTable* table);
+
+
+void value_table_free(ValueTable* table);
+
+
+bool value_table_set(ValueTable* table, ObjString* key, Value value);
+
+
+bool value_table_get(ValueTable* table, ObjString* key, Value* out_value);
+
+
+bool value_table_delete(ValueTable* table, ObjString* key);
+
+
+int value_table_index(ValueTable* table, ObjString* key);
+
+
+typedef void (*ValueTableIterateFn)(ObjString* key, Value value, void* userdata);
+void value_table_iterate(ValueTable* table, ValueTableIterateFn callback, void* userdata);
+
+
+bool value_table_next(ValueTable* table, int* cursor, ObjString** key, Value* value);
+
+#endif 
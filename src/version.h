@@ -0,0 +1,6 @@
+#ifndef OJISAN_VERSION_H
+#define OJISAN_VERSION_H
+
+#define OJISAN_VERSION "1.0.0"
+
+#endif
@@ -0,0 +1,911 @@
+#include "vm.h"
+#include "chunk.h"
+#include "compiler.h"
+#include "builtins.h"
+#include "error.h"
+#include "gc.h"
+#include "parser.h"
+#include "source.h"
+#include "modcache.h"
+#include "module.h"
+#include "valuetable.h"
+#include "typedarray.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define FRAMES_MAX 1001
+#define STACK_MAX (FRAMES_MAX * 256)
+#define STACK_HEADROOM 512
+
+typedef struct {
+    ObjClosure* closure;
+    uint8_t* ip;
+    Value* slots;
+} CallFrame;
+
+typedef struct {
+    int frame_count;
+    Value* stack_top;
+    uint8_t* catch_ip;
+} TryHandler;
+
+typedef struct {
+    CallFrame frames[FRAMES_MAX];
+    int frame_count;
+    Value stack[STACK_MAX];
+    Value* stack_top;
+    ObjUpvalue* open_upvalues;
+    TryHandler* handlers;
+    int handler_count;
+    int handler_capacity;
+    int exit_frame;
+    int handler_floor;
+    ErrorType pending_type;
+    int pending_line;
+    char pending_error[512];
+    Environment* globals;
+    bool dump_bytecode;
+} VM;
+
+typedef enum {
+    CALL_OK,
+    CALL_NOT_FUNCTION,
+    CALL_TOO_DEEP,
+    CALL_NATIVE_FAILED
+} CallStatus;
+
+typedef enum {
+    PROP_OK,
+    PROP_NOT_OBJECT,
+    PROP_NO_MEMBER,
+    PROP_FAIL
+} PropertyStatus;
+
+static VM vm;
+
+static inline void push(Value value) {
+    *vm.stack_top++ = value;
+}
+
+static inline Value pop(void) {
+    return *--vm.stack_top;
+}
+
+static inline Value peek(int distance) {
+    return vm.stack_top[-1 - distance];
+}
+
+static void close_upvalues(Value* last) {
+    while (vm.open_upvalues != NULL && vm.open_upvalues->location >= last) {
+        ObjUpvalue* upvalue = vm.open_upvalues;
+        upvalue->closed = *upvalue->location;
+        gc_write_barrier(&upvalue->obj, upvalue->closed);
+        upvalue->location = &upvalue->closed;
+        vm.open_upvalues = upvalue->next;
+    }
+}
+
+static void reset_stack(void) {
+    close_upvalues(vm.stack);
+    vm.stack_top = vm.stack;
+    vm.frame_count = 0;
+    vm.handler_count = 0;
+    vm.exit_frame = 0;
+    vm.handler_floor = 0;
+}
+
+static ObjUpvalue* capture_upvalue(Value* local) {
+    ObjUpvalue* prev = NULL;
+    ObjUpvalue* upvalue = vm.open_upvalues;
+    while (upvalue != NULL && upvalue->location > local) {
+        prev = upvalue;
+        upvalue = upvalue->next;
+    }
+    if (upvalue != NULL && upvalue->location == local) return upvalue;
+
+    ObjUpvalue* created = new_upvalue(local);
+    created->next = upvalue;
+    if (prev == NULL) {
+        vm.open_upvalues = created;
+    } else {
+        prev->next = created;
+    }
+    return created;
+}
+
+static bool throw_message(ErrorType type, int line, const char* message) {
+    if (vm.handler_count > vm.handler_floor) {
+        TryHandler* handler = &vm.handlers[--vm.handler_count];
+        vm.frame_count = handler->frame_count;
+        close_upvalues(handler->stack_top);
+        vm.stack_top = handler->stack_top;
+        push(OBJ_VAL(copy_string_value(message, strlen(message))));
+        vm.frames[vm.frame_count - 1].ip = handler->catch_ip;
+        return true;
+    }
+
+    if (line < 0) {
+        CallFrame* frame = &vm.frames[vm.frame_count - 1];
+        Chunk* chunk = frame->closure->function->chunk;
+        line = chunk->lines[frame->ip - chunk->code - 1];
+    }
+    if (vm.exit_frame > 0) {
+        vm.pending_type = type;
+        vm.pending_line = line;
+        snprintf(vm.pending_error, sizeof(vm.pending_error), "%s", message);
+        return false;
+    }
+    error_report(type, line, "%s", message);
+    return false;
+}
+
+static bool raise_error(ErrorType type, const char* fmt, ...) {
+    char message[512];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(message, sizeof(message), fmt, args);
+    va_end(args);
+    return throw_message(type, -1, message);
+}
+
+static bool property_error(PropertyStatus status, ObjString* name) {
+    switch (status) {
+        case PROP_NOT_OBJECT: return raise_error(ERR_TYPE, "オブジェクトじゃないヨ😅💦");
+        case PROP_NO_MEMBER: return raise_error(ERR_UNDEFINED, "「%s」なんてメンバ持ってないヨ😅💦", name->chars);
+        default: return false;
+    }
+}
+
+static bool call_error(CallStatus status) {
+    if (status == CALL_NATIVE_FAILED) {
+        char message[sizeof(vm.pending_error)];
+        ErrorType type;
+        if (builtins_take_error(&type, message, sizeof(message))) return throw_message(type, -1, message);
+        if (vm.pending_error[0] == '\0') return false;
+        memcpy(message, vm.pending_error, sizeof(message));
+        return throw_message(vm.pending_type, vm.pending_line, message);
+    }
+    if (status == CALL_TOO_DEEP) {
+        return raise_error(ERR_RUNTIME, "再帰が深すぎるヨ😱💦 スタックオーバーフロー防止で止めたヨ");
+    }
+    return raise_error(ERR_TYPE, "それは関数じゃないヨ😅💦");
+}
+
+static CallStatus call_closure(ObjClosure* closure, int arg_count) {
+    ObjFunc* function = closure->function;
+    if (vm.frame_count == FRAMES_MAX ||
+        vm.stack_top + function->param_count + STACK_HEADROOM > vm.stack + STACK_MAX) {
+        return CALL_TOO_DEEP;
+    }
+    while (arg_count < function->param_count) {
+        push(NULL_VAL);
+        arg_count++;
+    }
+    if (arg_count > function->param_count) {
+        vm.stack_top -= arg_count - function->param_count;
+        arg_count = function->param_count;
+    }
+
+    CallFrame* frame = &vm.frames[vm.frame_count++];
+    frame->closure = closure;
+    frame->ip = function->chunk->code;
+    frame->slots = vm.stack_top - arg_count - 1;
+    return CALL_OK;
+}
+
+static CallStatus call_value(Value callee, int arg_count) {
+    if (IS_OBJ(callee)) {
+        switch (AS_OBJ(callee)->type) {
+            case OBJ_CLOSURE:
+                return call_closure((ObjClosure*)AS_OBJ(callee), arg_count);
+            case OBJ_NATIVE: {
+                NativeFn native = ((ObjNative*)AS_OBJ(callee))->function;
+                Value result = native(arg_count, vm.stack_top - arg_count);
+                vm.stack_top -= arg_count + 1;
+                push(result);
+                return builtins_take_failure() ? CALL_NATIVE_FAILED : CALL_OK;
+            }
+            default:
+                break;
+        }
+    }
+    return CALL_NOT_FUNCTION;
+}
+
+static PropertyStatus get_property(Value object, ObjString* name, InlineCache* cache, Value* out) {
+    if (!IS_OBJ(object)) return PROP_NOT_OBJECT;
+
+    if (AS_OBJ(object)->type == OBJ_INSTANCE) {
+        ObjInstance* inst = (ObjInstance*)AS_OBJ(object);
+        if (inline_cache_get(cache, inst, name, out)) return PROP_OK;
+        return PROP_NO_MEMBER;
+    }
+    if (AS_OBJ(object)->type == OBJ_STRING && strcmp(name->chars, "length") == 0) {
+        *out = INT_VAL(((ObjString*)AS_OBJ(object))->length);
+        return PROP_OK;
+    }
+    return PROP_FAIL;
+}
+
+static void list_append(ObjList* list, Value value) {
+    list_ensure_capacity(list, list->count + 1);
+    gc_list_write_barrier(list, list->count, value);
+    list->items[list->count++] = value;
+}
+
+static long long dict_iter_state(ObjDict* dict, DictView view) {
+    return ((long long)dict->items.version << 2) | view;
+}
+
+static ObjFunc* compile_source(const char* source) {
+    size_t length = strlen(source);
+    ObjFunc* function = module_cache_load(source, length);
+    if (function) return function;
+
+    AstNode* program = parse_program(source);
+    bool cacheable = !parser_had_error();
+    function = program ? compile_program(program) : NULL;
+    ast_free(program);
+    if (function && cacheable) module_cache_store(source, length, function);
+    return function;
+}
+
+static InterpretResult run(void) {
+    CallFrame* frame = &vm.frames[vm.frame_count - 1];
+    uint8_t* ip = frame->ip;
+
+#define READ_BYTE() (*ip++)
+#define READ_SHORT() (ip += 2, (uint16_t)((ip[-2] << 8) | ip[-1]))
+#define READ_CONSTANT() (frame->closure->function->chunk->constants[READ_SHORT()])
+#define READ_STRING() ((ObjString*)AS_OBJ(READ_CONSTANT()))
+#define READ_CACHE() (&frame->closure->function->chunk->caches[READ_SHORT()])
+#define RELOAD_FRAME() do { frame = &vm.frames[vm.frame_count - 1]; ip = frame->ip; } while (0)
+#define THROW(raised) \
+    do { \
+        frame->ip = ip; \
+        if (!(raised)) return INTERPRET_RUNTIME_ERROR; \
+        RELOAD_FRAME(); \
+        goto dispatch; \
+    } while (0)
+#define RAISE(type, ...) THROW(raise_error(type, __VA_ARGS__))
+#define BINARY_SLOW(op) \
+    do { \
+        Value out_; \
+        BinaryOpStatus st_ = value_binary_op(op, peek(1), peek(0), &out_); \
+        if (st_ == BINOP_ZERO_DIV) RAISE(ERR_ZERO_DIV, "0で割っちゃダメだヨ😱💦"); \
+        if (st_ != BINOP_OK) RAISE(ERR_RUNTIME, "式の評価に失敗したヨ😅💦"); \
+        vm.stack_top--; \
+        vm.stack_top[-1] = out_; \
+    } while (0)
+#define INT_COMPARE(cmp, op) \
+    do { \
+        Value b_ = peek(0), a_ = peek(1); \
+        if (IS_INT(a_) && IS_INT(b_)) { \
+            vm.stack_top--; \
+            vm.stack_top[-1] = BOOL_VAL(AS_INT(a_) cmp AS_INT(b_)); \
+        } else { \
+            BINARY_SLOW(op); \
+        } \
+    } while (0)
+
+    for (;;) {
+dispatch: ;
+        uint8_t instruction = READ_BYTE();
+        switch (instruction) {
+            case OP_CONSTANT: push(READ_CONSTANT()); break;
+            case OP_NULL: push(NULL_VAL); break;
+            case OP_TRUE: push(BOOL_VAL(true)); break;
+            case OP_FALSE: push(BOOL_VAL(false)); break;
+            case OP_POP: vm.stack_top--; break;
+
+            case OP_GET_LOCAL: push(frame->slots[READ_BYTE()]); break;
+            case OP_SET_LOCAL: frame->slots[READ_BYTE()] = peek(0); break;
+            case OP_GET_UPVALUE: push(*frame->closure->upvalues[READ_BYTE()]->location); break;
+            case OP_SET_UPVALUE: {
+                ObjUpvalue* upvalue = frame->closure->upvalues[READ_BYTE()];
+                gc_write_barrier(&upvalue->obj, peek(0));
+                *upvalue->location = peek(0);
+                break;
+            }
+
+            case OP_DEFINE_GLOBAL: {
+                ObjString* name = READ_STRING();
+                env_define(vm.globals, name->chars, peek(0));
+                vm.stack_top--;
+                break;
+            }
+            case OP_GET_GLOBAL: {
+                ObjString* name = READ_STRING();
+                Value value;
+                if (!env_get(vm.globals, name->chars, &value)) {
+                    RAISE(ERR_UNDEFINED, "変数「%s」が見つからないヨ😅💦", name->chars);
+                }
+                push(value);
+                break;
+            }
+            case OP_SET_GLOBAL: {
+                ObjString* name = READ_STRING();
+                if (!env_assign(vm.globals, name->chars, peek(0))) {
+                    RAISE(ERR_UNDEFINED, "変数「%s」が見つからないヨ😅💦", name->chars);
+                }
+                break;
+            }
+
+            case OP_GET_PROPERTY: {
+                ObjString* name = READ_STRING();
+                InlineCache* cache = READ_CACHE();
+                Value result;
+                PropertyStatus status = get_property(peek(0), name, cache, &result);
+                if (status != PROP_OK) THROW(property_error(status, name));
+                vm.stack_top[-1] = result;
+                break;
+            }
+            case OP_SET_PROPERTY: {
+                ObjString* name = READ_STRING();
+                InlineCache* cache = READ_CACHE();
+                Value object = peek(1);
+                if (!IS_OBJ(object) || AS_OBJ(object)->type != OBJ_INSTANCE) {
+                    RAISE(ERR_TYPE, "インスタンスじゃないと代入できないヨ😅💦");
+                }
+                Value value = peek(0);
+                inline_cache_set(cache, (ObjInstance*)AS_OBJ(object), name, value);
+                vm.stack_top -= 2;
+                push(value);
+                break;
+            }
+
+            case OP_GET_INDEX: {
+                Value index = peek(0);
+                Value object = peek(1);
+                if (IS_OBJ(object) && AS_OBJ(object)->type == OBJ_LIST) {
+                    ObjList* list = (ObjList*)AS_OBJ(object);
+                    if (!IS_INT(index)) RAISE(ERR_TYPE, "配列のインデックスは整数じゃないとダメだヨ😅💦");
+                    long long idx = AS_INT(index);
+                    if (idx < 0 || idx >= list->count) {
+                        RAISE(ERR_INDEX_OUT_OF_BOUNDS, "インデックス %lld は範囲外だヨ😅💦", idx);
+                    }
+                    vm.stack_top--;
+                    vm.stack_top[-1] = list->items[idx];
+                    break;
+                }
+                if (IS_OBJ(object) && AS_OBJ(object)->type == OBJ_TYPED_ARRAY) {
+                    ObjTypedArray* array = (ObjTypedArray*)AS_OBJ(object);
+                    if (!IS_INT(index)) RAISE(ERR_TYPE, "配列のインデックスは整数じゃないとダメだヨ😅💦");
+                    long long idx = AS_INT(index);
+                    if (idx < 0 || idx >= array->count) {
+                        RAISE(ERR_INDEX_OUT_OF_BOUNDS, "インデックス %lld は範囲外だヨ😅💦", idx);
+                    }
+                    Value element = typed_array_get(array, (int)idx);
+                    vm.stack_top--;
+                    vm.stack_top[-1] = element;
+                    break;
+                }
+                if (IS_OBJ(object) && AS_OBJ(object)->type == OBJ_DICT) {
+                    ObjDict* dict = (ObjDict*)AS_OBJ(object);
+                    if (!IS_OBJ(index) || AS_OBJ(index)->type != OBJ_STRING) {
+                        RAISE(ERR_TYPE, "辞書のキーは文字列じゃないとダメだヨ😅💦");
+                    }
+                    Value result = NULL_VAL;
+                    value_table_get(&dict->items, (ObjString*)AS_OBJ(index), &result);
+                    vm.stack_top--;
+                    vm.stack_top[-1] = result;
+                    break;
+                }
+                RAISE(ERR_TYPE, "インデックスアクセスできないヨ😅💦");
+            }
+            case OP_SET_INDEX: {
+                Value value = peek(0);
+                Value index = peek(1);
+                Value object = peek(2);
+                if (IS_OBJ(object) && AS_OBJ(object)->type == OBJ_LIST) {
+                    ObjList* list = (ObjList*)AS_OBJ(object);
+                    if (!IS_INT(index)) RAISE(ERR_TYPE, "配列のインデックスは整数じゃないとダメだヨ😅💦");
+                    long long idx = AS_INT(index);
+                    if (idx < 0 || idx >= list->count) {
+                        RAISE(ERR_INDEX_OUT_OF_BOUNDS, "インデックス %lld は範囲外だヨ😅💦", idx);
+                    }
+                    gc_list_write_barrier(list, idx, value);
+                    list->items[idx] = value;
+                } else if (IS_OBJ(object) && AS_OBJ(object)->type == OBJ_TYPED_ARRAY) {
+                    ObjTypedArray* array = (ObjTypedArray*)AS_OBJ(object);
+                    if (!IS_INT(index)) RAISE(ERR_TYPE, "配列のインデックスは整数じゃないとダメだヨ😅💦");
+                    long long idx = AS_INT(index);
+                    if (idx < 0 || idx >= array->count) {
+                        RAISE(ERR_INDEX_OUT_OF_BOUNDS, "インデックス %lld は範囲外だヨ😅💦", idx);
+                    }
+                    if (!typed_array_set(array, (int)idx, value)) {
+                        RAISE(ERR_TYPE, "%s", array->kind == TYPED_INT64 ? "整数配列には整数しか入れられないヨ😅💦" : "小数配列には数字しか入れられないヨ😅💦");
+                    }
+                } else if (IS_OBJ(object) && AS_OBJ(object)->type == OBJ_DICT) {
+                    if (!IS_OBJ(index) || AS_OBJ(index)->type != OBJ_STRING) {
+                        RAISE(ERR_TYPE, "辞書のキーは文字列じゃないとダメだヨ😅💦");
+                    }
+                    ObjDict* dict = (ObjDict*)AS_OBJ(object);
+                    value_table_set(&dict->items, (ObjString*)AS_OBJ(index), value);
+                    gc_dict_write_barrier(dict, (ObjString*)AS_OBJ(index), value);
+                } else {
+                    RAISE(ERR_TYPE, "インデックス代入できないヨ😅💦");
+                }
+                vm.stack_top -= 3;
+                push(value);
+                break;
+            }
+
+            case OP_ADD: {
+                Value b = peek(0), a = peek(1);
+                if (IS_INT(a) && IS_INT(b)) {
+                    long long x = AS_INT(a), y = AS_INT(b);
+                    if (!((y > 0 && x > LLONG_MAX - y) || (y < 0 && x < LLONG_MIN - y))) {
+                        vm.stack_top--;
+                        vm.stack_top[-1] = INT_VAL(x + y);
+                        break;
+                    }
+                }
+                BINARY_SLOW(TOK_TO);
+                break;
+            }
+            case OP_SUBTRACT: {
+                Value b = peek(0), a = peek(1);
+                if (IS_INT(a) && IS_INT(b)) {
+                    vm.stack_top--;
+                    vm.stack_top[-1] = INT_VAL(AS_INT(a) - AS_INT(b));
+                    break;
+                }
+                BINARY_SLOW(TOK_HIKU);
+                break;
+            }
+            case OP_MULTIPLY: BINARY_SLOW(TOK_KAKERU); break;
+            case OP_DIVIDE: BINARY_SLOW(TOK_WARU); break;
+            case OP_MODULO: BINARY_SLOW(TOK_AMARI); break;
+            case OP_EQUAL: {
+                Value b = pop();
+                vm.stack_top[-1] = BOOL_VAL(value_equal(vm.stack_top[-1], b));
+                break;
+            }
+            case OP_NOT_EQUAL: {
+                Value b = pop();
+                vm.stack_top[-1] = BOOL_VAL(!value_equal(vm.stack_top[-1], b));
+                break;
+            }
+            case OP_GREATER: INT_COMPARE(>, TOK_YORI_UE); break;
+            case OP_LESS: INT_COMPARE(<, TOK_YORI_SHITA); break;
+            case OP_GREATER_EQUAL: INT_COMPARE(>=, TOK_IJOU); break;
+            case OP_LESS_EQUAL: INT_COMPARE(<=, TOK_IKA); break;
+            case OP_NEGATE: {
+                Value v = peek(0);
+                if (IS_INT(v)) vm.stack_top[-1] = INT_VAL(-AS_INT(v));
+                else if (IS_FLOAT(v)) vm.stack_top[-1] = FLOAT_VAL(-AS_FLOAT(v));
+                else RAISE(ERR_TYPE, "数値じゃないとマイナスできないヨ😅💦");
+                break;
+            }
+            case OP_NOT: vm.stack_top[-1] = BOOL_VAL(!IS_TRUTHY(vm.stack_top[-1])); break;
+            case OP_TRUTHY: vm.stack_top[-1] = BOOL_VAL(IS_TRUTHY(vm.stack_top[-1])); break;
+
+            case OP_PRINT:
+                value_print(pop());
+                break;
+            case OP_PRINTLN:
+                value_print(pop());
+                printf("\n");
+                break;
+
+            case OP_JUMP: {
+                uint16_t offset = READ_SHORT();
+                ip += offset;
+                break;
+            }
+            case OP_JUMP_IF_FALSE: {
+                uint16_t offset = READ_SHORT();
+                if (!IS_TRUTHY(peek(0))) ip += offset;
+                break;
+            }
+            case OP_LOOP: {
+                uint16_t offset = READ_SHORT();
+                ip -= offset;
+                break;
+            }
+
+            case OP_CALL: {
+                int arg_count = READ_BYTE();
+                frame->ip = ip;
+                CallStatus status = call_value(peek(arg_count), arg_count);
+                if (status != CALL_OK) THROW(call_error(status));
+                RELOAD_FRAME();
+                break;
+            }
+            case OP_INVOKE: {
+                ObjString* name = READ_STRING();
+                int arg_count = READ_BYTE();
+                InlineCache* cache = READ_CACHE();
+                Value receiver = peek(arg_count);
+                Value callee;
+                PropertyStatus prop = get_property(receiver, name, cache, &callee);
+                if (prop != PROP_OK) THROW(property_error(prop, name));
+
+                frame->ip = ip;
+                CallStatus status;
+                if (IS_OBJ(receiver) && AS_OBJ(receiver)->type == OBJ_INSTANCE &&
+                    IS_OBJ(callee) && AS_OBJ(callee)->type == OBJ_CLOSURE) {
+                    status = call_closure((ObjClosure*)AS_OBJ(callee), arg_count);
+                } else {
+                    vm.stack_top[-1 - arg_count] = callee;
+                    status = call_value(callee, arg_count);
+                }
+                if (status != CALL_OK) THROW(call_error(status));
+                RELOAD_FRAME();
+                break;
+            }
+            case OP_CLOSURE: {
+                ObjFunc* function = (ObjFunc*)AS_OBJ(READ_CONSTANT());
+                ObjClosure* closure = new_closure(function);
+                push(OBJ_VAL(closure));
+                for (int i = 0; i < closure->upvalue_count; i++) {
+                    uint8_t is_local = READ_BYTE();
+                    uint8_t index = READ_BYTE();
+                    if (is_local) {
+                        closure->upvalues[i] = capture_upvalue(frame->slots + index);
+                    } else {
+                        closure->upvalues[i] = frame->closure->upvalues[index];
+                    }
+                    gc_write_barrier(&closure->obj, OBJ_VAL(closure->upvalues[i]));
+                }
+                break;
+            }
+            case OP_CLOSE_UPVALUE:
+                close_upvalues(vm.stack_top - 1);
+                vm.stack_top--;
+                break;
+            case OP_RETURN: {
+                Value result = pop();
+                close_upvalues(frame->slots);
+                vm.frame_count--;
+                vm.stack_top = frame->slots;
+                if (vm.frame_count == 0) return INTERPRET_OK;
+                push(result);
+                if (vm.frame_count == vm.exit_frame) return INTERPRET_OK;
+                RELOAD_FRAME();
+                break;
+            }
+
+            case OP_CLASS:
+                push(OBJ_VAL(new_class(READ_STRING()->chars)));
+                break;
+            case OP_METHOD: {
+                ObjString* name = READ_STRING();
+                ObjClass* klass = (ObjClass*)AS_OBJ(peek(1));
+                gc_write_barrier(&klass->obj, OBJ_VAL(name));
+                gc_write_barrier(&klass->obj, peek(0));
+                value_table_set(&klass->methods, name, peek(0));
+                vm.stack_top--;
+                break;
+            }
+            case OP_CONSTRUCTOR: {
+                ObjClass* klass = (ObjClass*)AS_OBJ(peek(1));
+                gc_write_barrier(&klass->obj, peek(0));
+                klass->constructor = AS_OBJ(peek(0));
+                vm.stack_top--;
+                break;
+            }
+            case OP_NEW: {
+                ObjString* name = READ_STRING();
+                int arg_count = READ_BYTE();
+                Value klassVal = peek(arg_count);
+                if (!IS_OBJ(klassVal) || AS_OBJ(klassVal)->type != OBJ_CLASS) {
+                    RAISE(ERR_TYPE, "「%s」はクラスじゃないヨ😅💦", name->chars);
+                }
+                ObjClass* klass = (ObjClass*)AS_OBJ(klassVal);
+                ObjInstance* instance = new_instance(klass);
+                vm.stack_top[-1 - arg_count] = OBJ_VAL(instance);
+                if (klass->constructor) {
+                    frame->ip = ip;
+                    CallStatus status = call_closure((ObjClosure*)klass->constructor, arg_count);
+                    if (status != CALL_OK) THROW(call_error(status));
+                    RELOAD_FRAME();
+                } else {
+                    vm.stack_top -= arg_count;
+                }
+                break;
+            }
+
+            case OP_LIST_NEW:
+                push(OBJ_VAL(new_list()));
+                break;
+            case OP_LIST_APPEND:
+                list_append((ObjList*)AS_OBJ(peek(1)), peek(0));
+                vm.stack_top--;
+                break;
+            case OP_DICT_NEW:
+                push(OBJ_VAL(new_dict()));
+                break;
+            case OP_DICT_ADD: {
+                Value key = peek(1);
+                if (!IS_OBJ(key) || AS_OBJ(key)->type != OBJ_STRING) {
+                    RAISE(ERR_TYPE, "辞書のキーは文字列じゃないとダメだヨ😅💦");
+                }
+                ObjDict* dict = (ObjDict*)AS_OBJ(peek(2));
+                value_table_set(&dict->items, (ObjString*)AS_OBJ(key), peek(0));
+                gc_dict_write_barrier(dict, (ObjString*)AS_OBJ(key), peek(0));
+                vm.stack_top -= 2;
+                break;
+            }
+            case OP_APPEND: {
+                ObjString* name = READ_STRING();
+                Value target = peek(1);
+                if (!IS_OBJ(target) || AS_OBJ(target)->type != OBJ_LIST) {
+                    RAISE(ERR_TYPE, "「%s」は配列じゃないヨ😅💦", name->chars);
+                }
+                list_append((ObjList*)AS_OBJ(target), peek(0));
+                vm.stack_top -= 2;
+                break;
+            }
+
+            case OP_RANGE_INIT: {
+                Value end = peek(0);
+                Value start = peek(1);
+                if (!IS_INT(start) || !IS_INT(end)) {
+                    RAISE(ERR_TYPE, "ループ範囲は整数じゃないとダメだヨ😅💦");
+                }
+                push(INT_VAL(AS_INT(start) <= AS_INT(end) ? 1 : -1));
+                break;
+            }
+            case OP_RANGE_NEXT: {
+                Value* base = frame->slots + READ_BYTE();
+                uint16_t offset = READ_SHORT();
+                long long cur = AS_INT(base[0]);
+                long long limit = AS_INT(base[1]);
+                long long step = AS_INT(base[2]);
+                if ((step > 0 && cur <= limit) || (step < 0 && cur >= limit)) {
+                    base[3] = INT_VAL(cur);
+                } else {
+                    ip += offset;
+                }
+                break;
+            }
+            case OP_RANGE_STEP: {
+                Value* base = frame->slots + READ_BYTE();
+                base[0] = INT_VAL(AS_INT(base[0]) + AS_INT(base[2]));
+                break;
+            }
+            case OP_ITER_INIT: {
+                Value collection = peek(0);
+                if (IS_OBJ(collection) && (AS_OBJ(collection)->type == OBJ_LIST ||
+                                           AS_OBJ(collection)->type == OBJ_TYPED_ARRAY)) {
+                    push(INT_VAL(0));
+                    push(INT_VAL(0));
+                    push(INT_VAL(0));
+                    break;
+                }
+                if (IS_OBJ(collection) && AS_OBJ(collection)->type == OBJ_DICT) {
+                    ObjDict* dict = (ObjDict*)AS_OBJ(collection);
+                    push(INT_VAL(0));
+                    push(INT_VAL(dict_iter_state(dict, DICT_VIEW_NONE)));
+                    push(INT_VAL(dict->items.used));
+                    break;
+                }
+                RAISE(ERR_TYPE, "配列か辞書じゃないとfor-eachできないヨ😅💦");
+            }
+            case OP_ITER_VIEW: {
+                uint16_t offset = READ_SHORT();
+                DictView view = builtin_dict_view(peek(1));
+                Value collection = peek(0);
+                if (view != DICT_VIEW_NONE && IS_OBJ(collection) && AS_OBJ(collection)->type == OBJ_DICT) {
+                    ObjDict* dict = (ObjDict*)AS_OBJ(collection);
+                    vm.stack_top[-2] = collection;
+                    vm.stack_top[-1] = INT_VAL(0);
+                    push(INT_VAL(dict_iter_state(dict, view)));
+                    push(INT_VAL(dict->items.used));
+                    ip += offset;
+                }
+                break;
+            }
+            case OP_ITER_NEXT: {
+                Value* base = frame->slots + READ_BYTE();
+                uint16_t offset = READ_SHORT();
+                Obj* seq = AS_OBJ(base[0]);
+                int idx = (int)AS_INT(base[1]);
+                if (seq->type == OBJ_DICT) {
+                    ObjDict* dict = (ObjDict*)seq;
+                    long long state = AS_INT(base[2]);
+                    DictView view = (DictView)(state & 3);
+                    if ((unsigned int)(state >> 2) == dict->items.version) {
+                        ObjString* key;
+                        Value value;
+                        if (value_table_next(&dict->items, &idx, &key, &value)) {
+                            base[4] = view == DICT_VIEW_VALUES ? value : OBJ_VAL(key);
+                            base[1] = INT_VAL(idx);
+                        } else {
+                            ip += offset;
+                        }
+                        break;
+                    }
+                    if (view == DICT_VIEW_NONE) {
+                        RAISE(ERR_RUNTIME, "for-eachで回してる辞書のキーを途中で増やしたり消したりしちゃダメだヨ😅💦");
+                    }
+                    ObjList* rest = dict_view_snapshot(dict, view, idx, (int)AS_INT(base[3]));
+                    base[0] = OBJ_VAL(rest);
+                    seq = (Obj*)rest;
+                    idx = 0;
+                }
+                if (seq->type == OBJ_LIST) {
+                    ObjList* list = (ObjList*)seq;
+                    if (idx < list->count) {
+                        base[4] = list->items[idx];
+                        base[1] = INT_VAL(idx + 1);
+                    } else {
+                        ip += offset;
+                    }
+                    break;
+                }
+                ObjTypedArray* array = (ObjTypedArray*)seq;
+                if (idx < array->count) {
+                    base[4] = typed_array_get(array, idx);
+                    base[1] = INT_VAL(idx + 1);
+                } else {
+                    ip += offset;
+                }
+                break;
+            }
+
+            case OP_TRY: {
+                uint16_t offset = READ_SHORT();
+                if (vm.handler_count + 1 > vm.handler_capacity) {
+                    vm.handler_capacity = vm.handler_capacity < 8 ? 8 : vm.handler_capacity * 2;
+                    vm.handlers = realloc(vm.handlers, sizeof(TryHandler) * vm.handler_capacity);
+                }
+                TryHandler* handler = &vm.handlers[vm.handler_count++];
+                handler->frame_count = vm.frame_count;
+                handler->stack_top = vm.stack_top;
+                handler->catch_ip = ip + offset;
+                break;
+            }
+            case OP_TRY_END:
+                vm.handler_count--;
+                break;
+
+            case OP_IMPORT: {
+                ObjString* path = READ_STRING();
+                const char* dot = strrchr(path->chars, '.');
+                if (!dot || (strcmp(dot, ".ojs") != 0 && strcmp(dot, ".oji") != 0)) {
+                    RAISE(ERR_RUNTIME, "インポートは「.ojs」か「.oji」ファイルだけダヨ😅💦: \"%s\"", path->chars);
+                }
+                Module* module = module_lookup(path->chars);
+                if (!module) RAISE(ERR_RUNTIME, "ファイルが開けないヨ😅💦: \"%s\"", path->chars);
+                if (!module_claim(module, MODULE_VM)) {
+                    push(NULL_VAL);
+                    break;
+                }
+                if (!module->function) {
+                    SourceFile source;
+                    if (!source_open(&source, module->path)) RAISE(ERR_RUNTIME, "ファイルが開けないヨ😅💦: \"%s\"", path->chars);
+                    module->function = compile_source(source.text);
+                    source_close(&source);
+                }
+
+                ObjFunc* function = module->function;
+                if (!function) {
+                    push(NULL_VAL);
+                    break;
+                }
+                push(OBJ_VAL(function));
+                ObjClosure* closure = new_closure(function);
+                vm.stack_top[-1] = OBJ_VAL(closure);
+                frame->ip = ip;
+                CallStatus status = call_closure(closure, 0);
+                if (status != CALL_OK) THROW(call_error(status));
+                RELOAD_FRAME();
+                break;
+            }
+
+            case OP_RAISE: {
+                ErrorType type = (ErrorType)READ_BYTE();
+                ObjString* message = READ_STRING();
+                RAISE(type, "%s", message->chars);
+            }
+            case OP_FAIL:
+                frame->ip = ip;
+                return INTERPRET_RUNTIME_ERROR;
+        }
+    }
+
+#undef READ_BYTE
+#undef READ_SHORT
+#undef READ_CONSTANT
+#undef READ_STRING
+#undef READ_CACHE
+#undef RELOAD_FRAME
+#undef THROW
+#undef RAISE
+#undef BINARY_SLOW
+#undef INT_COMPARE
+}
+
+static bool call_from_native(Value callee, int arg_count, Value* args, Value* out) {
+    Value* base = vm.stack_top;
+    int frame_count = vm.frame_count;
+    int exit_frame = vm.exit_frame;
+    int handler_floor = vm.handler_floor;
+    vm.exit_frame = frame_count;
+    vm.handler_floor = vm.handler_count;
+    vm.pending_error[0] = '\0';
+
+    push(callee);
+    for (int i = 0; i < arg_count; i++) push(args[i]);
+    CallStatus status = call_value(callee, arg_count);
+    bool ok = status == CALL_OK || call_error(status);
+    if (ok && vm.frame_count > frame_count) ok = run() == INTERPRET_OK;
+
+    if (ok) *out = vm.stack_top[-1];
+    close_upvalues(base);
+    vm.frame_count = frame_count;
+    vm.stack_top = base;
+    vm.handler_count = vm.handler_floor;
+    vm.exit_frame = exit_frame;
+    vm.handler_floor = handler_floor;
+    return ok;
+}
+
+void vm_init(void) {
+    reset_stack();
+    vm.open_upvalues = NULL;
+    module_begin_session(MODULE_VM);
+    vm.globals = env_new(NULL);
+    register_builtins(vm.globals);
+    builtins_set_call_hook(call_from_native);
+    gc_set_root(vm.globals);
+}
+
+void vm_free(void) {
+    gc_set_root(NULL);
+    reset_stack();
+    if (vm.globals) env_release(vm.globals);
+    vm.globals = NULL;
+    free(vm.handlers);
+    vm.handlers = NULL;
+    vm.handler_capacity = 0;
+}
+
+void vm_set_dump_bytecode(bool enabled) {
+    vm.dump_bytecode = enabled;
+}
+
+static InterpretResult run_function(ObjFunc* function) {
+    if (!function) return INTERPRET_COMPILE_ERROR;
+    if (vm.dump_bytecode) chunk_disassemble(function->chunk, "<script>");
+
+    push(OBJ_VAL(function));
+    ObjClosure* closure = new_closure(function);
+    vm.stack_top[-1] = OBJ_VAL(closure);
+    call_closure(closure, 0);
+
+    InterpretResult result = run();
+    if (result != INTERPRET_OK) reset_stack();
+    return result;
+}
+
+InterpretResult vm_run(AstNode* program) {
+    return run_function(compile_program(program));
+}
+
+void vm_interpret(const char* source) {
+    gc_init();
+    vm_init();
+    run_function(compile_source(source));
+    vm_free();
+    gc_collect(NULL);
+}
+
+void vm_mark_roots(void) {
+    if (vm.stack_top == NULL) return;
+    for (Value* slot = vm.stack; slot < vm.stack_top; slot++) {
+        gc_mark_value(*slot);
+    }
+    for (int i = 0; i < vm.frame_count; i++) {
+        gc_mark_obj((Obj*)vm.frames[i].closure);
+    }
+    for (ObjUpvalue* upvalue = vm.open_upvalues; upvalue != NULL; upvalue = upvalue->next) {
+        gc_mark_obj((Obj*)upvalue);
+    }
+}
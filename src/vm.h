@@ -0,0 +1,21 @@
+#ifndef OJISAN_VM_H
+#define OJISAN_VM_H
+
+#include "ast.h"
+#include "value.h"
+#include <stdbool.h>
+
+typedef enum {
+    INTERPRET_OK,
+    INTERPRET_COMPILE_ERROR,
+    INTERPRET_RUNTIME_ERROR
+} InterpretResult;
+
+void vm_init(void);
+void vm_free(void);
+void vm_set_dump_bytecode(bool enabled);
+InterpretResult vm_run(AstNode* program);
+void vm_interpret(const char* source);
+void vm_mark_roots(void);
+
+#endif 
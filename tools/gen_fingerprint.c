@@ -0,0 +1,25 @@
+#include <stdio.h>
+#include <stdint.h>
+
+int main(int argc, char* argv[]) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int i = 1; i < argc; i++) {
+        FILE* file = fopen(argv[i], "rb");
+        if (file == NULL) {
+            fprintf(stderr, "gen_fingerprint: cannot open %s\n", argv[i]);
+            return 1;
+        }
+        int c;
+        while ((c = fgetc(file)) != EOF) {
+            hash ^= (unsigned char)c;
+            hash *= 1099511628211ULL;
+        }
+        fclose(file);
+        hash ^= 0xff;
+        hash *= 1099511628211ULL;
+    }
+
+    printf("/* generated by tools/gen_fingerprint.c from the compiler sources */\n\n");
+    printf("#define CODEGEN_FINGERPRINT 0x%016llxULL\n", (unsigned long long)hash);
+    return 0;
+}
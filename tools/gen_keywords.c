@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char* pattern;
+    const char* type;
+} KeywordEntry;
+
+static const KeywordEntry keywords[] = {
+#define KEYWORD(pattern, type) {pattern, #type},
+#include "keywords.def"
+#undef KEYWORD
+    {NULL, NULL}
+};
+
+#define MAX_STATES 4096
+
+typedef struct {
+    int next[256];
+    const char* accept;
+} TrieState;
+
+static TrieState states[MAX_STATES];
+static int state_count = 1;
+
+static void insert(const KeywordEntry* entry) {
+    int state = 0;
+    for (const unsigned char* p = (const unsigned char*)entry->pattern; *p; p++) {
+        if (states[state].next[*p] == 0) {
+            if (state_count >= MAX_STATES) {
+                fprintf(stderr, "gen_keywords: too many states\n");
+                exit(1);
+            }
+            states[state].next[*p] = state_count++;
+        }
+        state = states[state].next[*p];
+    }
+    if (states[state].accept != NULL) {
+        fprintf(stderr, "gen_keywords: duplicate keyword \"%s\"\n", entry->pattern);
+        exit(1);
+    }
+    states[state].accept = entry->type;
+}
+
+int main(void) {
+    for (int i = 0; keywords[i].pattern != NULL; i++) insert(&keywords[i]);
+
+    printf("/* generated by tools/gen_keywords.c from src/keywords.def */\n\n");
+    printf("typedef struct {\n");
+    printf("    unsigned short first_edge;\n");
+    printf("    unsigned char edge_count;\n");
+    printf("    TokenType accept;\n");
+    printf("} KeywordState;\n\n");
+
+    printf("static const unsigned short keyword_root[256] = {");
+    for (int c = 0; c < 256; c++) {
+        printf("%s%d%s", c % 16 == 0 ? "\n    " : "", states[0].next[c], c < 255 ? ", " : "");
+    }
+    printf("\n};\n\n");
+
+    int edge_count = 0;
+    printf("static const KeywordState keyword_states[%d] = {\n", state_count);
+    for (int s = 0; s < state_count; s++) {
+        int count = 0;
+        for (int c = 0; c < 256; c++) {
+            if (states[s].next[c] != 0) count++;
+        }
+        if (s == 0) count = 0;
+        printf("    {%d, %d, %s},\n", edge_count, count, states[s].accept ? states[s].accept : "TOK_ERROR");
+        edge_count += count;
+    }
+    printf("};\n\n");
+
+    printf("static const unsigned char keyword_edge_bytes[%d] = {", edge_count);
+    int e = 0;
+    for (int s = 1; s < state_count; s++) {
+        for (int c = 0; c < 256; c++) {
+            if (states[s].next[c] == 0) continue;
+            printf("%s%d,", e++ % 16 == 0 ? "\n    " : " ", c);
+        }
+    }
+    printf("\n};\n\n");
+
+    printf("static const unsigned short keyword_edge_targets[%d] = {", edge_count);
+    e = 0;
+    for (int s = 1; s < state_count; s++) {
+        for (int c = 0; c < 256; c++) {
+            if (states[s].next[c] == 0) continue;
+            printf("%s%d,", e++ % 16 == 0 ? "\n    " : " ", states[s].next[c]);
+        }
+    }
+    printf("\n};\n");
+    return 0;
+}